@@ -539,7 +539,9 @@ bool read_from_file( const std::string &path, const std::function<void( std::ist
 bool read_from_file_json( const std::string &path, const std::function<void( JsonIn & )> &reader )
 {
     return read_from_file( path, [&]( std::istream & fin ) {
-        JsonIn jsin( fin, path );
+        const std::string data( ( std::istreambuf_iterator<char>( fin ) ),
+                                std::istreambuf_iterator<char>() );
+        JsonIn jsin( data, path );
         reader( jsin );
     } );
 }
@@ -564,7 +566,9 @@ bool read_from_file_optional_json( const std::string &path,
                                    const std::function<void( JsonIn & )> &reader )
 {
     return read_from_file_optional( path, [&]( std::istream & fin ) {
-        JsonIn jsin( fin, path );
+        const std::string data( ( std::istreambuf_iterator<char>( fin ) ),
+                                std::istreambuf_iterator<char>() );
+        JsonIn jsin( data, path );
         reader( jsin );
     } );
 }
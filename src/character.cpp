@@ -7886,6 +7886,10 @@ void Character::rebuild_mutation_cache()
     for( const trait_id &mut : enchantment_cache->get_mutations() ) {
         cached_mutations.push_back( &mut.obj() );
     }
+    cached_mutation_flags.clear();
+    for( const mutation_branch *mut : cached_mutations ) {
+        cached_mutation_flags |= mut->flag_bits;
+    }
 }
 
 double Character::bonus_from_enchantments( double base, enchant_vals::mod value,
@@ -31,6 +31,7 @@
 #include "damage.h"
 #include "enums.h"
 #include "enum_int_operators.h"
+#include "flag_bitset.h"
 #include "flat_set.h"
 #include "game_constants.h"
 #include "inventory.h"
@@ -2162,6 +2163,8 @@ class Character : public Creature, public visitable<Character>
          * Pointers to mutation branches in @ref my_mutations.
          */
         std::vector<const mutation_branch *> cached_mutations;
+        /** Flags of @ref cached_mutations, see @ref mutation_branch::flag_index */
+        flag_bitset cached_mutation_flags;
 
         void store( JsonOut &json ) const;
         void load( const JsonObject &data );
@@ -2270,6 +2273,13 @@ class Character : public Creature, public visitable<Character>
         int cached_moves = 0;
         tripoint cached_position;
         inventory cached_crafting_inventory;
+        // Part of the crafting inventory formed from the map, kept while the map reports no changes
+        inventory cached_nearby_inventory;
+        tripoint cached_nearby_position = tripoint_min;
+        int cached_nearby_radius = 0;
+        bool cached_nearby_clear_path = false;
+        int cached_nearby_revision = 0;
+        time_point cached_nearby_time = calendar::before_time_starts;
 
         mutable std::array<double, npc_ai_info::num_npc_ai_info> npc_ai_info_cache;
 
@@ -570,7 +570,21 @@ const inventory &Character::crafting_inventory( const tripoint &src_pos, int rad
         && cached_position == inv_pos ) {
         return cached_crafting_inventory;
     }
-    cached_crafting_inventory.form_from_map( inv_pos, radius, this, false, clear_path );
+    // Copies of items stop following rot and temperature, so they are not kept for too long
+    if( cached_nearby_position != inv_pos || cached_nearby_radius != radius ||
+        cached_nearby_clear_path != clear_path ||
+        cached_nearby_revision != map::inventory_revision() ||
+        calendar::turn - cached_nearby_time > 30_minutes ) {
+        cached_nearby_inventory.form_from_map( inv_pos, radius, this, false, clear_path );
+        cached_nearby_position = inv_pos;
+        cached_nearby_radius = radius;
+        cached_nearby_clear_path = clear_path;
+        cached_nearby_revision = map::inventory_revision();
+        cached_nearby_time = calendar::turn;
+    }
+    cached_crafting_inventory = cached_nearby_inventory;
+    // The copied lookup caches still point into the nearby inventory
+    cached_crafting_inventory.unsort();
     cached_crafting_inventory += inv;
     cached_crafting_inventory += weapon;
     cached_crafting_inventory += worn;
@@ -599,6 +613,7 @@ void Character::invalidate_crafting_inventory()
 {
     cached_time = calendar::before_time_starts;
     cached_position = tripoint_min;
+    cached_nearby_position = tripoint_min;
 }
 
 void player::make_craft( const recipe_id &id_to_make, int batch_size, const tripoint &loc )
@@ -31,6 +31,7 @@
 #include "output.h"
 #include "point.h"
 #include "recipe.h"
+#include "recipe_availability.h"
 #include "recipe_dictionary.h"
 #include "requirements.h"
 #include "string_formatter.h"
@@ -244,20 +245,12 @@ const recipe *select_crafting_recipe( int &batch_size )
     std::vector<const recipe *> current;
 
     struct availability {
-        availability( const recipe *r, int batch_size, bool known ) {
+        availability( const recipe_availability &avail, bool known ) {
             this->known = known;
-            const inventory &inv = get_avatar().crafting_inventory();
-            auto all_items_filter = r->get_component_filter( recipe_filter_flags::none );
-            auto no_rotten_filter = r->get_component_filter( recipe_filter_flags::no_rotten );
-            const deduped_requirement_data &req = r->deduped_requirements();
-            could_craft_if_knew = req.can_make_with_inventory(
-                                      inv, all_items_filter, batch_size, cost_adjustment::start_only );
+            could_craft_if_knew = avail.could_craft_if_knew;
             can_craft = known && could_craft_if_knew;
-            can_craft_non_rotten = req.can_make_with_inventory(
-                                       inv, no_rotten_filter, batch_size, cost_adjustment::start_only );
-            const requirement_data &simple_req = r->simple_requirements();
-            apparently_craftable = simple_req.can_make_with_inventory(
-                                       inv, all_items_filter, batch_size, cost_adjustment::start_only );
+            can_craft_non_rotten = avail.can_craft_non_rotten;
+            apparently_craftable = avail.apparently_craftable;
         }
         bool can_craft;
         bool can_craft_non_rotten;
@@ -322,6 +315,7 @@ const recipe *select_crafting_recipe( int &batch_size )
 
     const auto &available_recipes = u.get_available_recipes( crafting_inv, &helpers );
     std::unordered_map<const recipe *, availability> availability_cache( available_recipes.size() );
+    recipe_availability_checker availability_checker( crafting_inv );
 
     std::vector<const recipe *> all_recipes_flat;
     for( const auto &pr : recipe_dict ) {
@@ -428,9 +422,12 @@ const recipe *select_crafting_recipe( int &batch_size )
             }
 
             std::vector<std::string> component_print_buffer;
+            const auto filter = current[line]->get_component_filter();
+            // Marks which requirements are met, the lists below are colored by it
+            req.can_make_with_inventory( crafting_inv, filter, count, cost_adjustment::start_only );
             auto tools = req.get_folded_tools_list( pane, col, crafting_inv, count );
-            auto comps = req.get_folded_components_list( pane, col, crafting_inv,
-                         current[line]->get_component_filter(), count, qry_comps );
+            auto comps = req.get_folded_components_list( pane, col, crafting_inv, filter, count,
+                         qry_comps );
             component_print_buffer.insert( component_print_buffer.end(), tools.begin(), tools.end() );
             component_print_buffer.insert( component_print_buffer.end(), comps.begin(), comps.end() );
 
@@ -627,10 +624,10 @@ const recipe *select_crafting_recipe( int &batch_size )
 
             if( batch ) {
                 current.clear();
+                const bool known = !show_unavailable || available_recipes.contains( *chosen );
                 for( int i = 1; i <= 50; i++ ) {
                     current.push_back( chosen );
-                    available.push_back( availability( chosen, i,
-                                                       !show_unavailable || available_recipes.contains( *chosen ) ) );
+                    available.push_back( availability( availability_checker.check( *chosen, i ), known ) );
                 }
             } else {
                 std::vector<const recipe *> picking;
@@ -727,13 +724,19 @@ const recipe *select_crafting_recipe( int &batch_size )
                 }
 
                 available.reserve( current.size() );
-                // cache recipe availability on first display
+                // cache recipe availability on first display, checking all new recipes at once
+                std::vector<const recipe *> unchecked;
                 for( const recipe *e : current ) {
                     if( availability_cache.count( e ) == 0 ) {
-                        availability_cache.emplace( e, availability( e, 1,
-                                                    !show_unavailable || available_recipes.contains( *e ) ) );
+                        unchecked.push_back( e );
                     }
                 }
+                const std::vector<recipe_availability> checked = availability_checker.check( unchecked );
+                for( size_t i = 0; i < unchecked.size(); i++ ) {
+                    const recipe *e = unchecked[i];
+                    availability_cache.emplace( e, availability( checked[i],
+                                                !show_unavailable || available_recipes.contains( *e ) ) );
+                }
 
                 if( subtab.cur() != "CSC_*_RECENT" ) {
                     std::stable_sort( current.begin(), current.end(),
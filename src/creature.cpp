@@ -312,13 +312,18 @@ bool Creature::sees( const tripoint &t, bool is_avatar, int range_mod ) const
             return adj_range >= wanted_range &&
                    here.get_cache_ref( pos().z ).seen_cache[pos().x][pos().y] > LIGHT_TRANSPARENCY_SOLID;
         } else {
-            return here.sees( pos(), t, range );
+            return sees_through_map( t, range );
         }
     } else {
         return false;
     }
 }
 
+bool Creature::sees_through_map( const tripoint &t, int range ) const
+{
+    return get_map().sees( pos(), t, range );
+}
+
 // Helper function to check if potential area of effect of a weapon overlaps vehicle
 // Maybe TODO: If this is too slow, precalculate a bounding box and clip the tested area to it
 static bool overlaps_vehicle( const std::set<tripoint> &veh_area, const tripoint &pos,
@@ -1103,6 +1108,7 @@ void Creature::add_effect( const efftype_id &eff_id, const time_duration &dur,
             e.set_intensity( e.get_max_intensity() );
         }
         ( *effects )[eff_id][bp] = e;
+        effect_filter |= effect_filter_bit( eff_id );
         if( Character *ch = as_character() ) {
             g->events().send<event_type::character_gains_effect>( ch->getID(), eff_id );
             if( is_player() && !type.get_apply_message().empty() ) {
@@ -1190,6 +1196,9 @@ bool Creature::has_effect( const efftype_id &eff_id, body_part bp ) const
 }
 bool Creature::has_effect( const efftype_id &eff_id, const bodypart_str_id &bp ) const
 {
+    if( !may_have_effect( eff_id ) ) {
+        return false;
+    }
     // num_bp means anything targeted or not
     if( !bp ) {
         auto got = effects->find( eff_id );
@@ -1226,6 +1235,9 @@ effect &Creature::get_effect( const efftype_id &eff_id, body_part bp )
 
 const effect &Creature::get_effect( const efftype_id &eff_id, body_part bp ) const
 {
+    if( !may_have_effect( eff_id ) ) {
+        return effect::null_effect;
+    }
     auto got_outer = effects->find( eff_id );
     if( got_outer != effects->end() ) {
         auto got_inner = got_outer->second.find( convert_bp( bp ) );
@@ -1238,6 +1250,9 @@ const effect &Creature::get_effect( const efftype_id &eff_id, body_part bp ) con
 std::vector<effect *> Creature::get_all_effects_of_type( const efftype_id &eff_id )
 {
     std::vector< effect *> ret;
+    if( !may_have_effect( eff_id ) ) {
+        return ret;
+    }
     auto got_outer = effects->find( eff_id );
     if( got_outer == effects->end() ) {
         return {};
@@ -1251,6 +1266,9 @@ std::vector<effect *> Creature::get_all_effects_of_type( const efftype_id &eff_i
 std::vector<const effect *> Creature::get_all_effects_of_type( const efftype_id &eff_id ) const
 {
     std::vector<const effect *> ret;
+    if( !may_have_effect( eff_id ) ) {
+        return ret;
+    }
     auto got_outer = effects->find( eff_id );
     if( got_outer != effects->end() ) {
         for( const auto &pr : got_outer->second ) {
@@ -1326,6 +1344,23 @@ void Creature::process_effects()
             }
         }
     }
+    if( !to_remove.empty() ) {
+        rebuild_effect_filter();
+    }
+}
+
+std::uint64_t Creature::effect_filter_bit( const efftype_id &eff_id )
+{
+    // Effect ids are interned, so their hashes are small consecutive numbers
+    return std::uint64_t( 1 ) << ( std::hash<efftype_id>()( eff_id ) % 64 );
+}
+
+void Creature::rebuild_effect_filter()
+{
+    effect_filter = 0;
+    for( const auto &elem : *effects ) {
+        effect_filter |= effect_filter_bit( elem.first );
+    }
 }
 
 bool Creature::resists_effect( const effect &e ) const
@@ -3,6 +3,7 @@
 #define CATA_SRC_CREATURE_H
 
 #include <climits>
+#include <cstdint>
 #include <map>
 #include <set>
 #include <unordered_map>
@@ -818,6 +819,18 @@ class Creature
         virtual void process_one_effect( effect &e, bool is_new ) = 0;
 
         pimpl<effects_map> effects;
+        /**
+         * One bit for each group of effect types that has an entry in @ref effects, see
+         * @ref effect_filter_bit. Most creatures have few effects, so a clear bit answers
+         * most effect checks without looking into the map.
+         * Bits are set when effects are added and cleared when entries are erased.
+         */
+        std::uint64_t effect_filter = 0;
+        static std::uint64_t effect_filter_bit( const efftype_id &eff_id );
+        bool may_have_effect( const efftype_id &eff_id ) const {
+            return ( effect_filter & effect_filter_bit( eff_id ) ) != 0;
+        }
+        void rebuild_effect_filter();
         // Miscellaneous key/value pairs.
         std::unordered_map<std::string, std::string> values;
 
@@ -851,6 +864,11 @@ class Creature
         virtual void on_stat_change( const std::string &, int ) {}
         virtual void on_effect_int_change( const efftype_id &, int, const bodypart_str_id & ) {}
         virtual void on_damage_of_type( int, damage_type, const bodypart_id & ) {}
+        /**
+         * Whether nothing on the map blocks the view to @p t within @p range, used by
+         * @ref sees once light and distance allow seeing @p t. See @ref map::sees.
+         */
+        virtual bool sees_through_map( const tripoint &t, int range ) const;
 
     public:
         body_part select_body_part( Creature *source, int hit_roll ) const;
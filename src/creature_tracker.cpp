@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "debug.h"
+#include "line.h"
 #include "mongroup.h"
 #include "monster.h"
 #include "mtype.h"
@@ -16,7 +17,33 @@
 
 #define dbg(x) DebugLogFL((x),DC::Game)
 
-Creature_tracker::Creature_tracker() = default;
+// Cells are one submap in size and cover two submaps of margin around the reality bubble,
+// which is beyond where monsters get despawned
+static constexpr int cell_margin = 2;
+static constexpr int cells_per_side = MAPSIZE + 2 * cell_margin;
+
+static point cell_of( const point &p )
+{
+    return divide_xy_round_to_minus_infinity( p, SEEX ) + point( cell_margin, cell_margin );
+}
+
+static bool cell_inbounds( const point &cell, int z )
+{
+    return cell.x >= 0 && cell.x < cells_per_side && cell.y >= 0 && cell.y < cells_per_side &&
+           z >= -OVERMAP_DEPTH && z <= OVERMAP_HEIGHT;
+}
+
+static size_t cell_index( const point &cell, int z )
+{
+    return ( static_cast<size_t>( z + OVERMAP_DEPTH ) * cells_per_side + cell.y ) * cells_per_side +
+           cell.x;
+}
+
+Creature_tracker::Creature_tracker()
+    : monsters_by_cell( static_cast<size_t>( cells_per_side ) * cells_per_side * OVERMAP_LAYERS )
+{
+    monsters_on_level.fill( 0 );
+}
 
 Creature_tracker::~Creature_tracker() = default;
 
@@ -86,7 +113,7 @@ bool Creature_tracker::add( shared_ptr_fast<monster> critter_ptr )
     }
 
     monsters_list.emplace_back( critter_ptr );
-    monsters_by_location[critter.pos()] = critter_ptr;
+    set_location( critter.pos(), critter_ptr );
     add_to_faction_map( critter_ptr );
     return true;
 }
@@ -136,8 +163,11 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
         return ptr.get() == &critter;
     } );
     if( iter != monsters_list.end() ) {
-        monsters_by_location.erase( critter.pos() );
-        monsters_by_location[new_pos] = *iter;
+        const auto old_iter = monsters_by_location.find( critter.pos() );
+        if( old_iter != monsters_by_location.end() ) {
+            erase_location( old_iter );
+        }
+        set_location( new_pos, *iter );
         return true;
     } else {
         const tripoint &old_pos = critter.pos();
@@ -156,7 +186,7 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
 {
     const auto pos_iter = monsters_by_location.find( critter.pos() );
     if( pos_iter != monsters_by_location.end() && pos_iter->second.get() == &critter ) {
-        monsters_by_location.erase( pos_iter );
+        erase_location( pos_iter );
         return;
     }
 
@@ -167,7 +197,7 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
         return v.second.get() == &critter;
     } );
     if( iter != monsters_by_location.end() ) {
-        monsters_by_location.erase( iter );
+        erase_location( iter );
     }
 }
 
@@ -199,17 +229,17 @@ void Creature_tracker::remove( const monster &critter )
 void Creature_tracker::clear()
 {
     monsters_list.clear();
-    monsters_by_location.clear();
+    clear_locations();
     monster_faction_map_.clear();
     removed_.clear();
 }
 
 void Creature_tracker::rebuild_cache()
 {
-    monsters_by_location.clear();
+    clear_locations();
     monster_faction_map_.clear();
     for( const shared_ptr_fast<monster> &mon_ptr : monsters_list ) {
-        monsters_by_location[mon_ptr->pos()] = mon_ptr;
+        set_location( mon_ptr->pos(), mon_ptr );
         add_to_faction_map( mon_ptr );
     }
 }
@@ -228,13 +258,13 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
     shared_ptr_fast<monster> first_ptr;
     if( first_iter != monsters_by_location.end() ) {
         first_ptr = first_iter->second;
-        monsters_by_location.erase( first_iter );
+        erase_location( first_iter );
     }
 
     shared_ptr_fast<monster> second_ptr;
     if( second_iter != monsters_by_location.end() ) {
         second_ptr = second_iter->second;
-        monsters_by_location.erase( second_iter );
+        erase_location( second_iter );
     }
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
 
@@ -244,10 +274,10 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
 
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
-        monsters_by_location[first.pos()] = first_ptr;
+        set_location( first.pos(), first_ptr );
     }
     if( second_ptr ) {
-        monsters_by_location[second.pos()] = second_ptr;
+        set_location( second.pos(), second_ptr );
     }
 }
 
@@ -290,3 +320,104 @@ void Creature_tracker::remove_dead()
 
     removed_.clear();
 }
+
+std::vector<Creature_tracker::cell_entry> &Creature_tracker::cell_at( const tripoint &pos )
+{
+    const point cell = cell_of( pos.xy() );
+    if( !cell_inbounds( cell, pos.z ) ) {
+        return monsters_outside_cells;
+    }
+    return monsters_by_cell[cell_index( cell, pos.z )];
+}
+
+void Creature_tracker::set_location( const tripoint &pos, const shared_ptr_fast<monster> &critter )
+{
+    const auto iter = monsters_by_location.find( pos );
+    if( iter != monsters_by_location.end() ) {
+        // Replacing a dead monster or hallucination
+        erase_location( iter );
+    }
+    monsters_by_location[pos] = critter;
+    cell_at( pos ).emplace_back( pos, critter.get() );
+    if( cell_inbounds( cell_of( pos.xy() ), pos.z ) ) {
+        monsters_on_level[pos.z + OVERMAP_DEPTH]++;
+    }
+}
+
+void Creature_tracker::erase_location(
+    std::unordered_map<tripoint, shared_ptr_fast<monster>>::iterator iter )
+{
+    const tripoint pos = iter->first;
+    const monster *critter = iter->second.get();
+    monsters_by_location.erase( iter );
+
+    std::vector<cell_entry> &cell = cell_at( pos );
+    const auto cell_iter = std::find_if( cell.begin(), cell.end(), [critter]( const cell_entry & e ) {
+        return e.second == critter;
+    } );
+    if( cell_iter == cell.end() ) {
+        return;
+    }
+    // Keep the order of the remaining entries, it determines the order of query results
+    cell.erase( cell_iter );
+    if( cell_inbounds( cell_of( pos.xy() ), pos.z ) ) {
+        monsters_on_level[pos.z + OVERMAP_DEPTH]--;
+    }
+}
+
+void Creature_tracker::clear_locations()
+{
+    monsters_by_location.clear();
+    for( std::vector<cell_entry> &cell : monsters_by_cell ) {
+        cell.clear();
+    }
+    monsters_outside_cells.clear();
+    monsters_on_level.fill( 0 );
+}
+
+std::vector<monster *> Creature_tracker::find_in_radius( const tripoint &center, int radius ) const
+{
+    std::vector<monster *> result;
+    if( radius < 0 ) {
+        return result;
+    }
+    const auto add_from = [&]( const std::vector<cell_entry> &cell ) {
+        for( const cell_entry &entry : cell ) {
+            if( square_dist( center, entry.first ) <= radius && !entry.second->is_dead() ) {
+                result.push_back( entry.second );
+            }
+        }
+    };
+
+    const point min_cell = cell_of( center.xy() - point( radius, radius ) );
+    const point max_cell = cell_of( center.xy() + point( radius, radius ) );
+    const int min_x = std::max( min_cell.x, 0 );
+    const int max_x = std::min( max_cell.x, cells_per_side - 1 );
+    const int min_y = std::max( min_cell.y, 0 );
+    const int max_y = std::min( max_cell.y, cells_per_side - 1 );
+    const int min_z = std::max( center.z - radius, -OVERMAP_DEPTH );
+    const int max_z = std::min( center.z + radius, OVERMAP_HEIGHT );
+    for( int z = min_z; z <= max_z; z++ ) {
+        if( monsters_on_level[z + OVERMAP_DEPTH] == 0 ) {
+            continue;
+        }
+        for( int y = min_y; y <= max_y; y++ ) {
+            for( int x = min_x; x <= max_x; x++ ) {
+                add_from( monsters_by_cell[cell_index( point( x, y ), z )] );
+            }
+        }
+    }
+    add_from( monsters_outside_cells );
+    return result;
+}
+
+std::vector<monster *> Creature_tracker::find_in_radius( const tripoint &center, int radius,
+        const mfaction_id &faction ) const
+{
+    const mfaction_id playerfaction = mfaction_str_id( "player" ).id();
+    std::vector<monster *> result = find_in_radius( center, radius );
+    result.erase( std::remove_if( result.begin(), result.end(), [&]( const monster * critter ) {
+        return ( critter->friendly == 0 ? critter->faction : playerfaction ) != faction;
+    } ), result.end() );
+    return result;
+}
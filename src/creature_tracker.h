@@ -2,12 +2,15 @@
 #ifndef CATA_SRC_CREATURE_TRACKER_H
 #define CATA_SRC_CREATURE_TRACKER_H
 
+#include <array>
 #include <cstddef>
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "game_constants.h"
 #include "memory_fast.h"
 #include "point.h"
 #include "type_id.h"
@@ -79,6 +82,15 @@ class Creature_tracker
         bool kill_marked_for_death();
         /** Removes dead monsters from. Their pointers are invalidated. */
         void remove_dead();
+        /**
+         * Returns the living monsters whose @ref square_dist to @p center is at most @p radius,
+         * including those on other z-levels. The order only depends on where the monsters are
+         * and the order they got there, not on their addresses.
+         */
+        std::vector<monster *> find_in_radius( const tripoint &center, int radius ) const;
+        /** Same as above, but only monsters of @p faction, grouped the same way as @ref factions. */
+        std::vector<monster *> find_in_radius( const tripoint &center, int radius,
+                                               const mfaction_id &faction ) const;
 
         const std::vector<shared_ptr_fast<monster>> &get_monsters_list() const {
             return monsters_list;
@@ -96,6 +108,23 @@ class Creature_tracker
         std::unordered_map<tripoint, shared_ptr_fast<monster>> monsters_by_location;
         /** Remove the monsters entry in @ref monsters_by_location */
         void remove_from_location_map( const monster &critter );
+
+        using cell_entry = std::pair<tripoint, monster *>;
+        /**
+         * The entries of @ref monsters_by_location bucketed into submap sized cells covering
+         * the reality bubble and a margin around it, one layer per z-level.
+         * Monsters that are even further out are kept in @ref monsters_outside_cells.
+         */
+        std::vector<std::vector<cell_entry>> monsters_by_cell;
+        std::vector<cell_entry> monsters_outside_cells;
+        /** Number of entries in @ref monsters_by_cell on each z-level */
+        std::array<int, OVERMAP_LAYERS> monsters_on_level;
+        std::vector<cell_entry> &cell_at( const tripoint &pos );
+        /** Sets the entry in @ref monsters_by_location and the cells at @p pos. */
+        void set_location( const tripoint &pos, const shared_ptr_fast<monster> &critter );
+        /** Erases the entry in @ref monsters_by_location and the cells. */
+        void erase_location( std::unordered_map<tripoint, shared_ptr_fast<monster>>::iterator iter );
+        void clear_locations();
 };
 
 #endif // CATA_SRC_CREATURE_TRACKER_H
@@ -0,0 +1,214 @@
+#include "data_snapshot.h"
+
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+
+#include "filesystem.h"
+#include "fstream_utils.h"
+#include "get_version.h"
+
+namespace
+{
+
+constexpr char snapshot_magic[4] = { 'C', 'D', 'S', 'N' };
+
+// 64 bit FNV-1a
+class fingerprint_hasher
+{
+    public:
+        void add( const std::string &str ) {
+            add( static_cast<uint64_t>( str.size() ) );
+            for( char c : str ) {
+                add_byte( static_cast<unsigned char>( c ) );
+            }
+        }
+        void add( uint64_t value ) {
+            for( int i = 0; i < 8; i++ ) {
+                add_byte( static_cast<unsigned char>( ( value >> ( 8 * i ) ) & 0xff ) );
+            }
+        }
+        uint64_t get() const {
+            return hash;
+        }
+
+    private:
+        void add_byte( unsigned char byte ) {
+            hash ^= byte;
+            hash *= 0x100000001b3ULL;
+        }
+
+        uint64_t hash = 0xcbf29ce484222325ULL;
+};
+
+void write_u64( std::string &out, uint64_t value )
+{
+    for( int i = 0; i < 8; i++ ) {
+        out.push_back( static_cast<char>( ( value >> ( 8 * i ) ) & 0xff ) );
+    }
+}
+
+void write_string( std::string &out, const std::string &str )
+{
+    write_u64( out, str.size() );
+    out += str;
+}
+
+class snapshot_reader
+{
+    public:
+        snapshot_reader( const std::string &data, size_t pos ) : data( data ), pos( pos ) {}
+
+        uint64_t u64() {
+            need( 8 );
+            uint64_t value = 0;
+            for( int i = 0; i < 8; i++ ) {
+                value |= static_cast<uint64_t>( static_cast<unsigned char>( data[pos + i] ) ) << ( 8 * i );
+            }
+            pos += 8;
+            return value;
+        }
+        std::string string() {
+            const uint64_t size = u64();
+            need( size );
+            std::string str = data.substr( pos, size );
+            pos += size;
+            return str;
+        }
+
+    private:
+        void need( uint64_t count ) const {
+            if( count > data.size() - pos ) {
+                throw std::runtime_error( "data snapshot is truncated" );
+            }
+        }
+
+        const std::string &data;
+        size_t pos;
+};
+
+void add_file_stamp( fingerprint_hasher &hasher, const std::string &file )
+{
+    // A missing file hashes differently from any file that exists
+    int64_t size = -1;
+    int64_t mtime = -1;
+    get_file_stamp( file, size, mtime );
+    hasher.add( file );
+    hasher.add( static_cast<uint64_t>( size ) );
+    hasher.add( static_cast<uint64_t>( mtime ) );
+}
+
+} // namespace
+
+data_snapshot::data_snapshot( const std::vector<pack> &sources,
+                              const std::vector<std::string> &other_inputs )
+{
+    fingerprint_hasher hasher;
+    hasher.add( static_cast<uint64_t>( format_version ) );
+    hasher.add( getVersionString() );
+    for( const pack &p : sources ) {
+        hasher.add( p.path );
+        hasher.add( static_cast<uint64_t>( p.files.size() ) );
+        for( const std::string &file : p.files ) {
+            add_file_stamp( hasher, file );
+        }
+        packs.push_back( { p, {}, false } );
+    }
+    for( const std::string &file : other_inputs ) {
+        add_file_stamp( hasher, file );
+    }
+    fingerprint = hasher.get();
+}
+
+size_t data_snapshot::pack_index( const std::string &pack_path ) const
+{
+    for( size_t i = 0; i < packs.size(); i++ ) {
+        if( packs[i].source.path == pack_path ) {
+            return i;
+        }
+    }
+    throw std::invalid_argument( "content pack " + pack_path + " is not part of the data snapshot" );
+}
+
+const std::vector<std::string> &data_snapshot::files( const std::string &pack_path ) const
+{
+    return packs[pack_index( pack_path )].source.files;
+}
+
+const std::vector<std::string> *data_snapshot::contents( const std::string &pack_path ) const
+{
+    const pack_data &p = packs[pack_index( pack_path )];
+    return p.has_contents ? &p.contents : nullptr;
+}
+
+void data_snapshot::record_contents( const std::string &pack_path,
+                                     std::vector<std::string> contents )
+{
+    pack_data &p = packs[pack_index( pack_path )];
+    if( contents.size() != p.source.files.size() ) {
+        throw std::invalid_argument( "data snapshot contents do not match the files of " + pack_path );
+    }
+    p.contents = std::move( contents );
+    p.has_contents = true;
+}
+
+bool data_snapshot::has_all_contents() const
+{
+    for( const pack_data &p : packs ) {
+        if( !p.has_contents ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool data_snapshot::load( const std::string &path )
+{
+    if( !file_exist( path ) ) {
+        return false;
+    }
+    const std::string data = read_entire_file( path );
+    if( data.size() < sizeof( snapshot_magic ) ||
+        data.compare( 0, sizeof( snapshot_magic ), snapshot_magic, sizeof( snapshot_magic ) ) != 0 ) {
+        return false;
+    }
+    try {
+        snapshot_reader reader( data, sizeof( snapshot_magic ) );
+        if( reader.u64() != fingerprint ) {
+            return false;
+        }
+        // The fingerprint covers the file lists, so they match as long as it does
+        std::vector<std::vector<std::string>> loaded;
+        for( const pack_data &p : packs ) {
+            std::vector<std::string> contents;
+            for( size_t i = 0; i < p.source.files.size(); i++ ) {
+                contents.push_back( reader.string() );
+            }
+            loaded.push_back( std::move( contents ) );
+        }
+        for( size_t i = 0; i < packs.size(); i++ ) {
+            packs[i].contents = std::move( loaded[i] );
+            packs[i].has_contents = true;
+        }
+        return true;
+    } catch( const std::runtime_error & ) {
+        return false;
+    }
+}
+
+bool data_snapshot::save( const std::string &path ) const
+{
+    if( !has_all_contents() ) {
+        return false;
+    }
+    std::string out( snapshot_magic, sizeof( snapshot_magic ) );
+    write_u64( out, fingerprint );
+    for( const pack_data &p : packs ) {
+        for( const std::string &contents : p.contents ) {
+            write_string( out, contents );
+        }
+    }
+    return write_to_file( path, [&out]( std::ostream & fout ) {
+        fout.write( out.data(), out.size() );
+    }, nullptr );
+}
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef CATA_SRC_DATA_SNAPSHOT_H
+#define CATA_SRC_DATA_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Cache of the JSON files of a list of content packs, stored as one file.
+ *
+ * A later start with the same packs reads that one file instead of opening and reading
+ * every data file on its own. The data directories are still listed and every file is
+ * still checked for changes, and the contents are still parsed and finalized as usual.
+ *
+ * The snapshot is keyed by a fingerprint of the game version and of the path, size and
+ * modification time of every data file. Any change to those makes it stale.
+ */
+class data_snapshot
+{
+    public:
+        /** Bumped whenever the layout of the snapshot file changes. */
+        static constexpr int format_version = 2;
+
+        struct pack {
+            std::string path;
+            // Data files in load order
+            std::vector<std::string> files;
+        };
+
+        /**
+         * Computes the fingerprint of the given packs, with their data files in load order.
+         * Other files the loaded data depends on can be added to the fingerprint.
+         */
+        explicit data_snapshot( const std::vector<pack> &packs,
+                                const std::vector<std::string> &other_inputs = {} );
+
+        uint64_t get_fingerprint() const {
+            return fingerprint;
+        }
+
+        /**
+         * Reads the snapshot file. Returns false and keeps nothing from it if the file
+         * is missing, damaged or was made from other data.
+         */
+        bool load( const std::string &path );
+        /** Writes the snapshot file, only valid once the contents of every pack are known. */
+        bool save( const std::string &path ) const;
+
+        const std::vector<std::string> &files( const std::string &pack_path ) const;
+        /** Contents of the files of the pack, nullptr until loaded or recorded. */
+        const std::vector<std::string> *contents( const std::string &pack_path ) const;
+        void record_contents( const std::string &pack_path, std::vector<std::string> contents );
+        bool has_all_contents() const;
+
+    private:
+        struct pack_data {
+            pack source;
+            std::vector<std::string> contents;
+            bool has_contents = false;
+        };
+
+        size_t pack_index( const std::string &pack_path ) const;
+
+        std::vector<pack_data> packs;
+        uint64_t fingerprint = 0;
+};
+
+#endif // CATA_SRC_DATA_SNAPSHOT_H
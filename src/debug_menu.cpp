@@ -57,6 +57,7 @@
 #include "map.h"
 #include "map_extras.h"
 #include "map_iterator.h"
+#include "mapbuffer.h"
 #include "mapgen.h"
 #include "mapgendata.h"
 #include "martialarts.h"
@@ -182,6 +183,7 @@ enum debug_menu_index {
     DEBUG_NESTED_MAPGEN,
     DEBUG_RESET_IGNORED_MESSAGES,
     DEBUG_RELOAD_TILES,
+    DEBUG_CONVERT_MAP_SAVES,
 };
 
 class mission_debug
@@ -301,6 +303,7 @@ static int map_uilist()
         { uilist_entry( DEBUG_OM_EDITOR, true, 'O', _( "Overmap editor" ) ) },
         { uilist_entry( DEBUG_MAP_EXTRA, true, 'm', _( "Spawn map extra" ) ) },
         { uilist_entry( DEBUG_NESTED_MAPGEN, true, 'n', _( "Spawn nested mapgen" ) ) },
+        { uilist_entry( DEBUG_CONVERT_MAP_SAVES, true, 'c', _( "Convert saved map files" ) ) },
     };
 
     return uilist( _( "Map…" ), uilist_initializer );
@@ -1960,6 +1963,22 @@ void debug()
         case DEBUG_NESTED_MAPGEN:
             debug_menu::spawn_nested_mapgen();
             break;
+        case DEBUG_CONVERT_MAP_SAVES: {
+            const int format = uilist( _( "Convert saved map files to…" ), {
+                _( "Binary segment files" ), _( "JSON files" )
+            } );
+            if( format < 0 ) {
+                break;
+            }
+            MAPBUFFER.save();
+            try {
+                const int converted = MAPBUFFER.convert_saved_maps( format == 0 );
+                popup( _( "Converted %d saved map areas." ), converted );
+            } catch( const std::exception &err ) {
+                popup( _( "Failed to convert the saved maps: %s" ), err.what() );
+            }
+            break;
+        }
         case DEBUG_DISPLAY_NPC_PATH:
             g->debug_pathfinding = !g->debug_pathfinding;
             break;
@@ -71,6 +71,7 @@ void distribution_grid::update( time_point to )
 static itype_id itype_battery( "battery" );
 int distribution_grid::mod_resource( int amt, bool recurse )
 {
+    map::invalidate_inventory_caches();
     std::vector<vehicle *> connected_vehicles;
     for( const auto &c : contents ) {
         for( const tile_location &loc : c.second ) {
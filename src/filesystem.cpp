@@ -80,6 +80,24 @@ bool file_exist( const std::string &path )
 }
 #endif
 
+bool get_file_stamp( const std::string &path, int64_t &size, int64_t &mtime )
+{
+#if defined(_WIN32)
+    struct _stat64 result;
+    if( _wstat64( utf8_to_wstr( path ).c_str(), &result ) != 0 ) {
+        return false;
+    }
+#else
+    struct stat result;
+    if( stat( path.c_str(), &result ) != 0 ) {
+        return false;
+    }
+#endif
+    size = static_cast<int64_t>( result.st_size );
+    mtime = static_cast<int64_t>( result.st_mtime );
+    return true;
+}
+
 #if defined(_WIN32)
 bool remove_file( const std::string &path )
 {
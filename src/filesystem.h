@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_FILESYSTEM_H
 #define CATA_SRC_FILESYSTEM_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -45,6 +46,11 @@ bool can_write_to_dir( const std::string &dir_path );
  * @return true on success, false on failure.
  */
 bool copy_file( const std::string &source_path, const std::string &dest_path );
+/**
+ * Get the size and the last modification time (in seconds) of a file.
+ * @return false if unable to check.
+ */
+bool get_file_stamp( const std::string &path, int64_t &size, int64_t &mtime );
 /** Get process id string. Used for temporary file paths. */
 std::string get_pid_string();
 
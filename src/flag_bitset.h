@@ -0,0 +1,49 @@
+#pragma once
+#ifndef CATA_SRC_FLAG_BITSET_H
+#define CATA_SRC_FLAG_BITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Set of flags that were interned into dense, non-negative integer ids.
+ * Membership is a single bit test. Negative or never set ids test as absent,
+ * so the set does not need to know how many ids exist.
+ */
+class flag_bitset
+{
+    public:
+        bool test( int id ) const {
+            const size_t word = static_cast<size_t>( id ) / word_bits;
+            return id >= 0 && word < words.size() && ( ( words[word] >> ( id % word_bits ) ) & 1 );
+        }
+        void set( int id ) {
+            if( id < 0 ) {
+                return;
+            }
+            const size_t word = static_cast<size_t>( id ) / word_bits;
+            if( word >= words.size() ) {
+                words.resize( word + 1, 0 );
+            }
+            words[word] |= std::uint64_t( 1 ) << ( id % word_bits );
+        }
+        void clear() {
+            words.clear();
+        }
+        flag_bitset &operator|=( const flag_bitset &other ) {
+            if( other.words.size() > words.size() ) {
+                words.resize( other.words.size(), 0 );
+            }
+            for( size_t i = 0; i < other.words.size(); i++ ) {
+                words[i] |= other.words[i];
+            }
+            return *this;
+        }
+
+    private:
+        static constexpr int word_bits = 64;
+        std::vector<std::uint64_t> words;
+};
+
+#endif // CATA_SRC_FLAG_BITSET_H
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef CATA_SRC_FOV_BITMAP_H
+#define CATA_SRC_FOV_BITMAP_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include "game_constants.h"
+#include "point.h"
+
+/**
+ * Field of view of one observer on its own z-level, as one bit per tile of a
+ * square window centered on the observer. Filled by @ref map::update_fov_bitmap
+ * with the shadowcasting used for the player's vision, so afterwards asking
+ * whether the observer sees a tile is a single bit test.
+ *
+ * Shadowcasting and the Bresenham lines of @ref map::sees do not agree on every
+ * tile: they can differ at the edges of shadows, mostly next to corners and
+ * diagonal gaps. Both agree on tiles in the open and on tiles fully behind walls.
+ */
+class fov_bitmap
+{
+    public:
+        /** Tiles further away than this along either axis are outside the window. */
+        static constexpr int radius = MAX_VIEW_DISTANCE;
+
+        /**
+         * Whether the bitmap holds the view from @p observer, as cast while the map
+         * had its corner at @p map_abs_sub.
+         */
+        bool is_valid_for( const tripoint &observer, const tripoint &map_abs_sub ) const {
+            return observer == origin && map_abs_sub == abs_sub;
+        }
+        /** Whether @p p lies on the z-level and in the window of the bitmap. */
+        bool covers( const tripoint &p ) const {
+            return p.z == origin.z && std::abs( p.x - origin.x ) <= radius &&
+                   std::abs( p.y - origin.y ) <= radius;
+        }
+        /** Whether @p p was seen. Tiles outside the window are never seen. */
+        bool test( const tripoint &p ) const {
+            if( !covers( p ) ) {
+                return false;
+            }
+            const size_t i = index( p.xy() );
+            return ( bits[i / word_bits] >> ( i % word_bits ) ) & 1;
+        }
+
+        /** Forgets all seen tiles and moves the window to @p new_origin. */
+        void reset( const tripoint &new_origin, const tripoint &map_abs_sub, int map_generation ) {
+            origin = new_origin;
+            abs_sub = map_abs_sub;
+            generation = map_generation;
+            bits.fill( 0 );
+        }
+        void set( const point &p ) {
+            const size_t i = index( p );
+            bits[i / word_bits] |= std::uint64_t( 1 ) << ( i % word_bits );
+        }
+
+        /** Center of the window, in map square coordinates. */
+        tripoint origin = tripoint_min;
+        /** @ref map::abs_sub at the time of casting. */
+        tripoint abs_sub = tripoint_min;
+        /** @ref map transparency generation at the time of casting. */
+        int generation = 0;
+
+    private:
+        static constexpr int side = radius * 2 + 1;
+        static constexpr size_t word_bits = 64;
+
+        size_t index( const point &p ) const {
+            return static_cast<size_t>( p.y - origin.y + radius ) * side + ( p.x - origin.x + radius );
+        }
+
+        std::array<std::uint64_t, ( side * side + word_bits - 1 ) / word_bits> bits = {};
+};
+
+#endif // CATA_SRC_FOV_BITMAP_H
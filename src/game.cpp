@@ -128,6 +128,7 @@
 #include "mutation.h"
 #include "npc.h"
 #include "npc_class.h"
+#include "npc_threat_field.h"
 #include "omdata.h"
 #include "options.h"
 #include "output.h"
@@ -159,6 +160,7 @@
 #include "string_id.h"
 #include "string_input_popup.h"
 #include "submap.h"
+#include "thread_pool.h"
 #include "tileray.h"
 #include "timed_event.h"
 #include "translations.h"
@@ -1150,6 +1152,8 @@ bool game::cleanup_at_end()
             characters.erase( curchar );
         }
 
+        // Map saves finish in the background, the world may be deleted below
+        MAPBUFFER.wait_for_io();
         if( characters.empty() ) {
             bool queryDelete = false;
             bool queryReset = false;
@@ -4065,6 +4069,30 @@ void game::monmove()
 {
     cleanup_dead();
 
+    // Checking which targets monsters can see only reads the map, so it is done
+    // for all monsters at once before the serial pass that moves them around.
+    monster_plan_candidates candidates;
+    std::vector<monster *> planners;
+    for( monster &critter : all_monsters() ) {
+        if( !critter.has_effect( effect_ai_controlled ) && !critter.has_effect( effect_ridden ) ) {
+            planners.push_back( &critter );
+        }
+    }
+    for( npc &guy : all_npcs() ) {
+        candidates.npcs.emplace_back( &guy, guy.get_monster_faction() );
+    }
+    // Fill the light level memo now instead of from several threads
+    for( int z = 0; z <= OVERMAP_HEIGHT; z++ ) {
+        natural_light_level( z );
+    }
+    const bool vision_bitmaps = get_option<bool>( "MONSTER_VISION_BITMAPS" );
+    cata::parallel_for( static_cast<int>( planners.size() ), [&]( int i ) {
+        if( vision_bitmaps ) {
+            planners[i]->update_vision_bitmap();
+        }
+        planners[i]->prepare_plan( candidates );
+    } );
+
     for( monster &critter : all_monsters() ) {
         // Critters in impassable tiles get pushed away, unless it's not impassable for them
         if( !critter.is_dead() && m.impassable( critter.pos() ) && !critter.can_move_to( critter.pos() ) ) {
@@ -4144,6 +4172,9 @@ void game::monmove()
     }
 
     // Now, do active NPCs.
+    // They all assess the same monsters and fires, so gather those once.
+    npc_threat_field &threat_field = get_npc_threat_field();
+    threat_field.build( m );
     for( npc &guy : g->all_npcs() ) {
         int turns = 0;
         if( guy.is_mounted() ) {
@@ -4184,6 +4215,7 @@ void game::monmove()
             guy.npc_update_body();
         }
     }
+    threat_field.clear();
     cleanup_dead();
 }
 
@@ -1,6 +1,8 @@
 #include "init.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
 #include <exception>
 #include <fstream>
@@ -31,6 +33,7 @@
 #include "crafting_gui.h"
 #include "creature.h"
 #include "cursesdef.h"
+#include "data_snapshot.h"
 #include "debug.h"
 #include "dependency_tree.h"
 #include "dialogue.h"
@@ -73,12 +76,14 @@
 #include "npc.h"
 #include "npc_class.h"
 #include "omdata.h"
+#include "options.h"
 #include "overlay_ordering.h"
 #include "overmap.h"
 #include "overmapbuffer.h"
 #include "overmap_connection.h"
 #include "overmap_location.h"
 #include "overmap_special.h"
+#include "path_info.h"
 #include "profession.h"
 #include "recipe_dictionary.h"
 #include "recipe_groups.h"
@@ -95,6 +100,7 @@
 #include "start_location.h"
 #include "string_formatter.h"
 #include "text_snippets.h"
+#include "thread_pool.h"
 #include "translations.h"
 #include "trap.h"
 #include "type_id.h"
@@ -109,6 +115,19 @@
 #  include "mod_tileset.h"
 #endif
 
+namespace
+{
+
+// Time spent in each loading phase goes to the debug log
+using load_clock = std::chrono::steady_clock;
+
+long long to_ms( load_clock::duration d )
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>( d ).count();
+}
+
+} // namespace
+
 DynamicDataLoader::DynamicDataLoader()
 {
     initialize();
@@ -463,16 +482,8 @@ void DynamicDataLoader::initialize()
 #endif
 }
 
-void DynamicDataLoader::load_data_from_path( const std::string &path, const std::string &src,
-        loading_ui &ui )
+std::vector<std::string> DynamicDataLoader::get_data_files( const std::string &path )
 {
-    assert( !finalized && "Can't load additional data after finalization.  Must be unloaded first." );
-    // We assume that each folder is consistent in itself,
-    // and all the previously loaded folders.
-    // E.g. the core might provide a vpart "frame-x"
-    // the first loaded mode might provide a vehicle that uses that frame
-    // But not the other way round.
-
     // get a list of all files in the directory
     str_vec files = get_files_from_path( ".json", path, true, true );
     if( files.empty() ) {
@@ -483,26 +494,60 @@ void DynamicDataLoader::load_data_from_path( const std::string &path, const std:
             files.push_back( path );
         }
     }
-    // iterate over each file
-    for( auto &files_i : files ) {
-        const std::string &file = files_i;
-        // open the file as a stream
-        cata_ifstream infile = std::move( cata_ifstream().mode( cata_ios_mode::binary ).open( file ) );
-        // and stuff it into ram
-        std::istringstream iss(
-            std::string(
-                ( std::istreambuf_iterator<char>( *infile ) ),
-                std::istreambuf_iterator<char>()
-            )
-        );
-        try {
-            // parse it
-            JsonIn jsin( iss, file );
-            load_all_from_json( jsin, src, ui, path, file );
-        } catch( const JsonError &err ) {
-            throw std::runtime_error( err.what() );
+    return files;
+}
+
+void DynamicDataLoader::load_data_from_path( const std::string &path, const std::string &src,
+        loading_ui &ui, data_snapshot *snapshot )
+{
+    assert( !finalized && "Can't load additional data after finalization.  Must be unloaded first." );
+    // We assume that each folder is consistent in itself,
+    // and all the previously loaded folders.
+    // E.g. the core might provide a vpart "frame-x"
+    // the first loaded mode might provide a vehicle that uses that frame
+    // But not the other way round.
+
+    const str_vec files = snapshot ? snapshot->files( path ) : get_data_files( path );
+    const str_vec *snapshot_contents = snapshot ? snapshot->contents( path ) : nullptr;
+    const auto start = load_clock::now();
+    load_clock::duration reading( 0 );
+    // Files are read ahead in batches on the thread pool, their objects are still
+    // registered here one file at a time and in the original order
+    const size_t batch_size = static_cast<size_t>( cata::parallel_for_threads() ) * 8;
+    str_vec contents;
+    for( size_t batch_start = 0; batch_start < files.size(); batch_start += batch_size ) {
+        const size_t batch_end = std::min( files.size(), batch_start + batch_size );
+        if( !snapshot_contents ) {
+            const auto read_start = load_clock::now();
+            contents.resize( batch_end );
+            cata::parallel_for( static_cast<int>( batch_end - batch_start ), [&]( int i ) {
+                contents[batch_start + i] = read_entire_file( files[batch_start + i] );
+            } );
+            reading += load_clock::now() - read_start;
+        }
+
+        for( size_t i = batch_start; i < batch_end; i++ ) {
+            const std::string &file = files[i];
+            try {
+                // parse it
+                JsonIn jsin( snapshot_contents ? ( *snapshot_contents )[i] : contents[i], file );
+                load_all_from_json( jsin, src, ui, path, file );
+            } catch( const JsonError &err ) {
+                throw std::runtime_error( err.what() );
+            }
+            if( !snapshot ) {
+                // Nobody needs the file any more
+                contents[i] = std::string();
+            }
         }
     }
+    if( snapshot && !snapshot_contents ) {
+        snapshot->record_contents( path, std::move( contents ) );
+    }
+    const load_clock::duration total = load_clock::now() - start;
+    DebugLog( DL::Info, DC::Main ) << string_format( "Loaded %d files of %s: %lld ms reading, "
+                                   "%lld ms registering", static_cast<int>( files.size() ), src,
+                                   to_ms( reading ), to_ms( total - reading ) );
 }
 
 void DynamicDataLoader::load_all_from_json( JsonIn &jsin, const std::string &src, loading_ui &,
@@ -712,7 +757,10 @@ void DynamicDataLoader::finalize_loaded_data( loading_ui &ui )
 
     ui.show();
     for( const named_entry &e : entries ) {
+        const auto start = load_clock::now();
         e.second();
+        DebugLog( DL::Info, DC::Main ) << string_format( "Finalized %s: %lld ms", e.first,
+                                       to_ms( load_clock::now() - start ) );
         ui.proceed();
     }
 
@@ -808,7 +856,10 @@ void DynamicDataLoader::check_consistency( loading_ui &ui )
 
     ui.show();
     for( const named_entry &e : entries ) {
+        const auto start = load_clock::now();
         e.second();
+        DebugLog( DL::Info, DC::Main ) << string_format( "Verified %s: %lld ms", e.first,
+                                       to_ms( load_clock::now() - start ) );
         ui.proceed();
     }
 }
@@ -820,7 +871,9 @@ void DynamicDataLoader::check_consistency( loading_ui &ui )
  * @param packs content packs to load in correct dependent order
  */
 static void load_and_finalize_packs( loading_ui &ui, const std::string &msg,
-                                     const std::vector<mod_id> &packs )
+                                     const std::vector<mod_id> &packs,
+                                     const std::string &snapshot_name = std::string(),
+                                     const std::vector<std::string> &other_inputs = {} )
 {
     ui.new_context( msg );
     std::vector<mod_id> missing;
@@ -841,13 +894,37 @@ static void load_and_finalize_packs( loading_ui &ui, const std::string &msg,
 
     DynamicDataLoader &loader = DynamicDataLoader::get_instance();
 
+    const auto start = load_clock::now();
+    std::unique_ptr<data_snapshot> snapshot;
+    bool snapshot_loaded = false;
+    const std::string snapshot_path = PATH_INFO::config_dir() + "data_snapshot_" + snapshot_name +
+                                      ".bin";
+    if( !snapshot_name.empty() && get_option<bool>( "DATA_SNAPSHOT" ) ) {
+        std::vector<data_snapshot::pack> sources;
+        for( const mod_id &mod : available ) {
+            sources.push_back( { mod->path, DynamicDataLoader::get_data_files( mod->path ) } );
+        }
+        snapshot = std::make_unique<data_snapshot>( sources, other_inputs );
+        snapshot_loaded = snapshot->load( snapshot_path );
+        if( !snapshot_loaded ) {
+            DebugLog( DL::Info, DC::Main ) << "No up to date data snapshot, reading the data files";
+        }
+    }
+
     ui.show();
     for( const mod_id &mod : available ) {
-        loader.load_data_from_path( mod->path, mod.str(), ui );
+        loader.load_data_from_path( mod->path, mod.str(), ui, snapshot.get() );
         ui.proceed();
     }
 
+    // Finalization and the consistency checks always run, some of the checks still
+    // complete the loaded data
     loader.finalize_loaded_data( ui );
+    if( snapshot && !snapshot_loaded ) {
+        snapshot->save( snapshot_path );
+    }
+    DebugLog( DL::Info, DC::Main ) << string_format( "%s: %lld ms in total", msg,
+                                   to_ms( load_clock::now() - start ) );
 }
 
 bool init::is_data_loaded()
@@ -867,7 +944,7 @@ void init::load_core_bn_modfiles()
     loading_ui ui( false );
     load_and_finalize_packs(
         ui, _( "Loading content packs" ),
-    { mod_management::get_default_core_content_pack() }
+    { mod_management::get_default_core_content_pack() }, "core"
     );
 }
 
@@ -903,7 +980,8 @@ void init::load_world_modfiles( loading_ui &ui, const std::string &artifacts_fil
     // are resolved during the creation of the world.
     // That means world->active_mod_order contains a list
     // of mods in the correct order.
-    load_and_finalize_packs( ui, _( "Loading files" ), mods );
+    // Artifacts are part of the data, so the snapshot has to be remade when they change
+    load_and_finalize_packs( ui, _( "Loading files" ), mods, "world", { artifacts_file } );
 }
 
 bool init::check_mods_for_errors( loading_ui &ui, const std::vector<mod_id> &opts )
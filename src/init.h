@@ -13,6 +13,7 @@
 #include "memory_fast.h"
 #include "type_id.h"
 
+class data_snapshot;
 class loading_ui;
 class JsonObject;
 class JsonIn;
@@ -131,11 +132,16 @@ class DynamicDataLoader
          * that file, don't check extension).
          * @param src String identifier for mod this data comes from
          * @param ui Finalization status display.
+         * @param snapshot If given, the files are taken from it when it holds them,
+         * otherwise the files read are recorded in it.
          * @throws std::exception on all kind of errors.
          */
         /*@{*/
-        void load_data_from_path( const std::string &path, const std::string &src, loading_ui &ui );
+        void load_data_from_path( const std::string &path, const std::string &src, loading_ui &ui,
+                                  data_snapshot *snapshot = nullptr );
         /*@}*/
+        /** Data files @ref load_data_from_path loads from the path, in load order. */
+        static std::vector<std::string> get_data_files( const std::string &path );
         /**
          * Deletes and unloads all the data previously loaded with
          * @ref load_data_from_path
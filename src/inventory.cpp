@@ -131,11 +131,30 @@ invlet_favorites::get_invlets_by_id() const
 
 inventory::inventory() = default;
 
+// The type cache and the binned items point into the inventory they were built for
+inventory::inventory( const inventory &other ) : visitable<inventory>( other ),
+    assigned_invlet( other.assigned_invlet ), invlet_cache( other.invlet_cache ),
+    items( other.items ), quality_cache( other.quality_cache ),
+    quality_cached( other.quality_cached )
+{
+}
+
+inventory &inventory::operator=( const inventory &other )
+{
+    if( this != &other ) {
+        *this = inventory( other );
+    }
+    return *this;
+}
+
 invslice inventory::slice()
 {
+    // The items may change type through the slice
+    items_type_cached = false;
     invslice stacks;
+    stacks.reserve( items.size() );
     for( auto &elem : items ) {
-        stacks.push_back( &elem );
+        stacks.push_back( elem.get() );
     }
     return stacks;
 }
@@ -143,8 +162,9 @@ invslice inventory::slice()
 const_invslice inventory::const_slice() const
 {
     const_invslice stacks;
-    for( const auto &item : items ) {
-        stacks.push_back( &item );
+    stacks.reserve( items.size() );
+    for( const auto &elem : items ) {
+        stacks.push_back( elem.get() );
     }
     return stacks;
 }
@@ -157,11 +177,7 @@ const std::list<item> &inventory::const_stack( int i ) const
         return nullstack;
     }
 
-    invstack::const_iterator iter = items.begin();
-    for( int j = 0; j < i; ++j ) {
-        ++iter;
-    }
-    return *iter;
+    return *items[i];
 }
 
 size_t inventory::size() const
@@ -230,16 +246,28 @@ void inventory::unsort()
     items_type_cached = false;
 }
 
-static bool stack_compare( const std::list<item> &lhs, const std::list<item> &rhs )
+void inventory::invalidate_caches()
+{
+    binned = false;
+    items_type_cached = false;
+    quality_cache.clear();
+    quality_cached = false;
+}
+
+void inventory::sort_stacks()
 {
-    return lhs.front() < rhs.front();
+    std::stable_sort( items.begin(), items.end(),
+    []( const cata::value_ptr<std::list<item>> &lhs, const cata::value_ptr<std::list<item>> &rhs ) {
+        return lhs->front() < rhs->front();
+    } );
+    // The stacks of each type must be listed in the new order
+    items_type_cached = false;
 }
 
 void inventory::clear()
 {
     items.clear();
-    binned = false;
-    items_type_cached = false;
+    invalidate_caches();
 }
 
 void inventory::push_back( const std::list<item> &newits )
@@ -286,32 +314,50 @@ char inventory::find_usable_cached_invlet( const itype_id &item_type )
 item &inventory::add_item( item newit, bool keep_invlet, bool assign_invlet, bool should_stack )
 {
     binned = false;
-    items_type_cached = false;
+    if( !items_type_cached ) {
+        build_items_type_cache();
+    }
+    if( quality_cached ) {
+        add_to_quality_cache( newit );
+    }
 
+    std::vector<std::list<item> *> &same_type = items_type_cache[newit.typeId()];
     if( should_stack ) {
-        // See if we can't stack this item.
-        for( auto &elem : items ) {
-            std::list<item>::iterator it_ref = elem.begin();
-            if( it_ref->stacks_with( newit ) ) {
-                if( it_ref->merge_charges( newit ) ) {
-                    return *it_ref;
+        // Only stacks of the same type can take the item, try the first one that does.
+        std::list<item> *target = nullptr;
+        for( std::list<item> *stack : same_type ) {
+            if( stack->front().stacks_with( newit ) ) {
+                target = stack;
+                break;
+            }
+        }
+        if( keep_invlet && assign_invlet && newit.invlet != '\0' ) {
+            // We'll be forcing the stacks in front of the target out of their current invlet.
+            for( auto &elem : items ) {
+                if( elem.get() == target ) {
+                    break;
                 }
-                if( it_ref->invlet == '\0' ) {
-                    if( !keep_invlet ) {
-                        update_invlet( newit, assign_invlet );
-                    }
-                    update_cache_with_item( newit );
-                    it_ref->invlet = newit.invlet;
-                } else {
-                    newit.invlet = it_ref->invlet;
+                if( elem->front().invlet == newit.invlet ) {
+                    assign_empty_invlet( elem->front(), g->u );
+                }
+            }
+        }
+        if( target != nullptr ) {
+            item &it_ref = target->front();
+            if( it_ref.merge_charges( newit ) ) {
+                return it_ref;
+            }
+            if( it_ref.invlet == '\0' ) {
+                if( !keep_invlet ) {
+                    update_invlet( newit, assign_invlet );
                 }
-                elem.emplace_back( std::move( newit ) );
-                return elem.back();
-            } else if( keep_invlet && assign_invlet && it_ref->invlet == newit.invlet &&
-                       it_ref->invlet != '\0' ) {
-                // If keep_invlet is true, we'll be forcing other items out of their current invlet.
-                assign_empty_invlet( *it_ref, g->u );
+                update_cache_with_item( newit );
+                it_ref.invlet = newit.invlet;
+            } else {
+                newit.invlet = it_ref.invlet;
             }
+            target->emplace_back( std::move( newit ) );
+            return target->back();
         }
     }
 
@@ -321,16 +367,18 @@ item &inventory::add_item( item newit, bool keep_invlet, bool assign_invlet, boo
     }
     update_cache_with_item( newit );
 
-    items.emplace_back( std::list<item> { std::move( newit ) } );
-    return items.back().back();
+    items.emplace_back( cata::make_value<std::list<item>>() );
+    std::list<item> &stack = *items.back();
+    stack.emplace_back( std::move( newit ) );
+    same_type.push_back( &stack );
+    return stack.back();
 }
 
 void inventory::build_items_type_cache()
 {
     items_type_cache.clear();
     for( auto &elem : items ) {
-        itype_id type = elem.front().typeId();
-        items_type_cache[type].push_back( &elem );
+        items_type_cache[elem->front().typeId()].push_back( elem.get() );
     }
     items_type_cached = true;
 }
@@ -338,48 +386,7 @@ void inventory::build_items_type_cache()
 item &inventory::add_item_by_items_type_cache( item newit, bool keep_invlet, bool assign_invlet,
         bool should_stack )
 {
-    binned = false;
-    if( !items_type_cached ) {
-        debugmsg( "Tried to add item to inventory using cache without building the items_type_cache." );
-        build_items_type_cache();
-    }
-    itype_id type = newit.typeId();
-    if( should_stack ) {
-        // See if we can't stack this item.
-        for( auto &elem : items_type_cache[type] ) {
-            auto it_ref = elem->begin();
-            if( it_ref->stacks_with( newit, false, true ) ) {
-                if( it_ref->merge_charges( newit ) ) {
-                    return *it_ref;
-                }
-                if( it_ref->invlet == '\0' ) {
-                    if( !keep_invlet ) {
-                        update_invlet( newit, assign_invlet );
-                    }
-                    update_cache_with_item( newit );
-                    it_ref->invlet = newit.invlet;
-                } else {
-                    newit.invlet = it_ref->invlet;
-                }
-                elem->push_back( newit );
-                return elem->back();
-            } else if( keep_invlet && assign_invlet && it_ref->invlet == newit.invlet &&
-                       it_ref->invlet != '\0' ) {
-                // If keep_invlet is true, we'll be forcing other items out of their current invlet.
-                assign_empty_invlet( *it_ref, g->u );
-            }
-        }
-    }
-
-    // Couldn't stack the item, proceed.
-    if( !keep_invlet ) {
-        update_invlet( newit, assign_invlet );
-    }
-    update_cache_with_item( newit );
-
-    items.push_back( {newit} );
-    items_type_cache[type].push_back( &items.back() );
-    return items.back().back();
+    return add_item( std::move( newit ), keep_invlet, assign_invlet, should_stack );
 }
 
 void inventory::add_item_keep_invlet( item newit )
@@ -403,12 +410,11 @@ void inventory::restack( player &p )
     // 2. remove items from non-matching stacks
     // 3. combine matching stacks
 
-    binned = false;
-    items_type_cached = false;
+    invalidate_caches();
     std::list<item> to_restack;
     int idx = 0;
     for( invstack::iterator iter = items.begin(); iter != items.end(); ++iter, ++idx ) {
-        std::list<item> &stack = *iter;
+        std::list<item> &stack = **iter;
         item &topmost = stack.front();
 
         const item *invlet_item = p.invlet_to_item( topmost.invlet );
@@ -422,25 +428,48 @@ void inventory::restack( player &p )
 
         // remove non-matching items, stripping off end of stack so the first item keeps the invlet.
         while( stack.size() > 1 && !topmost.stacks_with( stack.back() ) ) {
-            to_restack.splice( to_restack.begin(), *iter, --stack.end() );
+            to_restack.splice( to_restack.begin(), stack, --stack.end() );
         }
     }
 
-    // combine matching stacks
+    // combine matching stacks, only stacks of the same type can match
     // separate loop to ensure that ALL stacks are homogeneous
-    for( invstack::iterator iter = items.begin(); iter != items.end(); ++iter ) {
-        for( invstack::iterator other = iter; other != items.end(); ++other ) {
-            if( iter != other && iter->front().stacks_with( other->front() ) ) {
-                if( other->front().count_by_charges() ) {
-                    iter->front().charges += other->front().charges;
+    std::unordered_map<itype_id, std::vector<size_t>> stacks_by_type;
+    for( size_t i = 0; i < items.size(); i++ ) {
+        stacks_by_type[items[i]->front().typeId()].push_back( i );
+    }
+    std::vector<bool> merged( items.size(), false );
+    for( const auto &same_type : stacks_by_type ) {
+        const std::vector<size_t> &indices = same_type.second;
+        for( size_t i = 0; i < indices.size(); i++ ) {
+            if( merged[indices[i]] ) {
+                continue;
+            }
+            std::list<item> &stack = *items[indices[i]];
+            for( size_t j = i + 1; j < indices.size(); j++ ) {
+                std::list<item> &other = *items[indices[j]];
+                if( merged[indices[j]] || !stack.front().stacks_with( other.front() ) ) {
+                    continue;
+                }
+                if( other.front().count_by_charges() ) {
+                    stack.front().charges += other.front().charges;
                 } else {
-                    iter->splice( iter->begin(), *other );
+                    stack.splice( stack.begin(), other );
                 }
-                other = items.erase( other );
-                --other;
+                merged[indices[j]] = true;
+            }
+        }
+    }
+    size_t kept = 0;
+    for( size_t i = 0; i < items.size(); i++ ) {
+        if( !merged[i] ) {
+            if( kept != i ) {
+                items[kept] = std::move( items[i] );
             }
+            kept++;
         }
     }
+    items.erase( items.begin() + kept, items.end() );
 
     //re-add non-matching items
     for( auto &elem : to_restack ) {
@@ -448,12 +477,12 @@ void inventory::restack( player &p )
     }
 
     //Ensure that all items in the same stack have the same invlet.
-    for( std::list< item > &outer : items ) {
-        for( item &inner : outer ) {
-            inner.invlet = outer.front().invlet;
+    for( auto &outer : items ) {
+        for( item &inner : *outer ) {
+            inner.invlet = outer->front().invlet;
         }
     }
-    items.sort( stack_compare );
+    sort_stacks();
 
 #if defined(__ANDROID__)
     remove_stale_inventory_quick_shortcuts();
@@ -510,8 +539,7 @@ void inventory::form_from_map( map &m, std::vector<tripoint> pts, const Characte
                                bool assign_invlet )
 {
     const time_point bday = calendar::start_of_cataclysm;
-    items.clear();
-    build_items_type_cache();
+    clear();
     for( const tripoint &p : pts ) {
         if( m.has_furn( p ) ) {
             const furn_t &f = m.furn( p ).obj();
@@ -694,23 +722,19 @@ void inventory::form_from_map( map &m, std::vector<tripoint> pts, const Characte
 
 std::list<item> inventory::reduce_stack( const int position, const int quantity )
 {
-    int pos = 0;
     std::list<item> ret;
-    for( invstack::iterator iter = items.begin(); iter != items.end(); ++iter ) {
-        if( position == pos ) {
-            binned = false;
-            items_type_cached = false;
-            if( quantity >= static_cast<int>( iter->size() ) || quantity < 0 ) {
-                ret = *iter;
-                items.erase( iter );
-            } else {
-                for( int i = 0 ; i < quantity ; i++ ) {
-                    ret.push_back( remove_item( &iter->front() ) );
-                }
-            }
-            break;
+    if( position < 0 || position >= static_cast<int>( items.size() ) ) {
+        return ret;
+    }
+    invalidate_caches();
+    std::list<item> &stack = *items[position];
+    if( quantity >= static_cast<int>( stack.size() ) || quantity < 0 ) {
+        ret = stack;
+        items.erase( items.begin() + position );
+    } else {
+        for( int i = 0 ; i < quantity ; i++ ) {
+            ret.push_back( remove_item( &stack.front() ) );
         }
-        ++pos;
     }
     return ret;
 }
@@ -721,8 +745,7 @@ item inventory::remove_item( const item *it )
         return &i == it;
     }, 1 );
     if( !tmp.empty() ) {
-        binned = false;
-        items_type_cached = false;
+        invalidate_caches();
         return tmp.front();
     }
     debugmsg( "Tried to remove a item not in inventory." );
@@ -731,28 +754,23 @@ item inventory::remove_item( const item *it )
 
 item inventory::remove_item( const int position )
 {
-    int pos = 0;
-    for( invstack::iterator iter = items.begin(); iter != items.end(); ++iter ) {
-        if( position == pos ) {
-            binned = false;
-            items_type_cached = false;
-            if( iter->size() > 1 ) {
-                std::list<item>::iterator stack_member = iter->begin();
-                char invlet = stack_member->invlet;
-                ++stack_member;
-                stack_member->invlet = invlet;
-            }
-            item ret = iter->front();
-            iter->erase( iter->begin() );
-            if( iter->empty() ) {
-                items.erase( iter );
-            }
-            return ret;
-        }
-        ++pos;
+    if( position < 0 || position >= static_cast<int>( items.size() ) ) {
+        return item();
     }
-
-    return item();
+    invalidate_caches();
+    std::list<item> &stack = *items[position];
+    if( stack.size() > 1 ) {
+        std::list<item>::iterator stack_member = stack.begin();
+        char invlet = stack_member->invlet;
+        ++stack_member;
+        stack_member->invlet = invlet;
+    }
+    item ret = stack.front();
+    stack.erase( stack.begin() );
+    if( stack.empty() ) {
+        items.erase( items.begin() + position );
+    }
+    return ret;
 }
 
 std::list<item> inventory::remove_randomly_by_volume( const units::volume &volume )
@@ -762,9 +780,9 @@ std::list<item> inventory::remove_randomly_by_volume( const units::volume &volum
     while( volume_dropped < volume ) {
         units::volume cumulative_volume = 0_ml;
         auto chosen_stack = items.begin();
-        auto chosen_item = chosen_stack->begin();
+        auto chosen_item = ( *chosen_stack )->begin();
         for( auto stack = items.begin(); stack != items.end(); ++stack ) {
-            for( auto stack_it = stack->begin(); stack_it != stack->end(); ++stack_it ) {
+            for( auto stack_it = ( *stack )->begin(); stack_it != ( *stack )->end(); ++stack_it ) {
                 cumulative_volume += stack_it->volume();
                 if( x_in_y( stack_it->volume().value(), cumulative_volume.value() ) ) {
                     chosen_item = stack_it;
@@ -774,14 +792,14 @@ std::list<item> inventory::remove_randomly_by_volume( const units::volume &volum
         }
         volume_dropped += chosen_item->volume();
         result.push_back( std::move( *chosen_item ) );
-        chosen_item = chosen_stack->erase( chosen_item );
-        if( chosen_item == chosen_stack->begin() && !chosen_stack->empty() ) {
+        std::list<item> &stack = **chosen_stack;
+        chosen_item = stack.erase( chosen_item );
+        if( chosen_item == stack.begin() && !stack.empty() ) {
             // preserve the invlet when removing the first item of a stack
             chosen_item->invlet = result.back().invlet;
         }
-        if( chosen_stack->empty() ) {
-            binned = false;
-            items_type_cached = false;
+        invalidate_caches();
+        if( stack.empty() ) {
             items.erase( chosen_stack );
         }
     }
@@ -790,8 +808,10 @@ std::list<item> inventory::remove_randomly_by_volume( const units::volume &volum
 
 void inventory::dump( std::vector<item *> &dest )
 {
+    // The items may change type through the pointers
+    items_type_cached = false;
     for( auto &elem : items ) {
-        for( auto &elem_stack_iter : elem ) {
+        for( auto &elem_stack_iter : *elem ) {
             dest.push_back( &elem_stack_iter );
         }
     }
@@ -802,15 +822,13 @@ const item &inventory::find_item( int position ) const
     if( position < 0 || position >= static_cast<int>( items.size() ) ) {
         return null_item_reference();
     }
-    invstack::const_iterator iter = items.begin();
-    for( int j = 0; j < position; ++j ) {
-        ++iter;
-    }
-    return iter->front();
+    return items[position]->front();
 }
 
 item &inventory::find_item( int position )
 {
+    // The item may change type through the reference
+    items_type_cached = false;
     return const_cast<item &>( const_cast<const inventory *>( this )->find_item( position ) );
 }
 
@@ -818,7 +836,7 @@ int inventory::invlet_to_position( char invlet ) const
 {
     int i = 0;
     for( const auto &elem : items ) {
-        if( elem.begin()->invlet == invlet ) {
+        if( elem->front().invlet == invlet ) {
             return i;
         }
         ++i;
@@ -830,7 +848,7 @@ int inventory::position_by_item( const item *it ) const
 {
     int p = 0;
     for( const auto &stack : items ) {
-        for( const auto &e : stack ) {
+        for( const auto &e : *stack ) {
             if( e.has_item( *it ) ) {
                 return p;
             }
@@ -844,7 +862,7 @@ int inventory::position_by_type( const itype_id &type ) const
 {
     int i = 0;
     for( auto &elem : items ) {
-        if( elem.front().typeId() == type ) {
+        if( elem->front().typeId() == type ) {
             return i;
         }
         ++i;
@@ -855,26 +873,28 @@ int inventory::position_by_type( const itype_id &type ) const
 std::list<item> inventory::use_amount( itype_id it, int quantity,
                                        const std::function<bool( const item & )> &filter )
 {
-    items.sort( stack_compare );
+    sort_stacks();
     std::list<item> ret;
     for( invstack::iterator iter = items.begin(); iter != items.end() && quantity > 0; /* noop */ ) {
-        for( std::list<item>::iterator stack_iter = iter->begin();
-             stack_iter != iter->end() && quantity > 0;
+        std::list<item> &stack = **iter;
+        for( std::list<item>::iterator stack_iter = stack.begin();
+             stack_iter != stack.end() && quantity > 0;
              /* noop */ ) {
             if( stack_iter->use_amount( it, quantity, ret, filter ) ) {
-                stack_iter = iter->erase( stack_iter );
+                stack_iter = stack.erase( stack_iter );
             } else {
                 ++stack_iter;
             }
         }
-        if( iter->empty() ) {
-            binned = false;
-            items_type_cached = false;
+        if( stack.empty() ) {
             iter = items.erase( iter );
-        } else if( iter != items.end() ) {
+        } else {
             ++iter;
         }
     }
+    if( !ret.empty() ) {
+        invalidate_caches();
+    }
     return ret;
 }
 
@@ -901,7 +921,7 @@ int inventory::leak_level( const std::string &flag ) const
     int ret = 0;
 
     for( const auto &elem : items ) {
-        for( const auto &elem_stack_iter : elem ) {
+        for( const auto &elem_stack_iter : *elem ) {
             if( elem_stack_iter.has_flag( flag ) ) {
                 if( elem_stack_iter.has_flag( flag_LEAK_ALWAYS ) ) {
                     ret += elem_stack_iter.volume() / units::legacy_volume_factor;
@@ -918,7 +938,7 @@ int inventory::worst_item_value( npc *p ) const
 {
     int worst = 99999;
     for( const auto &elem : items ) {
-        const item &it = elem.front();
+        const item &it = elem->front();
         int val = p->value( it );
         if( val < worst ) {
             worst = val;
@@ -930,7 +950,7 @@ int inventory::worst_item_value( npc *p ) const
 bool inventory::has_enough_painkiller( int pain ) const
 {
     for( const auto &elem : items ) {
-        const item &it = elem.front();
+        const item &it = elem->front();
         if( ( pain <= 35 && it.typeId() == itype_aspirin ) ||
             ( pain >= 50 && it.typeId() == itype_oxycodone ) ||
             it.typeId() == itype_tramadol || it.typeId() == itype_codeine ) {
@@ -942,11 +962,13 @@ bool inventory::has_enough_painkiller( int pain ) const
 
 item *inventory::most_appropriate_painkiller( int pain )
 {
+    // The item may change type through the pointer
+    items_type_cached = false;
     int difference = 9999;
     item *ret = &null_item_reference();
     for( auto &elem : items ) {
         int diff = 9999;
-        itype_id type = elem.front().typeId();
+        itype_id type = elem->front().typeId();
         if( type == itype_aspirin ) {
             diff = std::abs( pain - 15 );
         } else if( type == itype_codeine ) {
@@ -961,7 +983,7 @@ item *inventory::most_appropriate_painkiller( int pain )
 
         if( diff < difference ) {
             difference = diff;
-            ret = &elem.front();
+            ret = &elem->front();
         }
     }
     return ret;
@@ -970,7 +992,7 @@ item *inventory::most_appropriate_painkiller( int pain )
 void inventory::rust_iron_items()
 {
     for( auto &elem : items ) {
-        for( auto &elem_stack_iter : elem ) {
+        for( auto &elem_stack_iter : *elem ) {
             if( elem_stack_iter.made_of( material_id( "iron" ) ) &&
                 !elem_stack_iter.has_flag( flag_WATERPROOF_GUN ) &&
                 !elem_stack_iter.has_flag( flag_WATERPROOF ) &&
@@ -998,7 +1020,7 @@ units::mass inventory::weight() const
 {
     units::mass ret = 0_gram;
     for( const auto &elem : items ) {
-        for( const auto &elem_stack_iter : elem ) {
+        for( const auto &elem_stack_iter : *elem ) {
             ret += elem_stack_iter.weight();
         }
     }
@@ -1017,7 +1039,7 @@ void for_each_item_in_both(
     }
 
     for( const auto &elem : items ) {
-        const item &representative = elem.front();
+        const item &representative = elem->front();
         auto other_it = other.find( &representative );
         if( other_it == other.end() ) {
             continue;
@@ -1029,7 +1051,7 @@ void for_each_item_in_both(
             copy.charges = std::min( copy.charges, num_to_count );
             f( copy );
         } else {
-            for( const auto &elem_stack_iter : elem ) {
+            for( const auto &elem_stack_iter : *elem ) {
                 f( elem_stack_iter );
                 if( --num_to_count <= 0 ) {
                     break;
@@ -1061,7 +1083,7 @@ units::volume inventory::volume() const
 {
     units::volume ret = 0_ml;
     for( const auto &elem : items ) {
-        for( const auto &elem_stack_iter : elem ) {
+        for( const auto &elem_stack_iter : *elem ) {
             ret += elem_stack_iter.volume();
         }
     }
@@ -1088,9 +1110,11 @@ units::volume inventory::volume_without( const excluded_stacks &without ) const
 
 std::vector<item *> inventory::active_items()
 {
+    // Processing the items may change their type
+    items_type_cached = false;
     std::vector<item *> ret;
-    for( std::list<item> &elem : items ) {
-        for( item &elem_stack_iter : elem ) {
+    for( auto &elem : items ) {
+        for( item &elem_stack_iter : *elem ) {
             if( elem_stack_iter.needs_processing() ) {
                 ret.push_back( &elem_stack_iter );
             }
@@ -1102,8 +1126,8 @@ std::vector<item *> inventory::active_items()
 enchantment inventory::get_active_enchantment_cache( const Character &owner ) const
 {
     enchantment temp_cache;
-    for( const std::list<item> &elem : items ) {
-        for( const item &check_item : elem ) {
+    for( const auto &elem : items ) {
+        for( const item &check_item : *elem ) {
             for( const enchantment &ench : check_item.get_enchantments() ) {
                 if( ench.is_active( owner, check_item ) ) {
                     temp_cache.force_add( ench );
@@ -1117,7 +1141,17 @@ enchantment inventory::get_active_enchantment_cache( const Character &owner ) co
 void inventory::update_quality_cache()
 {
     quality_cache.clear();
-    visit_items( [ this ]( const item * e ) {
+    for( const auto &elem : items ) {
+        for( const item &it : *elem ) {
+            add_to_quality_cache( it );
+        }
+    }
+    quality_cached = true;
+}
+
+void inventory::add_to_quality_cache( const item &it )
+{
+    it.visit_items( [ this ]( const item * e ) {
         const std::map<quality_id, int> &item_qualities = e->get_qualities();
         for( const std::pair<const quality_id, int> &quality : item_qualities ) {
             const int item_count = e->count_by_charges() ? e->charges : 1;
@@ -1192,7 +1226,7 @@ void inventory::assign_empty_invlet( item &it, const Character &p, const bool fo
     }
     // No free hotkey exist, re-use some of the existing ones
     for( auto &elem : items ) {
-        item &o = elem.front();
+        item &o = elem->front();
         if( o.invlet != 0 ) {
             it.invlet = o.invlet;
             o.invlet = 0;
@@ -1253,7 +1287,7 @@ void inventory::update_invlet( item &newit, bool assign_invlet )
 
 void inventory::set_stack_favorite( const int position, const bool favorite )
 {
-    for( auto &e : *std::next( items.begin(), position ) ) {
+    for( auto &e : *items[position] ) {
         e.set_favorite( favorite );
     }
 }
@@ -1263,7 +1297,7 @@ invlets_bitset inventory::allocated_invlets() const
     invlets_bitset invlets;
 
     for( const auto &stack : items ) {
-        const char invlet = stack.front().invlet;
+        const char invlet = stack->front().invlet;
         invlets.set( invlet );
     }
     invlets[0] = false;
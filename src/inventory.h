@@ -17,6 +17,7 @@
 
 #include "item.h"
 #include "units.h"
+#include "value_ptr.h"
 #include "visitable.h"
 
 class Character;
@@ -28,7 +29,8 @@ class npc;
 class player;
 struct tripoint;
 
-using invstack = std::list<std::list<item> >;
+/** Stacks of items, each allocated on its own so its items keep their address when stacks move. */
+using invstack = std::vector<cata::value_ptr<std::list<item>>>;
 using invslice = std::vector<std::list<item> *>;
 using const_invslice = std::vector<const std::list<item> *>;
 using indexed_invslice = std::vector< std::pair<std::list<item>*, int> >;
@@ -100,9 +102,9 @@ class inventory : public visitable<inventory>
 
         inventory();
         inventory( inventory && ) = default;
-        inventory( const inventory & ) = default;
+        inventory( const inventory &other );
         inventory &operator=( inventory && ) = default;
-        inventory &operator=( const inventory & ) = default;
+        inventory &operator=( const inventory &other );
 
         inventory &operator+= ( const inventory &rhs );
         inventory &operator+= ( const item &rhs );
@@ -119,7 +121,7 @@ class inventory : public visitable<inventory>
         // returns a reference to the added item
         item &add_item( item newit, bool keep_invlet = false, bool assign_invlet = true,
                         bool should_stack = true );
-        // use item type cache to speed up, remember to run build_items_type_cache() before using it
+        // same as add_item, kept for callers that used to build the items type cache first
         item &add_item_by_items_type_cache( item newit, bool keep_invlet = false, bool assign_invlet = true,
                                             bool should_stack = true );
         void add_item_keep_invlet( item newit );
@@ -238,6 +240,10 @@ class inventory : public visitable<inventory>
 
         int count_item( const itype_id &item_type ) const;
 
+        /**
+         * Counts the items of every quality level. Items added afterwards are counted in as
+         * they come, removing items clears the counts.
+         */
         void update_quality_cache();
         const std::map<quality_id, std::map<int, int>> &get_quality_cache() const;
 
@@ -247,11 +253,22 @@ class inventory : public visitable<inventory>
         invlet_favorites invlet_cache;
         char find_usable_cached_invlet( const itype_id &item_type );
 
+        /** Forgets the caches that can't follow removals or changes to the items. */
+        void invalidate_caches();
+        void sort_stacks();
+        void add_to_quality_cache( const item &it );
+
         invstack items;
-        std::map<itype_id, std::list<std::list<item>*>> items_type_cache;
+        /**
+         * Stacks by the type of their items, in the order of @ref items. Built on the first
+         * addition after it was invalidated and kept up to date by later additions. Every
+         * non-const access to the items invalidates it, as items may change type through it.
+         */
+        std::unordered_map<itype_id, std::vector<std::list<item> *>> items_type_cache;
         std::map<quality_id, std::map<int, int>> quality_cache;
 
         bool items_type_cached = false;
+        bool quality_cached = false;
         mutable bool binned = false;
         /**
          * Items binned by their type.
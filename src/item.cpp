@@ -101,7 +101,6 @@
 #include "vitamin.h"
 #include "vpart_position.h"
 #include "weather.h"
-#include "weather_gen.h"
 
 static const std::string GUN_MODE_VAR_NAME( "item::mode" );
 static const std::string CLOTHING_MOD_VAR_PREFIX( "clothing_mod_" );
@@ -5302,31 +5301,33 @@ bool item::has_own_flag( const std::string &f ) const
 
 bool item::has_flag( const std::string &f ) const
 {
-    bool ret = false;
+    return has_flag( flag_str_id( f ) );
+}
+
+bool item::has_flag( const flag_str_id &flag ) const
+{
+    if( !flag.is_valid() ) {
+        // Undefined flags are dropped from item types once they are finalized
+        return type->has_flag( flag ) || has_own_flag( flag.str() );
+    }
+    const flag_id id = flag.id();
 
-    if( json_flag::get( f ).inherit() ) {
+    if( !contents.empty() && id->inherit() ) {
         for( const item *e : is_gun() ? gunmods() : toolmods() ) {
             // gunmods fired separately do not contribute to base gun flags
-            if( !e->is_gun() && e->has_flag( f ) ) {
+            if( !e->is_gun() && e->has_flag( flag ) ) {
                 return true;
             }
         }
     }
 
     // other item type flags
-    ret = type->has_flag( f );
-    if( ret ) {
-        return ret;
+    if( type->has_flag( id ) ) {
+        return true;
     }
 
     // now check for item specific flags
-    ret = has_own_flag( f );
-    return ret;
-}
-
-bool item::has_flag( const flag_str_id &flag ) const
-{
-    return has_flag( flag.str() );
+    return has_own_flag( flag.str() );
 }
 
 item &item::set_flag( const std::string &flag )
@@ -9002,8 +9003,6 @@ bool item::process_rot( const bool seals, const tripoint &pos,
     if( now - time > 1_hours ) {
         // This code is for items that were left out of reality bubble for long time
 
-        const weather_generator &wgen = weather.get_cur_weather_gen();
-        const unsigned int seed = g->get_seed();
         // It's a modifier, so we need to subtract 0_f
         units::temperature local_mod = units::from_fahrenheit( g->new_game
                                        ? 0
@@ -9019,8 +9018,8 @@ bool item::process_rot( const bool seals, const tripoint &pos,
             units::temperature env_temperature_raw;
             if( pos.z >= 0 ) {
                 tripoint_abs_ms location = tripoint_abs_ms( get_map().getabs( pos ) );
-                units::temperature weather_temperature = wgen.get_weather_temperature( location, time,
-                        calendar::config, seed );
+                units::temperature weather_temperature = weather.get_hourly_weather_temperature( location,
+                        time );
                 env_temperature_raw = weather_temperature + local_mod;
             } else {
                 env_temperature_raw = units::from_fahrenheit( AVERAGE_ANNUAL_TEMPERATURE ) + local_mod;
@@ -591,6 +591,11 @@ void Item_factory::finalize_post( itype &obj )
             return false;
         }
     } );
+    obj.item_tag_bits.clear();
+    for( const std::string &f : obj.item_tags ) {
+        obj.item_tag_bits.set( flag_str_id( f ).id().to_i() );
+    }
+    obj.item_tag_bits_ready = true;
 
     // handle complex firearms as a special case
     if( obj.gun && !obj.has_flag( "PRIMITIVE_RANGED_WEAPON" ) ) {
@@ -145,12 +145,23 @@ bool itype::has_use() const
 
 bool itype::has_flag( const std::string &flag ) const
 {
-    return item_tags.count( flag );
+    return has_flag( flag_str_id( flag ) );
 }
 
 bool itype::has_flag( const flag_str_id &flag ) const
 {
-    return item_tags.count( flag.str() );
+    if( !item_tag_bits_ready ) {
+        return item_tags.count( flag.str() );
+    }
+    return flag.is_valid() && item_tag_bits.test( flag.id().to_i() );
+}
+
+bool itype::has_flag( const flag_id &flag ) const
+{
+    if( !item_tag_bits_ready ) {
+        return flag.is_valid() && item_tags.count( flag.id().str() );
+    }
+    return item_tag_bits.test( flag.to_i() );
 }
 
 const itype::FlagsSetType &itype::get_flags() const
@@ -18,6 +18,7 @@
 #include "damage.h"
 #include "enums.h" // point
 #include "explosion.h"
+#include "flag_bitset.h"
 #include "game_constants.h"
 #include "iuse.h" // use_function
 #include "pldata.h" // add_type
@@ -1033,6 +1034,9 @@ struct itype {
         float solar_efficiency = 0;
 
         FlagsSetType item_tags;
+        /** @ref item_tags by flag id, filled in once the flags were checked in finalization */
+        flag_bitset item_tag_bits;
+        bool item_tag_bits_ready = false;
 
         std::string get_item_type_string() const;
 
@@ -1066,6 +1070,7 @@ struct itype {
         // TODO: Remove the string version
         bool has_flag( const std::string &flag ) const;
         bool has_flag( const flag_str_id &flag ) const;
+        bool has_flag( const flag_id &flag ) const;
 
         // returns read-only set of all item tags/flags
         const FlagsSetType &get_flags() const;
@@ -13,6 +13,7 @@
 #include <locale> // ensure user's locale doesn't interfere with output
 #include <set>
 #include <sstream>
+#include <streambuf>
 #include <string>
 #include <utility>
 #include <vector>
@@ -793,12 +794,138 @@ void add_array_to_set( std::set<std::string> &s, const JsonObject &json, const s
     }
 }
 
+namespace
+{
+
+// Read-only stream buffer over memory owned by the caller
+class json_memory_buf : public std::streambuf
+{
+    public:
+        explicit json_memory_buf( std::string_view data ) {
+            // The buffer is never written through, setg just wants non-const pointers
+            char *begin = const_cast<char *>( data.data() );
+            setg( begin, begin, begin + data.size() );
+        }
+
+        const char *cur() const {
+            return gptr();
+        }
+        bool at_start() const {
+            return gptr() == eback();
+        }
+        const char *end() const {
+            return egptr();
+        }
+        void advance( std::ptrdiff_t count ) {
+            setg( eback(), gptr() + count, egptr() );
+        }
+
+    protected:
+        pos_type seekoff( off_type off, std::ios_base::seekdir dir,
+                          std::ios_base::openmode which ) override {
+            if( !( which & std::ios_base::in ) ) {
+                return pos_type( off_type( -1 ) );
+            }
+            off_type target = off;
+            if( dir == std::ios_base::cur ) {
+                target += gptr() - eback();
+            } else if( dir == std::ios_base::end ) {
+                target += egptr() - eback();
+            }
+            if( target < 0 || target > egptr() - eback() ) {
+                return pos_type( off_type( -1 ) );
+            }
+            setg( eback(), eback() + target, egptr() );
+            return pos_type( target );
+        }
+        pos_type seekpos( pos_type pos, std::ios_base::openmode which ) override {
+            return seekoff( off_type( pos ), std::ios_base::beg, which );
+        }
+};
+
+} // namespace
+
+struct JsonIn::memory_source {
+    json_memory_buf buf;
+    std::istream stream;
+
+    explicit memory_source( std::string_view data ) : buf( data ), stream( &buf ) {}
+};
+
+JsonIn::JsonIn( std::istream &s ) : stream( &s ) {}
+
+JsonIn::JsonIn( std::istream &s, const std::string &path )
+    : stream( &s ), path( make_shared_fast<std::string>( path ) ) {}
+
+JsonIn::JsonIn( std::istream &s, const json_source_location &loc )
+    : stream( &s ), path( loc.path )
+{
+    seek( loc.offset );
+}
+
+JsonIn::JsonIn( std::string_view data )
+    : memory( std::make_unique<memory_source>( data ) )
+{
+    stream = &memory->stream;
+}
+
+JsonIn::JsonIn( std::string_view data, const std::string &path )
+    : memory( std::make_unique<memory_source>( data ) ),
+      path( make_shared_fast<std::string>( path ) )
+{
+    stream = &memory->stream;
+}
+
+JsonIn::~JsonIn() = default;
+
+// The fast paths below only run while the stream is good and has data left, anything
+// else goes through the stream so its state flags end up the same as before
+void JsonIn::get_char( char &ch )
+{
+    if( memory && stream->good() && memory->buf.cur() != memory->buf.end() ) {
+        ch = *memory->buf.cur();
+        memory->buf.advance( 1 );
+    } else if( !stream->get( ch ) ) {
+        // Past the end, don't leave the last character in ch or numbers never end
+        ch = '\0';
+    }
+}
+
+void JsonIn::unget_char()
+{
+    if( memory && stream->good() && !memory->buf.at_start() ) {
+        memory->buf.advance( -1 );
+    } else {
+        stream->unget();
+    }
+}
+
+// Consumes the characters accepted by accept in one go, returns them
+template<typename Accept>
+std::string_view JsonIn::take_run( Accept accept )
+{
+    if( !memory || !stream->good() ) {
+        return std::string_view();
+    }
+    json_memory_buf &buf = memory->buf;
+    const char *begin = buf.cur();
+    const char *end = begin;
+    while( end != buf.end() && accept( *end ) ) {
+        ++end;
+    }
+    buf.advance( end - begin );
+    return std::string_view( begin, end - begin );
+}
+
 int JsonIn::tell()
 {
     return stream->tellg();
 }
 char JsonIn::peek()
 {
+    if( memory && stream->good() && memory->buf.cur() != memory->buf.end() ) {
+        return *memory->buf.cur();
+    }
     return static_cast<char>( stream->peek() );
 }
 bool JsonIn::good()
@@ -815,6 +942,7 @@ void JsonIn::seek( int pos )
 
 void JsonIn::eat_whitespace()
 {
+    take_run( is_whitespace );
     while( is_whitespace( peek() ) ) {
         stream->get();
     }
@@ -880,7 +1008,7 @@ void JsonIn::skip_pair_separator()
 {
     char ch;
     eat_whitespace();
-    stream->get( ch );
+    get_char( ch );
     if( ch != ':' ) {
         std::stringstream err;
         err << "expected pair separator ':', not '" << ch << "'";
@@ -895,16 +1023,19 @@ void JsonIn::skip_string()
 {
     char ch;
     eat_whitespace();
-    stream->get( ch );
+    get_char( ch );
     if( ch != '"' ) {
         std::stringstream err;
         err << "expecting string but found '" << ch << "'";
         error( err.str(), -1 );
     }
     while( stream->good() ) {
-        stream->get( ch );
+        take_run( []( char c ) {
+            return c != '\\' && c != '"' && c != '\r' && c != '\n';
+        } );
+        get_char( ch );
         if( ch == '\\' ) {
-            stream->get( ch );
+            get_char( ch );
             continue;
         } else if( ch == '"' ) {
             break;
@@ -1009,11 +1140,14 @@ void JsonIn::skip_number()
     char ch;
     eat_whitespace();
     // skip all of (+-0123456789.eE)
+    take_run( []( char c ) {
+        return c == '+' || c == '-' || ( c >= '0' && c <= '9' ) || c == 'e' || c == 'E' || c == '.';
+    } );
     while( stream->good() ) {
-        stream->get( ch );
+        get_char( ch );
         if( ch != '+' && ch != '-' && ( ch < '0' || ch > '9' ) &&
             ch != 'e' && ch != 'E' && ch != '.' ) {
-            stream->unget();
+            unget_char();
             break;
         }
     }
@@ -1170,7 +1304,7 @@ std::string JsonIn::get_string()
     bool success = false;
     do {
         // the first character had better be a '"'
-        stream->get( ch );
+        get_char( ch );
         if( !stream->good() ) {
             err = "read operation failed";
             break;
@@ -1181,13 +1315,17 @@ std::string JsonIn::get_string()
         }
         // add chars to the string, one at a time
         do {
-            ch = stream->peek();
+            // runs of plain ascii are copied at once when reading from memory
+            s += take_run( []( char c ) {
+                return c != '"' && c != '\\' && c >= 0x20 && c < 0x7f;
+            } );
+            ch = peek();
             if( !stream->good() ) {
                 err = "read operation failed";
                 break;
             }
             if( ch == '"' ) {
-                stream->ignore();
+                get_char( ch );
                 success = true;
                 break;
             }
@@ -1342,9 +1480,9 @@ number_sci_notation JsonIn::get_any_number()
     number_sci_notation ret;
     int mod_e = 0;
     eat_whitespace();
-    stream->get( ch );
+    get_char( ch );
     if( ( ret.negative = ch == '-' ) ) {
-        stream->get( ch );
+        get_char( ch );
     } else if( ch != '.' && ( ch < '0' || ch > '9' ) ) {
         // not a valid float
         std::stringstream err;
@@ -1353,7 +1491,7 @@ number_sci_notation JsonIn::get_any_number()
     }
     if( ch == '0' ) {
         // allow a single leading zero in front of a '.' or 'e'/'E'
-        stream->get( ch );
+        get_char( ch );
         if( ch >= '0' && ch <= '9' ) {
             error( "leading zeros not allowed", -1 );
         }
@@ -1361,36 +1499,36 @@ number_sci_notation JsonIn::get_any_number()
     while( ch >= '0' && ch <= '9' ) {
         ret.number *= 10;
         ret.number += ( ch - '0' );
-        stream->get( ch );
+        get_char( ch );
     }
     if( ch == '.' ) {
-        stream->get( ch );
+        get_char( ch );
         while( ch >= '0' && ch <= '9' ) {
             ret.number *= 10;
             ret.number += ( ch - '0' );
             mod_e -= 1;
-            stream->get( ch );
+            get_char( ch );
         }
     }
     if( ch == 'e' || ch == 'E' ) {
-        stream->get( ch );
+        get_char( ch );
         bool neg;
         if( ( neg = ch == '-' ) ) {
-            stream->get( ch );
+            get_char( ch );
         } else if( ch == '+' ) {
-            stream->get( ch );
+            get_char( ch );
         }
         while( ch >= '0' && ch <= '9' ) {
             ret.exp *= 10;
             ret.exp += ( ch - '0' );
-            stream->get( ch );
+            get_char( ch );
         }
         if( neg ) {
             ret.exp *= -1;
         }
     }
     // unget the final non-number character (probably a separator)
-    stream->unget();
+    unget_char();
     end_value();
     ret.exp += mod_e;
     return ret;
@@ -1402,7 +1540,7 @@ bool JsonIn::get_bool()
     char text[5];
     std::stringstream err;
     eat_whitespace();
-    stream->get( ch );
+    get_char( ch );
     if( ch == 't' ) {
         stream->get( text, 4 );
         if( strcmp( text, "rue" ) == 0 ) {
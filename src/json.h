@@ -8,9 +8,11 @@
 #include <cstdint>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -171,7 +173,11 @@ struct number_sci_notation {
 class JsonIn
 {
     private:
+        struct memory_source;
+
         std::istream *stream;
+        // Set when reading straight from memory, see the string_view constructor
+        std::unique_ptr<memory_source> memory;
         shared_ptr_fast<std::string> path;
         bool ate_separator = false;
 
@@ -179,14 +185,24 @@ class JsonIn
         void skip_pair_separator();
         void end_value();
 
+        // Character access that bypasses the stream while reading from memory
+        void get_char( char &ch );
+        void unget_char();
+        template<typename Accept>
+        std::string_view take_run( Accept accept );
+
     public:
-        JsonIn( std::istream &s ) : stream( &s ) {}
-        JsonIn( std::istream &s, const std::string &path )
-            : stream( &s ), path( make_shared_fast<std::string>( path ) ) {}
-        JsonIn( std::istream &s, const json_source_location &loc )
-            : stream( &s ), path( loc.path ) {
-            seek( loc.offset );
-        }
+        JsonIn( std::istream &s );
+        JsonIn( std::istream &s, const std::string &path );
+        JsonIn( std::istream &s, const json_source_location &loc );
+        /**
+         * Reads from a buffer in memory without copying it, the buffer must outlive
+         * this object. Skips the per-character stream calls, otherwise behaves the same
+         * as reading the buffer through a std::istringstream.
+         */
+        explicit JsonIn( std::string_view data );
+        JsonIn( std::string_view data, const std::string &path );
+        ~JsonIn();
         JsonIn( const JsonIn & ) = delete;
         JsonIn &operator=( const JsonIn & ) = delete;
 
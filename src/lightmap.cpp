@@ -1,11 +1,14 @@
 #include "lightmap.h" // IWYU pragma: associated
 #include "shadowcasting.h" // IWYU pragma: associated
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <iterator>
 #include <memory>
 #include <optional>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -17,6 +20,7 @@
 #include "colony.h"
 #include "cuboid_rectangle.h"
 #include "field.h"
+#include "fov_bitmap.h"
 #include "fragment_cloud.h" // IWYU pragma: keep
 #include "game.h"
 #include "int_id.h"
@@ -34,6 +38,7 @@
 #include "point.h"
 #include "string_formatter.h"
 #include "submap.h"
+#include "thread_pool.h"
 #include "tileray.h"
 #include "type_id.h"
 #include "veh_type.h"
@@ -112,6 +117,7 @@ bool map::build_transparency_cache( const int zlev )
     }
 
     std::set<tripoint> vehicles_processed;
+    const int generation = ++transparency_generation;
 
     // if true, all submaps are invalid (can use batch init)
     bool rebuild_all = map_cache.transparency_cache_dirty.all();
@@ -139,6 +145,7 @@ bool map::build_transparency_cache( const int zlev )
             if( !rebuild_all && !map_cache.transparency_cache_dirty[smx * MAPSIZE + smy] ) {
                 continue;
             }
+            map_cache.transparency_changed_at[smx * MAPSIZE + smy] = generation;
 
             // calculates transparency of a single tile
             // x,y - coords in map local coords
@@ -538,6 +545,12 @@ void map::generate_lightmap( const int zlev )
         }
     }
 
+    // Everything so far is cheap to redo every time. The casts below are collected instead of
+    // applied, so that apply_light_casts() can skip the ones that would not change anything.
+    std::vector<light_cast> casts;
+    lightmap_hist->recording = &casts;
+    lightmap_hist->recording_zlev = zlev;
+
     for( monster &critter : g->all_monsters() ) {
         if( critter.is_hallucination() ) {
             continue;
@@ -640,9 +653,275 @@ void map::generate_lightmap( const int zlev )
             apply_light_source( p, light_source_buffer[p.x][p.y] );
         }
     }
+    lightmap_hist->recording = nullptr;
+
+    std::vector<std::pair<point, float>> overrides;
+    overrides.reserve( lm_override.size() );
     for( const std::pair<tripoint, float> &elem : lm_override ) {
+        overrides.emplace_back( elem.first.xy(), elem.second );
+    }
+    apply_light_casts( zlev, casts, overrides );
+}
+
+int light_cast::radius() const
+{
+    if( type == kind::arc ) {
+        // Rays end at the light range, give or take rounding of the end points
+        return LIGHT_RANGE( luminance ) + 2;
+    }
+    if( luminance <= lit_level::LOW ) {
+        return 0;
+    }
+    // Shadowcasting stops at the first row where the light drops to LIGHT_AMBIENT_LOW,
+    // which happens before luminance / distance does. The margin covers fastexp() errors.
+    const float cast_luminance = luminance <= lit_level::BRIGHT_ONLY ? 1.49f : luminance;
+    return std::min( 60, static_cast<int>( cast_luminance * 1.25f / LIGHT_AMBIENT_LOW ) + 2 );
+}
+
+bool light_cast::operator==( const light_cast &rhs ) const
+{
+    return type == rhs.type && p == rhs.p && luminance == rhs.luminance &&
+           directions == rhs.directions && angle == rhs.angle && wideangle == rhs.wideangle;
+}
+
+bool light_cast::operator<( const light_cast &rhs ) const
+{
+    return std::tie( type, p, luminance, directions, angle, wideangle ) <
+           std::tie( rhs.type, rhs.p, rhs.luminance, rhs.directions, rhs.angle, rhs.wideangle );
+}
+
+namespace
+{
+
+// Marked tiles of the lightmap, with a summed-area table to check rectangles for marks quickly
+class lightmap_tile_mask
+{
+    public:
+        lightmap_tile_mask() : marks( MAPSIZE_X * MAPSIZE_Y, 0 ), sums( ( MAPSIZE_X + 1 ) * ( MAPSIZE_Y + 1 ), 0 ) {}
+
+        void mark( const point &p ) {
+            marks[p.x * MAPSIZE_Y + p.y] = 1;
+            any_marked = true;
+        }
+
+        void mark_square( const point &center, int radius ) {
+            const int min_x = std::max( center.x - radius, 0 );
+            const int max_x = std::min( center.x + radius, MAPSIZE_X - 1 );
+            const int min_y = std::max( center.y - radius, 0 );
+            const int max_y = std::min( center.y + radius, MAPSIZE_Y - 1 );
+            for( int x = min_x; x <= max_x; x++ ) {
+                std::fill( marks.begin() + x * MAPSIZE_Y + min_y, marks.begin() + x * MAPSIZE_Y + max_y + 1, 1 );
+            }
+            any_marked = any_marked || ( min_x <= max_x && min_y <= max_y );
+        }
+
+        bool is_marked( const point &p ) const {
+            return marks[p.x * MAPSIZE_Y + p.y] != 0;
+        }
+
+        bool empty() const {
+            return !any_marked;
+        }
+
+        // Call after marking and before checking squares
+        void sum_up() {
+            for( int x = 0; x < MAPSIZE_X; x++ ) {
+                for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                    sums[( x + 1 ) * ( MAPSIZE_Y + 1 ) + y + 1] = marks[x * MAPSIZE_Y + y] +
+                            sums[x * ( MAPSIZE_Y + 1 ) + y + 1] + sums[( x + 1 ) * ( MAPSIZE_Y + 1 ) + y] -
+                            sums[x * ( MAPSIZE_Y + 1 ) + y];
+                }
+            }
+        }
+
+        bool square_has_mark( const point &center, int radius ) const {
+            const int min_x = std::max( center.x - radius, 0 );
+            const int max_x = std::min( center.x + radius, MAPSIZE_X - 1 ) + 1;
+            const int min_y = std::max( center.y - radius, 0 );
+            const int max_y = std::min( center.y + radius, MAPSIZE_Y - 1 ) + 1;
+            if( min_x >= max_x || min_y >= max_y ) {
+                return false;
+            }
+            return sums[max_x * ( MAPSIZE_Y + 1 ) + max_y] - sums[min_x * ( MAPSIZE_Y + 1 ) + max_y] -
+                   sums[max_x * ( MAPSIZE_Y + 1 ) + min_y] + sums[min_x * ( MAPSIZE_Y + 1 ) + min_y] > 0;
+        }
+
+    private:
+        std::vector<char> marks;
+        std::vector<int> sums;
+        bool any_marked = false;
+};
+
+} // namespace
+
+void map::apply_light_casts_parallel( const std::vector<const light_cast *> &to_cast,
+                                      four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                                      float( &sm )[MAPSIZE_X][MAPSIZE_Y] )
+{
+    // Below this many casts per thread, clearing and merging the buffers costs more than it saves
+    constexpr int min_casts_per_worker = 4;
+    const int workers = std::min( cata::parallel_for_threads(),
+                                  static_cast<int>( to_cast.size() ) / min_casts_per_worker );
+    if( workers <= 1 ) {
+        for( const light_cast *cast : to_cast ) {
+            apply_light_cast( *cast, lm, sm );
+        }
+        return;
+    }
+
+    std::vector<std::unique_ptr<light_cast_buffer>> &buffers = lightmap_hist->buffers;
+    while( static_cast<int>( buffers.size() ) < workers ) {
+        buffers.push_back( std::make_unique<light_cast_buffer>() );
+        std::fill_n( &buffers.back()->lm[0][0], MAPSIZE_X * MAPSIZE_Y, four_quadrants( 0.0f ) );
+        std::fill_n( &buffers.back()->sm[0][0], MAPSIZE_X * MAPSIZE_Y, 0.0f );
+    }
+
+    // Each worker casts its share of the lights into its own buffer...
+    cata::parallel_for( workers, [&]( int worker ) {
+        light_cast_buffer &buffer = *buffers[worker];
+        for( size_t i = worker; i < to_cast.size(); i += workers ) {
+            const light_cast &cast = *to_cast[i];
+            const int radius = cast.radius();
+            buffer.min_x = std::min( buffer.min_x, std::max( cast.p.x - radius, 0 ) );
+            buffer.max_x = std::max( buffer.max_x, std::min( cast.p.x + radius, MAPSIZE_X - 1 ) );
+            apply_light_cast( cast, buffer.lm, buffer.sm );
+        }
+    } );
+
+    // ...and the buffers are merged column by column. Taking the maximum gives the same result
+    // in any order, so this matches casting the lights one after another.
+    int min_x = MAPSIZE_X;
+    int max_x = -1;
+    for( int worker = 0; worker < workers; worker++ ) {
+        min_x = std::min( min_x, buffers[worker]->min_x );
+        max_x = std::max( max_x, buffers[worker]->max_x );
+    }
+    cata::parallel_for( max_x - min_x + 1, [&]( int column ) {
+        const int x = min_x + column;
+        for( int worker = 0; worker < workers; worker++ ) {
+            light_cast_buffer &buffer = *buffers[worker];
+            if( x < buffer.min_x || x > buffer.max_x ) {
+                continue;
+            }
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                lm[x][y] = elementwise_max( lm[x][y], buffer.lm[x][y] );
+                sm[x][y] = std::max( sm[x][y], buffer.sm[x][y] );
+                buffer.lm[x][y].fill( 0.0f );
+                buffer.sm[x][y] = 0.0f;
+            }
+        }
+    } );
+    for( int worker = 0; worker < workers; worker++ ) {
+        buffers[worker]->min_x = MAPSIZE_X;
+        buffers[worker]->max_x = -1;
+    }
+}
+
+void map::invalidate_lightmap_history()
+{
+    lightmap_hist->valid = false;
+}
+
+void map::apply_light_casts( const int zlev, std::vector<light_cast> &casts,
+                             std::vector<std::pair<point, float>> &overrides )
+{
+    level_cache &map_cache = get_cache( zlev );
+    auto &lm = map_cache.lm;
+    auto &sm = map_cache.sm;
+    lightmap_history &hist = *lightmap_hist;
+
+    std::sort( casts.begin(), casts.end() );
+    std::sort( overrides.begin(), overrides.end() );
+
+    const bool reuse = hist.valid && hist.zlev == zlev && hist.abs_sub == abs_sub &&
+                       hist.trigdist == trigdist &&
+                       hist.weather_transparency == weather_transparency_lookup.transparency;
+
+    // Tiles that have to be worked out again, and any cast reaching them has to be applied again
+    lightmap_tile_mask recast;
+    if( reuse ) {
+        // Tiles where the casts may now reach further or less far
+        lightmap_tile_mask obstacles_changed;
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                if( lm[x][y].values != hist.base_lm[x][y].values || sm[x][y] != hist.base_sm[x][y] ) {
+                    recast.mark( point( x, y ) );
+                }
+                if( map_cache.transparency_cache[x][y] != hist.transparency_cache[x][y] ||
+                    map_cache.vehicle_obscured_cache[x][y].nw != hist.vehicle_obscured_cache[x][y].nw ||
+                    map_cache.vehicle_obscured_cache[x][y].ne != hist.vehicle_obscured_cache[x][y].ne ) {
+                    obstacles_changed.mark( point( x, y ) );
+                }
+            }
+        }
+
+        // Lights that appeared or went away
+        std::vector<light_cast> changed_casts;
+        std::set_symmetric_difference( casts.begin(), casts.end(), hist.casts.begin(), hist.casts.end(),
+                                       std::back_inserter( changed_casts ) );
+        for( const light_cast &cast : changed_casts ) {
+            recast.mark_square( cast.p.xy(), cast.radius() );
+        }
+        std::vector<std::pair<point, float>> changed_overrides;
+        std::set_symmetric_difference( overrides.begin(), overrides.end(), hist.overrides.begin(),
+                                       hist.overrides.end(), std::back_inserter( changed_overrides ) );
+        for( const std::pair<point, float> &elem : changed_overrides ) {
+            recast.mark( elem.first );
+        }
+
+        // Lights that now pass through different tiles
+        if( !obstacles_changed.empty() ) {
+            obstacles_changed.sum_up();
+            for( const light_cast &cast : casts ) {
+                if( obstacles_changed.square_has_mark( cast.p.xy(), cast.radius() ) ) {
+                    recast.mark_square( cast.p.xy(), cast.radius() );
+                }
+            }
+        }
+        recast.sum_up();
+    }
+
+    std::copy( &lm[0][0], &lm[0][0] + MAPSIZE_X * MAPSIZE_Y, &hist.base_lm[0][0] );
+    std::copy( &sm[0][0], &sm[0][0] + MAPSIZE_X * MAPSIZE_Y, &hist.base_sm[0][0] );
+
+    if( reuse ) {
+        // Everywhere else the previous lightmap is still right
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                if( !recast.is_marked( point( x, y ) ) ) {
+                    lm[x][y] = hist.lm[x][y];
+                    sm[x][y] = hist.sm[x][y];
+                }
+            }
+        }
+    }
+    // Casts only ever raise the light level, so applying one again where it was
+    // already applied leaves those tiles as they are
+    std::vector<const light_cast *> to_cast;
+    for( const light_cast &cast : casts ) {
+        if( !reuse || ( !recast.empty() && recast.square_has_mark( cast.p.xy(), cast.radius() ) ) ) {
+            to_cast.push_back( &cast );
+        }
+    }
+    apply_light_casts_parallel( to_cast, lm, sm );
+    for( const std::pair<point, float> &elem : overrides ) {
         lm[elem.first.x][elem.first.y].fill( elem.second );
     }
+
+    std::copy( &lm[0][0], &lm[0][0] + MAPSIZE_X * MAPSIZE_Y, &hist.lm[0][0] );
+    std::copy( &sm[0][0], &sm[0][0] + MAPSIZE_X * MAPSIZE_Y, &hist.sm[0][0] );
+    std::copy( &map_cache.transparency_cache[0][0],
+               &map_cache.transparency_cache[0][0] + MAPSIZE_X * MAPSIZE_Y, &hist.transparency_cache[0][0] );
+    std::copy( &map_cache.vehicle_obscured_cache[0][0],
+               &map_cache.vehicle_obscured_cache[0][0] + MAPSIZE_X * MAPSIZE_Y,
+               &hist.vehicle_obscured_cache[0][0] );
+    hist.casts = std::move( casts );
+    hist.overrides = std::move( overrides );
+    hist.valid = true;
+    hist.zlev = zlev;
+    hist.abs_sub = abs_sub;
+    hist.trigdist = trigdist;
+    hist.weather_transparency = weather_transparency_lookup.transparency;
 }
 
 void map::add_light_source( const tripoint &p, float luminance )
@@ -869,6 +1148,61 @@ static inline int fast_rl_dist( tripoint to )
     return a;
 }
 
+shadowcasting_kernel shadowcasting_kernel_in_use = shadowcasting_kernel::row_span;
+
+namespace
+{
+
+// Distances from the origin to the tiles of a shadowcasting row, as used by castLight()
+struct row_distance_tables {
+    static constexpr int size = 61;
+    // fast_rl_dist<21, 4>() and rl_dist() with trigdist, by row and absolute column
+    int fast_trig[size][size];
+    int trig[size][size];
+
+    row_distance_tables() {
+        for( int row = 0; row < size; row++ ) {
+            for( int column = 0; column < size; column++ ) {
+                int val = row * row + column * column;
+                if( val >= 2 ) {
+                    int a = 21;
+                    for( int i = 0; i < 4; i++ ) {
+                        a = ( a + val / a ) / 2;
+                    }
+                    val = a;
+                }
+                fast_trig[row][column] = val;
+                trig[row][column] = trig_dist( tripoint_zero, tripoint( column, row, 0 ) );
+            }
+        }
+    }
+};
+
+const row_distance_tables &get_row_distance_tables()
+{
+    static const row_distance_tables tables;
+    return tables;
+}
+
+// Narrows [first, last] to the offsets along a row that land on the map.
+// The tile at offset i of the row is start + step * i on one axis of a map with the given size.
+void clip_row_span( int start, int step, int map_size, int &first, int &last )
+{
+    if( step == 0 ) {
+        if( start < 0 || start >= map_size ) {
+            last = first - 1;
+        }
+    } else if( step > 0 ) {
+        first = std::max( first, -start );
+        last = std::min( last, map_size - 1 - start );
+    } else {
+        first = std::max( first, start - ( map_size - 1 ) );
+        last = std::min( last, start );
+    }
+}
+
+} // namespace
+
 // For a direction vector defined by x, y, return the quadrant that's the
 // source of that direction.  Assumes x != 0 && y != 0
 // NOLINTNEXTLINE(cata-xy)
@@ -939,6 +1273,7 @@ void cast_zlight_segment(
     };
 
     int radius = 60 - offset_distance;
+    const bool row_spans = shadowcasting_kernel_in_use == shadowcasting_kernel::row_span;
 
     constexpr int min_z = -OVERMAP_DEPTH;
     constexpr int max_z = OVERMAP_HEIGHT;
@@ -950,6 +1285,9 @@ void cast_zlight_segment(
         bool started_block = false;
         T current_transparency = 0.0f;
         bool current_floor = false;
+        // calc() only changes with the distance within a row
+        int calc_dist = -1;
+        T calc_intensity = 0.0f;
 
         int z_start = z_skip != -1 ? z_skip : std::max( 0,
                       static_cast<int>( std::ceil( ( ( distance - 0.5f ) * start_major ) - 0.5f ) ) );
@@ -970,8 +1308,13 @@ void cast_zlight_segment(
 
             int x_limit = std::min( distance,
                                     static_cast<int>( std::ceil( ( ( distance + 0.5f ) * end_minor ) + 0.5f ) ) - 1 );
+            int x_first = x_start;
+            if( row_spans ) {
+                clip_row_span( offset.x + delta.y * xy + delta.z * xz, xx, MAPSIZE_X, x_first, x_limit );
+                clip_row_span( offset.y + delta.y * yy + delta.z * yz, yx, MAPSIZE_Y, x_first, x_limit );
+            }
 
-            for( delta.x = x_start; delta.x <= x_limit; delta.x++ ) {
+            for( delta.x = x_first; delta.x <= x_limit; delta.x++ ) {
                 current.x = offset.x + delta.x * xx + delta.y * xy + delta.z * xz;
                 current.y = offset.y + delta.x * yx + delta.y * yy + delta.z * yz;
 
@@ -1004,7 +1347,11 @@ void cast_zlight_segment(
                 }
 
                 const int dist = rl_dist( tripoint_zero, delta ) + offset_distance;
-                T last_intensity = calc( numerator, cumulative_transparency, dist );
+                if( !row_spans || dist != calc_dist ) {
+                    calc_intensity = calc( numerator, cumulative_transparency, dist );
+                    calc_dist = dist;
+                }
+                T last_intensity = calc_intensity;
                 ( *output_caches[z_index] )[current.x][current.y] =
                     std::max( ( *output_caches[z_index] )[current.x][current.y], last_intensity );
 
@@ -1242,6 +1589,8 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
     if( start < end ) {
         return;
     }
+    const bool row_spans = shadowcasting_kernel_in_use == shadowcasting_kernel::row_span;
+    const row_distance_tables &distances = get_row_distance_tables();
     T last_intensity = 0.0;
     tripoint delta;
     for( int distance = row; distance <= radius; distance++ ) {
@@ -1256,11 +1605,16 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
         int x_limit = std::floor( std::min( 0.0f,
                                             ( ( -distance + 0.5f ) * end ) - 0.5f ) ) + 1;
 
+        if( row_spans ) {
+            clip_row_span( offset.x + delta.y * xy, xx, MAPSIZE_X, delta.x, x_limit );
+            clip_row_span( offset.y + delta.y * yy, yx, MAPSIZE_Y, delta.x, x_limit );
+        }
+
         int last_dist = -1;
         for( ; delta.x <= x_limit; delta.x++ ) {
             point current( offset.x + delta.x * xx + delta.y * xy, offset.y + delta.x * yx + delta.y * yy );
 
-            if( !( current.x >= 0 && current.y >= 0 && current.x < MAPSIZE_X &&
+            if( !row_spans && !( current.x >= 0 && current.y >= 0 && current.x < MAPSIZE_X &&
                    current.y < MAPSIZE_Y ) /* || start < leadingEdge */ ) {
                 continue;
             } /*else if( end > trailingEdge ) {
@@ -1276,10 +1630,12 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
             }
             if( !eq_nullptr_gcc_hack( lookup ) ) {
                 //Only use fast dist on fast paths, it's slower otherwise. Floating point conversion thing maybe?
-                const int dist = fast_rl_dist<21, 4>( delta ) + offsetDistance;
+                const int dist = ( !row_spans ? fast_rl_dist<21, 4>( delta ) : !trigdist ? distance :
+                                   distances.fast_trig[distance][std::abs( delta.x )] ) + offsetDistance;
                 last_intensity = lookup_calc( numerator, lookup->values[dist], dist );
             } else {
-                const int dist = rl_dist( tripoint_zero, delta ) + offsetDistance;
+                const int dist = ( !row_spans ? rl_dist( tripoint_zero, delta ) : !trigdist ? distance :
+                                   distances.trig[distance][std::abs( delta.x )] ) + offsetDistance;
                 //Only avoid recalculation on the slow path, it's faster to avoid the branch on the fast path
                 if( last_dist != dist ) {
                     last_intensity = calc( numerator, cumulative_transparency, dist );
@@ -1576,6 +1932,93 @@ template void castLightAllWithLookup<float, four_quadrants, sight_calc, sight_ch
                                              const point &offset, int offsetDistance, float numerator );
 
 
+// Shadowcasting output for map::update_fov_bitmap, one per thread as monsters
+// update their views from several threads at once
+struct fov_scratch {
+    float seen[MAPSIZE_X][MAPSIZE_Y];
+
+    static fov_scratch &get_thread_instance() {
+        thread_local std::unique_ptr<fov_scratch> instance = std::make_unique<fov_scratch>();
+        return *instance;
+    }
+};
+
+// Submaps overlapping the window of a bitmap centered on origin
+static std::pair<point, point> fov_window_submaps( const tripoint &origin )
+{
+    return std::make_pair(
+               ms_to_sm_copy( point( std::max( origin.x - fov_bitmap::radius, 0 ),
+                                     std::max( origin.y - fov_bitmap::radius, 0 ) ) ),
+               ms_to_sm_copy( point( std::min( origin.x + fov_bitmap::radius, MAPSIZE_X - 1 ),
+                                     std::min( origin.y + fov_bitmap::radius, MAPSIZE_Y - 1 ) ) ) );
+}
+
+bool map::update_fov_bitmap( fov_bitmap &fov, const tripoint &origin ) const
+{
+    const std::pair<point, point> window_sm = fov_window_submaps( origin );
+    const point &min_sm = window_sm.first;
+    const point &max_sm = window_sm.second;
+    const level_cache &map_cache = get_cache_ref( origin.z );
+    if( fov.is_valid_for( origin, abs_sub ) ) {
+        bool changed = false;
+        for( int smx = min_sm.x; smx <= max_sm.x && !changed; smx++ ) {
+            for( int smy = min_sm.y; smy <= max_sm.y; smy++ ) {
+                if( map_cache.transparency_changed_at[smx * MAPSIZE + smy] > fov.generation ) {
+                    changed = true;
+                    break;
+                }
+            }
+        }
+        if( !changed ) {
+            // Still the view of the current transparency
+            fov.generation = transparency_generation;
+            return false;
+        }
+    }
+
+    const half_open_rectangle<point> window( sm_to_ms_copy( min_sm ),
+            sm_to_ms_copy( max_sm + point_south_east ) );
+    float ( &seen )[MAPSIZE_X][MAPSIZE_Y] = fov_scratch::get_thread_instance().seen;
+    for( int x = window.p_min.x; x < window.p_max.x; x++ ) {
+        std::fill_n( &seen[x][window.p_min.y], window.p_max.y - window.p_min.y,
+                     static_cast<float>( LIGHT_TRANSPARENCY_SOLID ) );
+    }
+    seen[origin.x][origin.y] = VISIBILITY_FULL;
+    castLightAllWithLookup<float, float, sight_calc, sight_check, update_light, accumulate_transparency, sight_from_lookup>
+    ( seen, map_cache.transparency_cache, map_cache.vehicle_obscured_cache, origin.xy(), 0 );
+
+    fov.reset( origin, abs_sub, transparency_generation );
+    for( int x = window.p_min.x; x < window.p_max.x; x++ ) {
+        for( int y = window.p_min.y; y < window.p_max.y; y++ ) {
+            const tripoint p( x, y, origin.z );
+            if( fov.covers( p ) && seen[x][y] > LIGHT_TRANSPARENCY_SOLID ) {
+                fov.set( p.xy() );
+            }
+        }
+    }
+    return true;
+}
+
+bool map::is_fov_bitmap_current( const fov_bitmap &fov ) const
+{
+    if( !fov.is_valid_for( fov.origin, abs_sub ) || fov.generation != transparency_generation ) {
+        return false;
+    }
+    const level_cache &map_cache = get_cache_ref( fov.origin.z );
+    if( map_cache.transparency_cache_dirty.none() ) {
+        return true;
+    }
+    const std::pair<point, point> window_sm = fov_window_submaps( fov.origin );
+    for( int smx = window_sm.first.x; smx <= window_sm.second.x; smx++ ) {
+        for( int smy = window_sm.first.y; smy <= window_sm.second.y; smy++ ) {
+            if( map_cache.transparency_cache_dirty[smx * MAPSIZE + smy] ) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 /**
  * Calculates the Field Of View for the provided map from the given x, y
  * coordinates. Returns a lightmap for a result where the values represent a
@@ -1746,26 +2189,46 @@ static float light_from_lookup( const float &numerator, const float &transparenc
     return numerator *  transparency  / distance ;
 }
 
-void map::apply_light_source( const tripoint &p, float luminance )
+bool map::record_light_cast( const light_cast &cast )
 {
-    auto &cache = get_cache( p.z );
-    four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] = cache.lm;
-    float ( &sm )[MAPSIZE_X][MAPSIZE_Y] = cache.sm;
-    float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.transparency_cache;
-    float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y] = cache.light_source_buffer;
-    diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.vehicle_obscured_cache;
+    if( lightmap_hist->recording == nullptr || cast.p.z != lightmap_hist->recording_zlev ) {
+        return false;
+    }
+    lightmap_hist->recording->push_back( cast );
+    return true;
+}
 
-    const point p2( p.xy() );
+void map::apply_light_cast( const light_cast &cast, four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                            float( &sm )[MAPSIZE_X][MAPSIZE_Y] ) const
+{
+    if( cast.type == light_cast::kind::arc ) {
+        cast_light_arc( cast.p, cast.angle, cast.luminance, cast.wideangle, cast.directions, lm, sm );
+    } else {
+        cast_light_source( cast.p, cast.luminance, cast.directions, lm, sm );
+    }
+}
 
-    if( inbounds( p ) ) {
-        const float min_light = std::max( static_cast<float>( lit_level::LOW ), luminance );
-        lm[p2.x][p2.y] = elementwise_max( lm[p2.x][p2.y], min_light );
-        sm[p2.x][p2.y] = std::max( sm[p2.x][p2.y], luminance );
+void map::apply_light_source( const tripoint &p, float luminance )
+{
+    light_cast cast;
+    cast.type = light_cast::kind::source;
+    cast.p = p;
+    cast.luminance = luminance;
+    cast.directions = light_source_directions( p, luminance );
+    if( !record_light_cast( cast ) ) {
+        level_cache &cache = get_cache( p.z );
+        cast_light_source( p, luminance, cast.directions, cache.lm, cache.sm );
     }
-    if( luminance <= lit_level::LOW ) {
-        return;
-    } else if( luminance <= lit_level::BRIGHT_ONLY ) {
-        luminance = 1.49f;
+}
+
+int map::light_source_directions( const tripoint &p, float luminance ) const
+{
+    const point p2( p.xy() );
+    float cast_luminance = luminance;
+    if( cast_luminance <= lit_level::LOW ) {
+        return 0;
+    } else if( cast_luminance <= lit_level::BRIGHT_ONLY ) {
+        cast_luminance = 1.49f;
     }
 
     /* If we're a 5 luminance fire , we skip casting rays into ey && sx if we have
@@ -1784,13 +2247,47 @@ void map::apply_light_source( const tripoint &p, float luminance )
         sssSsss
            sy
     */
+    // The neighbours are looked up now, while the buffer still matches the order sources are added in
+    const float( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y] = get_cache( p.z ).light_source_buffer;
     const int peer_inbounds = LIGHTMAP_CACHE_X - 1;
-    bool north = ( p2.y != 0 && light_source_buffer[p2.x][p2.y - 1] < luminance );
-    bool south = ( p2.y != peer_inbounds && light_source_buffer[p2.x][p2.y + 1] < luminance );
-    bool east = ( p2.x != peer_inbounds && light_source_buffer[p2.x + 1][p2.y] < luminance );
-    bool west = ( p2.x != 0 && light_source_buffer[p2.x - 1][p2.y] < luminance );
+    int directions = 0;
+    if( p2.y != 0 && light_source_buffer[p2.x][p2.y - 1] < cast_luminance ) {
+        directions |= light_cast::north;
+    }
+    if( p2.y != peer_inbounds && light_source_buffer[p2.x][p2.y + 1] < cast_luminance ) {
+        directions |= light_cast::south;
+    }
+    if( p2.x != peer_inbounds && light_source_buffer[p2.x + 1][p2.y] < cast_luminance ) {
+        directions |= light_cast::east;
+    }
+    if( p2.x != 0 && light_source_buffer[p2.x - 1][p2.y] < cast_luminance ) {
+        directions |= light_cast::west;
+    }
+    return directions;
+}
+
+void map::cast_light_source( const tripoint &p, float luminance, const int directions,
+                             four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                             float( &sm )[MAPSIZE_X][MAPSIZE_Y] ) const
+{
+    const level_cache &cache = get_cache( p.z );
+    const float( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.transparency_cache;
+    const diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.vehicle_obscured_cache;
+
+    const point p2( p.xy() );
+
+    if( inbounds( p ) ) {
+        const float min_light = std::max( static_cast<float>( lit_level::LOW ), luminance );
+        lm[p2.x][p2.y] = elementwise_max( lm[p2.x][p2.y], min_light );
+        sm[p2.x][p2.y] = std::max( sm[p2.x][p2.y], luminance );
+    }
+    if( luminance <= lit_level::LOW ) {
+        return;
+    } else if( luminance <= lit_level::BRIGHT_ONLY ) {
+        luminance = 1.49f;
+    }
 
-    if( north ) {
+    if( directions & light_cast::north ) {
         castLightWithLookup < 1, 0, 0, -1, float, four_quadrants, light_calc, light_check,
                             update_light_quadrants, accumulate_transparency, light_from_lookup > (
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
@@ -1799,7 +2296,7 @@ void map::apply_light_source( const tripoint &p, float luminance )
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
     }
 
-    if( east ) {
+    if( directions & light_cast::east ) {
         castLightWithLookup < 0, -1, 1, 0, float, four_quadrants, light_calc, light_check,
                             update_light_quadrants, accumulate_transparency, light_from_lookup > (
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
@@ -1808,7 +2305,7 @@ void map::apply_light_source( const tripoint &p, float luminance )
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
     }
 
-    if( south ) {
+    if( directions & light_cast::south ) {
         castLightWithLookup<1, 0, 0, 1, float, four_quadrants, light_calc, light_check,
                             update_light_quadrants, accumulate_transparency, light_from_lookup>(
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
@@ -1817,7 +2314,7 @@ void map::apply_light_source( const tripoint &p, float luminance )
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
     }
 
-    if( west ) {
+    if( directions & light_cast::west ) {
         castLightWithLookup<0, 1, 1, 0, float, four_quadrants, light_calc, light_check,
                             update_light_quadrants, accumulate_transparency, light_from_lookup>(
                                 lm, transparency_cache, blocked_cache, p2, 0, luminance );
@@ -1874,9 +2371,28 @@ void map::apply_light_arc( const tripoint &p, units::angle angle, float luminanc
         return;
     }
 
+    light_cast cast;
+    cast.type = light_cast::kind::arc;
+    cast.p = p;
+    cast.luminance = luminance;
+    // Directions of the local light around the arc's origin
+    cast.directions = light_source_directions( p, LIGHT_SOURCE_LOCAL );
+    cast.angle = angle;
+    cast.wideangle = wideangle;
+    if( !record_light_cast( cast ) ) {
+        level_cache &cache = get_cache( p.z );
+        cast_light_arc( p, angle, luminance, wideangle, cast.directions, cache.lm, cache.sm );
+    }
+}
+
+void map::cast_light_arc( const tripoint &p, units::angle angle, float luminance,
+                          units::angle wideangle, const int local_directions,
+                          four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                          float( &sm )[MAPSIZE_X][MAPSIZE_Y] ) const
+{
     bool lit[LIGHTMAP_CACHE_X][LIGHTMAP_CACHE_Y] {};
 
-    apply_light_source( p, LIGHT_SOURCE_LOCAL );
+    cast_light_source( p, LIGHT_SOURCE_LOCAL, local_directions, lm, sm );
 
     // Normalize (should work with negative values too)
     const units::angle wangle = wideangle / 2.0;
@@ -1886,7 +2402,7 @@ void map::apply_light_arc( const tripoint &p, units::angle angle, float luminanc
     tripoint end;
     int range = LIGHT_RANGE( luminance );
     calc_ray_end( nangle, range, p, end );
-    apply_light_ray( lit, p, end, luminance );
+    apply_light_ray( lit, p, end, luminance, lm );
 
     tripoint test;
     calc_ray_end( wangle + nangle, range, p, test );
@@ -1907,24 +2423,25 @@ void map::apply_light_arc( const tripoint &p, units::angle angle, float luminanc
                         p.x + ( static_cast<double>( range ) - fdist * 2.0 ) * cos( nangle + ao ) );
             end.y = static_cast<int>(
                         p.y + ( static_cast<double>( range ) - fdist * 2.0 ) * sin( nangle + ao ) );
-            apply_light_ray( lit, p, end, luminance );
+            apply_light_ray( lit, p, end, luminance, lm );
 
             end.x = static_cast<int>(
                         p.x + ( static_cast<double>( range ) - fdist * 2.0 ) * cos( nangle - ao ) );
             end.y = static_cast<int>(
                         p.y + ( static_cast<double>( range ) - fdist * 2.0 ) * sin( nangle - ao ) );
-            apply_light_ray( lit, p, end, luminance );
+            apply_light_ray( lit, p, end, luminance, lm );
         } else {
             calc_ray_end( nangle + ao, range, p, end );
-            apply_light_ray( lit, p, end, luminance );
+            apply_light_ray( lit, p, end, luminance, lm );
             calc_ray_end( nangle - ao, range, p, end );
-            apply_light_ray( lit, p, end, luminance );
+            apply_light_ray( lit, p, end, luminance, lm );
         }
     }
 }
 
 void map::apply_light_ray( bool lit[LIGHTMAP_CACHE_X][LIGHTMAP_CACHE_Y],
-                           const tripoint &s, const tripoint &e, float luminance )
+                           const tripoint &s, const tripoint &e, float luminance,
+                           four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] ) const
 {
     point a( std::abs( e.x - s.x ) * 2, std::abs( e.y - s.y ) * 2 );
     point d( ( s.x < e.x ) ? 1 : -1, ( s.y < e.y ) ? 1 : -1 );
@@ -1937,8 +2454,7 @@ void map::apply_light_ray( bool lit[LIGHTMAP_CACHE_X][LIGHTMAP_CACHE_Y],
         return;
     }
 
-    auto &lm = get_cache( s.z ).lm;
-    auto &transparency_cache = get_cache( s.z ).transparency_cache;
+    const auto &transparency_cache = get_cache( s.z ).transparency_cache;
 
     float distance = 1.0;
     float transparency = LIGHT_TRANSPARENCY_OPEN_AIR;
@@ -7,6 +7,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <limits>
+#include <mutex>
 #include <optional>
 #include <ostream>
 #include <queue>
@@ -142,6 +143,9 @@ static cata::colony<item> nulitems;          // Returned when &i_at() is asked f
 static field              nulfield;          // Returned when &field_at() is asked for an OOB value
 static level_cache        nullcache;         // Dummy cache for z-levels outside bounds
 
+// map::sees() is called from the parallel monster planning pass, see game::monmove
+static std::mutex skew_vision_cache_mutex;
+
 bool disable_mapgen = false;
 
 map &get_map()
@@ -189,6 +193,8 @@ map::map( int mapsize, bool zlev )
     for( auto &ptr : pathfinding_caches ) {
         ptr = std::make_unique<pathfinding_cache>();
     }
+    flow_field_cache = std::make_unique<pathfinding_flow_field_cache>();
+    lightmap_hist = std::make_unique<lightmap_history>();
 
     dbg( DL::Info ) << "map::map(): my_MAPSIZE: " << my_MAPSIZE << " z-levels enabled:" << zlevels;
     traplocs.resize( trap::count() );
@@ -333,6 +339,7 @@ void map::add_vehicle_to_cache( vehicle *veh )
         debugmsg( "Tried to add null vehicle to cache" );
         return;
     }
+    invalidate_inventory_caches();
 
     // Get parts
     for( const vpart_reference &vpr : veh->get_all_parts() ) {
@@ -416,6 +423,7 @@ std::unique_ptr<vehicle> map::detach_vehicle( vehicle *veh )
         debugmsg( "map::detach_vehicle was passed nullptr" );
         return std::unique_ptr<vehicle>();
     }
+    invalidate_inventory_caches();
 
     int z = veh->sm_pos.z;
     if( z < -OVERMAP_DEPTH || z > OVERMAP_HEIGHT ) {
@@ -1182,6 +1190,7 @@ void map::unboard_vehicle( const tripoint &p, bool dead_passenger )
 
 bool map::displace_vehicle( vehicle &veh, const tripoint &dp )
 {
+    invalidate_inventory_caches();
     const tripoint src = veh.global_pos3();
 
     tripoint dst = src + dp;
@@ -1436,6 +1445,7 @@ void map::furn_set( const tripoint &p, const furn_id &new_furniture,
         return;
     }
 
+    invalidate_inventory_caches();
     current_submap->set_furn( l, new_furniture );
 
     // Set the dirty flags
@@ -1714,6 +1724,7 @@ bool map::ter_set( const tripoint &p, const ter_id &new_terrain )
         return false;
     }
 
+    invalidate_inventory_caches();
     current_submap->set_ter( l, new_terrain );
 
     // Set the dirty flags
@@ -4199,6 +4210,7 @@ map_stack map::i_at( const tripoint &p )
 
 map_stack::iterator map::i_rem( const tripoint &p, map_stack::const_iterator it )
 {
+    invalidate_inventory_caches();
     point l;
     submap *const current_submap = get_submap_at( p, l );
 
@@ -4224,6 +4236,7 @@ void map::i_rem( const tripoint &p, item *it )
 
 void map::i_clear( const tripoint &p )
 {
+    invalidate_inventory_caches();
     point l;
     submap *const current_submap = get_submap_at( p, l );
 
@@ -4434,6 +4447,7 @@ item &map::add_item( const tripoint &p, item new_item )
     if( !inbounds( p ) ) {
         return null_item_reference();
     }
+    invalidate_inventory_caches();
     point l;
     submap *const current_submap = get_submap_at( p, l );
 
@@ -4895,6 +4909,7 @@ std::list<item> use_amount_stack( Stack stack, const itype_id &type, int &quanti
 std::list<item> map::use_amount_square( const tripoint &p, const itype_id &type,
                                         int &quantity, const std::function<bool( const item & )> &filter )
 {
+    invalidate_inventory_caches();
     std::list<item> ret;
     // Handle infinite map sources.
     item water = water_from( p );
@@ -5016,6 +5031,7 @@ std::list<item> map::use_charges( const tripoint &origin, const int range,
                                   const itype_id &type, int &quantity,
                                   const std::function<bool( const item & )> &filter, basecamp *bcp )
 {
+    invalidate_inventory_caches();
     std::list<item> ret;
 
     // populate a grid of spots that can be reached
@@ -5492,6 +5508,34 @@ field_entry *map::get_field( const tripoint &p, const field_type_id &type )
     return current_submap->get_field( l ).find_field( type );
 }
 
+std::vector<tripoint> map::get_field_tiles( const field_type_id &type, const int z ) const
+{
+    std::vector<tripoint> result;
+    if( !inbounds_z( z ) ) {
+        return result;
+    }
+    const auto &field_cache = get_cache_ref( z ).field_cache;
+    if( field_cache.none() ) {
+        return result;
+    }
+    for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+        for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+            if( !field_cache[smx + smy * MAPSIZE] ) {
+                continue;
+            }
+            const submap *const current_submap = get_submap_at_grid( { smx, smy, z } );
+            const submap_field_tiles &tiles = current_submap->field_tiles;
+            for( int tile = tiles.next( 0 ); tile >= 0; tile = tiles.next( tile + 1 ) ) {
+                const point l = submap_field_tiles::tile_point( tile );
+                if( current_submap->get_field( l ).find_field_c( type ) != nullptr ) {
+                    result.emplace_back( smx * SEEX + l.x, smy * SEEY + l.y, z );
+                }
+            }
+        }
+    }
+    return result;
+}
+
 bool map::dangerous_field_at( const tripoint &p )
 {
     for( auto &pr : field_at( p ) ) {
@@ -5526,7 +5570,9 @@ bool map::add_field( const tripoint &p, const field_type_id &type_id, int intens
     current_submap->is_uniform = false;
     invalidate_max_populated_zlev( p.z );
 
+    current_submap->field_tiles.insert( l );
     if( current_submap->get_field( l ).add_field( type_id, intensity, age ) ) {
+        invalidate_inventory_caches();
         //Only adding it to the count if it doesn't exist.
         if( !current_submap->field_count++ ) {
             get_cache( p.z ).field_cache.set( static_cast<size_t>( p.x / SEEX + ( (
@@ -5569,7 +5615,12 @@ void map::remove_field( const tripoint &p, const field_type_id &field_to_remove
     point l;
     submap *const current_submap = get_submap_at( p, l );
 
-    if( current_submap->get_field( l ).remove_field( field_to_remove ) ) {
+    field &fields = current_submap->get_field( l );
+    if( fields.remove_field( field_to_remove ) ) {
+        invalidate_inventory_caches();
+        if( fields.field_count() == 0 ) {
+            current_submap->field_tiles.erase( l );
+        }
         // Only adjust the count if the field actually existed.
         if( !--current_submap->field_count ) {
             get_cache( p.z ).field_cache.set( static_cast<size_t>( p.x / SEEX + ( (
@@ -6237,6 +6288,12 @@ void map::draw_from_above( const catacurses::window &w, const tripoint &p,
     }
 }
 
+set_assoc_cache<point, char>::statistics map::get_sees_cache_statistics() const
+{
+    std::lock_guard<std::mutex> lock( skew_vision_cache_mutex );
+    return skew_vision_cache.get_statistics();
+}
+
 bool map::sees( const tripoint &F, const tripoint &T, const int range ) const
 {
     int dummy = 0;
@@ -6262,7 +6319,11 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
         min.x << 16 | min.y << 8 | ( min.z + OVERMAP_DEPTH ),
         max.x << 16 | max.y << 8 | ( max.z + OVERMAP_DEPTH )
     );
-    char cached = skew_vision_cache.get( key, -1 );
+    char cached;
+    {
+        std::lock_guard<std::mutex> lock( skew_vision_cache_mutex );
+        cached = skew_vision_cache.get( key, -1 );
+    }
     if( cached >= 0 ) {
         return cached > 0;
     }
@@ -6287,7 +6348,8 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
             last_point = new_point;
             return true;
         } );
-        skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+        std::lock_guard<std::mutex> lock( skew_vision_cache_mutex );
+        skew_vision_cache.insert( key, visible ? 1 : 0 );
         return visible;
     }
 
@@ -6320,7 +6382,8 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
         last_point = new_point;
         return true;
     } );
-    skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+    std::lock_guard<std::mutex> lock( skew_vision_cache_mutex );
+    skew_vision_cache.insert( key, visible ? 1 : 0 );
     return visible;
 }
 
@@ -6724,6 +6787,7 @@ void map::load( const tripoint &w, const bool update_vehicle, const bool pump_ev
     }
     field_furn_locs.clear();
     submaps_with_active_items.clear();
+    invalidate_lightmap_history();
     set_abs_sub( w );
     for( int gridx = 0; gridx < my_MAPSIZE; gridx++ ) {
         for( int gridy = 0; gridy < my_MAPSIZE; gridy++ ) {
@@ -6874,6 +6938,19 @@ void map::shift_vehicle_z( vehicle &veh, int z_shift )
 
 }
 
+// Submaps to read ahead of the map edge: one quad on foot, more the faster the player drives
+static int map_prefetch_distance()
+{
+    int velocity = 0;
+    if( g->u.in_vehicle ) {
+        if( const optional_vpart_position vp = get_map().veh_at( g->u.pos() ) ) {
+            velocity = vp->vehicle().velocity;
+        }
+    }
+    // velocity is in hundredths of mph, at 70 mph this reads 6 submaps ahead
+    return clamp( 2 + std::abs( velocity ) / 1700, 2, 12 );
+}
+
 void map::shift( point sp )
 {
     // Special case of 0-shift; refresh the map
@@ -7015,6 +7092,8 @@ void map::shift( point sp )
     if( !support_cache_dirty.empty() ) {
         shift_tripoint_set( support_cache_dirty, shift_offset_pt, boundaries_2d );
     }
+
+    MAPBUFFER.prefetch_ahead( get_abs_sub(), sp, map_prefetch_distance(), zmin, zmax );
 }
 
 void map::vertical_shift( const int newz )
@@ -8315,12 +8394,20 @@ static void vehicle_caching_internal_above( level_cache &zch_above, const vpart_
 void map::do_vehicle_caching( int z )
 {
     level_cache &ch = get_cache( z );
+    if( ch.vehicle_list.empty() ) {
+        return;
+    }
+    // Vehicle parts are written into the transparency caches again every time, so
+    // any field of view near a vehicle may be stale
+    const int generation = ++transparency_generation;
     for( vehicle *v : ch.vehicle_list ) {
         for( const vpart_reference &vp : v->get_all_parts() ) {
             const tripoint &part_pos = v->global_part_pos3( vp.part() );
             if( !inbounds( part_pos.xy() ) || vp.part().removed ) {
                 continue;
             }
+            const point part_sm = ms_to_sm_copy( part_pos.xy() );
+            get_cache( part_pos.z ).transparency_changed_at[part_sm.x * MAPSIZE + part_sm.y] = generation;
             vehicle_caching_internal( get_cache( part_pos.z ), vp, v );
             if( part_pos.z < OVERMAP_HEIGHT ) {
                 vehicle_caching_internal_above( get_cache( part_pos.z + 1 ), vp, v );
@@ -8881,6 +8968,7 @@ level_cache::level_cache()
 {
     const int map_dimensions = MAPSIZE_X * MAPSIZE_Y;
     transparency_cache_dirty.set();
+    transparency_changed_at.fill( 0 );
     outside_cache_dirty = true;
     floor_cache_dirty = false;
     constexpr four_quadrants four_zeros( 0.0f );
@@ -8916,6 +9004,7 @@ void map::set_pathfinding_cache_dirty( const int zlev )
 {
     if( inbounds_z( zlev ) ) {
         get_pathfinding_cache( zlev ).dirty = true;
+        flow_field_cache->invalidate( zlev );
     }
 }
 
@@ -8957,6 +9046,18 @@ void map::set_memory_seen_cache_dirty( const tripoint &p )
     }
 }
 
+static int map_inventory_revision = 0;
+
+int map::inventory_revision()
+{
+    return map_inventory_revision;
+}
+
+void map::invalidate_inventory_caches()
+{
+    map_inventory_revision++;
+}
+
 const pathfinding_cache &map::get_pathfinding_cache_ref( int zlev ) const
 {
     if( !inbounds_z( zlev ) ) {
@@ -8971,6 +9072,18 @@ const pathfinding_cache &map::get_pathfinding_cache_ref( int zlev ) const
     return cache;
 }
 
+const pathfinding_graph &map::get_pathfinding_graph_ref( int zlev ) const
+{
+    const pathfinding_cache &cache = get_pathfinding_cache_ref( zlev );
+    // Out of bounds levels were already reported and fell back to z-level 0
+    pathfinding_graph &graph = get_pathfinding_cache( inbounds_z( zlev ) ? zlev : 0 ).graph;
+    if( graph.dirty ) {
+        graph.build( cache.special );
+    }
+
+    return graph;
+}
+
 void map::update_pathfinding_cache( int zlev ) const
 {
     auto &cache = get_pathfinding_cache( zlev );
@@ -8979,6 +9092,7 @@ void map::update_pathfinding_cache( int zlev ) const
     }
 
     std::uninitialized_fill_n( &cache.special[0][0], MAPSIZE_X * MAPSIZE_Y, PF_NORMAL );
+    cache.graph.dirty = true;
 
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
@@ -29,11 +29,11 @@
 #include "item_stack.h"
 #include "lightmap.h"
 #include "line.h"
-#include "lru_cache.h"
 #include "mapdata.h"
 #include "memory_fast.h"
 #include "point.h"
 #include "shadowcasting.h"
+#include "set_assoc_cache.h"
 #include "type_id.h"
 #include "units.h"
 
@@ -52,6 +52,7 @@ class character_id;
 class computer;
 class field;
 class field_entry;
+class fov_bitmap;
 class item_location;
 class map_cursor;
 class mapgendata;
@@ -86,7 +87,13 @@ using VehicleList = std::vector<wrapped_vehicle>;
 class map;
 
 enum ter_bitflags : int;
+enum pf_special : int;
+enum class pf_step : int;
 struct pathfinding_cache;
+struct pathfinding_flow_field;
+struct pathfinding_flow_field_cache;
+struct pathfinding_flow_field_stats;
+struct pathfinding_graph;
 struct pathfinding_settings;
 template<typename T>
 struct weighted_int_list;
@@ -304,6 +311,9 @@ struct level_cache {
     level_cache( const level_cache &other ) = default;
 
     std::bitset<MAPSIZE *MAPSIZE> transparency_cache_dirty;
+    // value of map::transparency_generation when the transparency of a submap last changed,
+    // indexed like transparency_cache_dirty
+    std::array<int, MAPSIZE *MAPSIZE> transparency_changed_at;
     bool outside_cache_dirty = false;
     bool floor_cache_dirty = false;
     bool seen_cache_dirty = false;
@@ -359,6 +369,76 @@ struct level_cache {
 
 };
 
+/**
+ * A light cast by map::generate_lightmap() on the lightmap's own z-level.
+ * These are collected first and applied afterwards, so unchanged lights can be skipped.
+ */
+struct light_cast {
+    enum class kind : int {
+        source, // map::apply_light_source
+        arc,    // map::apply_light_arc
+    };
+    // Bits of directions
+    static constexpr int north = 1;
+    static constexpr int east = 2;
+    static constexpr int south = 4;
+    static constexpr int west = 8;
+
+    kind type = kind::source;
+    tripoint p;
+    float luminance = 0.0f;
+    // The quadrant pairs that get cast into, for arcs those of the local light at p
+    int directions = 0;
+    // Arcs only
+    units::angle angle = 0_degrees;
+    units::angle wideangle = 0_degrees;
+
+    // Square distance from p beyond which the cast leaves the lightmap alone
+    int radius() const;
+    bool operator==( const light_cast &rhs ) const;
+    bool operator<( const light_cast &rhs ) const;
+};
+
+/**
+ * Lightmap that one thread casts lights into, to be merged into the real one afterwards.
+ * It is all zeros outside of the columns [min_x, max_x].
+ */
+struct light_cast_buffer {
+    four_quadrants lm[MAPSIZE_X][MAPSIZE_Y];
+    float sm[MAPSIZE_X][MAPSIZE_Y];
+    int min_x = MAPSIZE_X;
+    int max_x = -1;
+};
+
+/**
+ * What went into and came out of the previous lightmap of one z-level.
+ * The next lightmap only recasts the lights that reach tiles that changed in between.
+ */
+struct lightmap_history {
+    bool valid = false;
+    int zlev = 0;
+    tripoint abs_sub;
+    bool trigdist = false;
+    float weather_transparency = 0.0f;
+    std::vector<light_cast> casts;
+    std::vector<std::pair<point, float>> overrides;
+
+    // Casts collected by the running generate_lightmap(), if it collects casts
+    std::vector<light_cast> *recording = nullptr;
+    int recording_zlev = 0;
+
+    // Lightmap before and after applying the casts
+    four_quadrants base_lm[MAPSIZE_X][MAPSIZE_Y];
+    float base_sm[MAPSIZE_X][MAPSIZE_Y];
+    four_quadrants lm[MAPSIZE_X][MAPSIZE_Y];
+    float sm[MAPSIZE_X][MAPSIZE_Y];
+    float transparency_cache[MAPSIZE_X][MAPSIZE_Y];
+    diagonal_blocks vehicle_obscured_cache[MAPSIZE_X][MAPSIZE_Y];
+
+    // One per thread that took part in casting the lights
+    std::vector<std::unique_ptr<light_cast_buffer>> buffers;
+};
+
 /**
  * Manage and cache data about a part of the map.
  *
@@ -427,6 +507,15 @@ class map
 
         void set_memory_seen_cache_dirty( const tripoint &p );
 
+        /**
+         * Counter bumped by every map whenever something a crafting inventory is formed
+         * from changes: items on the ground or in vehicle cargo, furniture, terrain, fields,
+         * vehicle parts and fuel, or grid power. Lets callers reuse an inventory formed
+         * from the map for as long as it stays the same.
+         */
+        static int inventory_revision();
+        static void invalidate_inventory_caches();
+
         void invalidate_map_cache( const int zlev );
 
         bool check_seen_cache( const tripoint &p ) const;
@@ -611,6 +700,21 @@ class map
         * Returns whether `F` sees `T` with a view range of `range`.
         */
         bool sees( const tripoint &F, const tripoint &T, int range ) const;
+        /** Hits and misses of the cache behind @ref sees, for profiling. */
+        set_assoc_cache<point, char>::statistics get_sees_cache_statistics() const;
+        /**
+         * Makes @p fov hold what can be seen from `origin` by shadowcasting on its z-level.
+         * Does nothing if it already does and the transparency of its window did not change
+         * since it was cast. Only reads the map, so it may run for many observers at once.
+         * @returns true if the view had to be cast again.
+         */
+        bool update_fov_bitmap( fov_bitmap &fov, const tripoint &origin ) const;
+        /**
+         * Whether the transparency @p fov was cast from still holds, i.e. nothing in its
+         * window changed since the last @ref update_fov_bitmap, not even changes waiting
+         * for the next transparency cache build.
+         */
+        bool is_fov_bitmap_current( const fov_bitmap &fov ) const;
     private:
         /**
          * Don't expose the slope adjust outside map functions.
@@ -700,6 +804,19 @@ class map
                                      const pathfinding_settings &settings,
         const std::set<tripoint> &pre_closed = {{ }} ) const;
 
+        /**
+         * Like @ref route, for callers that expect others to route to the same target
+         * with the same settings during this turn, like a horde chasing the player.
+         * Once a target is requested a second time, a flow field towards it is built
+         * and every later route is read from it instead of running a separate search.
+         */
+        std::vector<tripoint> route_shared( const tripoint &f, const tripoint &t,
+                                            const pathfinding_settings &settings,
+        const std::set<tripoint> &pre_closed = {{ }} ) const;
+        /** Counts of how @ref route_shared answered requests, for instrumentation */
+        const pathfinding_flow_field_stats &get_flow_field_stats() const;
+        void reset_flow_field_stats();
+
         // Vehicles: Common to 2D and 3D
         VehicleList get_vehicles();
         void add_vehicle_to_cache( vehicle * );
@@ -1430,6 +1547,11 @@ class map
          * @return NULL if there is no such field entry at that place.
          */
         field_entry *get_field( const tripoint &p, const field_type_id &type );
+        /**
+         * Get all points on z-level @p z that have a field of the given type.
+         * Only looks at the submaps and tiles that the field caches mark as holding fields.
+         */
+        std::vector<tripoint> get_field_tiles( const field_type_id &type, int z ) const;
         bool dangerous_field_at( const tripoint &p );
         /**
          * Add field entry at point, or set intensity if present
@@ -1549,6 +1671,8 @@ class map
         void do_vehicle_caching( int z );
         // Note: in 3D mode, will actually build caches on ALL z-levels
         void build_map_cache( int zlev, bool skip_lightmap = false );
+        // Makes the next lightmap cast every light again instead of reusing the previous lightmap
+        void invalidate_lightmap_history();
         // Unlike the other caches, this populates a supplied cache instead of an internal cache.
         void build_obstacle_cache( const tripoint &start, const tripoint &end,
                                    float( &obstacle_cache )[MAPSIZE_X][MAPSIZE_Y] );
@@ -1769,6 +1893,13 @@ class map
         void update_suspension_cache( const int &z );
     protected:
         void generate_lightmap( int zlev );
+        // Applies the casts collected by generate_lightmap() on top of the lightmap built so far
+        void apply_light_casts( int zlev, std::vector<light_cast> &casts,
+                                std::vector<std::pair<point, float>> &overrides );
+        // Applies the casts, spread over worker threads if there are enough of them
+        void apply_light_casts_parallel( const std::vector<const light_cast *> &to_cast,
+                                         four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                                         float( &sm )[MAPSIZE_X][MAPSIZE_Y] );
         void build_seen_cache( const tripoint &origin, int target_z );
         void apply_character_light( Character &p );
 
@@ -1870,6 +2001,17 @@ class map
         int bash_rating_internal( int str, const furn_t &furniture,
                                   const ter_t &terrain, bool allow_floor,
                                   const vehicle *veh, int part ) const;
+        /**
+         * Pathfinding cost of stepping from @p cur onto the adjacent @p p, not counting
+         * the penalty for diagonal steps. Shared by @ref route and flow fields.
+         * @param cur_veh Vehicle at @p cur, if any.
+         * @param p_special Pathfinding cache flags of @p p.
+         * @param step_cost Set to the cost when the result is pf_step::walk.
+         */
+        pf_step pathfinding_step( const tripoint &cur, const vehicle *cur_veh, const tripoint &p,
+                                  pf_special p_special, const pathfinding_settings &settings,
+                                  int &step_cost ) const;
+        void build_flow_field( pathfinding_flow_field &field ) const;
 
         /**
          * Internal version of the drawsq. Keeps a cached maptile for less re-getting.
@@ -1893,8 +2035,23 @@ class map
         void apply_directional_light( const tripoint &p, int direction, float luminance );
         void apply_light_arc( const tripoint &p, units::angle, float luminance,
                               units::angle wideangle = 30_degrees );
+        // Collects the cast if generate_lightmap() is collecting casts for its z-level
+        bool record_light_cast( const light_cast &cast );
+        // Which neighbours of a source at p have a weaker buffered source, see light_cast::directions
+        int light_source_directions( const tripoint &p, float luminance ) const;
+        // These only read the map, and write their light into lm and sm
+        void apply_light_cast( const light_cast &cast, four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                               float( &sm )[MAPSIZE_X][MAPSIZE_Y] ) const;
+        void cast_light_source( const tripoint &p, float luminance, int directions,
+                                four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                                float( &sm )[MAPSIZE_X][MAPSIZE_Y] ) const;
+        void cast_light_arc( const tripoint &p, units::angle angle, float luminance,
+                             units::angle wideangle, int local_directions,
+                             four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                             float( &sm )[MAPSIZE_X][MAPSIZE_Y] ) const;
         void apply_light_ray( bool lit[MAPSIZE_X][MAPSIZE_Y],
-                              const tripoint &s, const tripoint &e, float luminance );
+                              const tripoint &s, const tripoint &e, float luminance,
+                              four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] ) const;
         void add_light_from_items( const tripoint &p, item_stack::iterator begin,
                                    item_stack::iterator end );
         std::unique_ptr<vehicle> add_vehicle_to_map( std::unique_ptr<vehicle> veh, bool merge_wrecks );
@@ -1968,6 +2125,8 @@ class map
         std::array< std::unique_ptr<level_cache>, OVERMAP_LAYERS > caches;
 
         mutable std::array< std::unique_ptr<pathfinding_cache>, OVERMAP_LAYERS > pathfinding_caches;
+        mutable std::unique_ptr<pathfinding_flow_field_cache> flow_field_cache;
+        std::unique_ptr<lightmap_history> lightmap_hist;
         /**
          * Set of submaps that contain active items in absolute coordinates.
          */
@@ -1975,8 +2134,11 @@ class map
 
         /**
          * Cache of coordinate pairs recently checked for visibility.
+         * Guarded by a mutex in map.cpp, as monsters check sight from several threads.
          */
-        mutable lru_cache<point, char> skew_vision_cache;
+        mutable set_assoc_cache<point, char> skew_vision_cache{ 100000 };
+        // bumped whenever the transparency of some submaps changes, see level_cache::transparency_changed_at
+        int transparency_generation = 0;
 
         /**
          * Vehicle list doesn't change often, but is pretty expensive.
@@ -2003,6 +2165,8 @@ class map
         }
 
         const pathfinding_cache &get_pathfinding_cache_ref( int zlev ) const;
+        /** Submap-level connectivity of the pathfinding cache, rebuilt when it goes stale */
+        const pathfinding_graph &get_pathfinding_graph_ref( int zlev ) const;
 
         void update_pathfinding_cache( int zlev ) const;
 
@@ -412,787 +412,797 @@ void map::process_fields_in_submap( submap *const current_submap,
     int &locy = map_tile.pos_.y;
     const point sm_offset( submap.x * SEEX, submap.y * SEEY );
 
-    // Loop through all tiles in this submap indicated by current_submap
-    for( locx = 0; locx < SEEX; locx++ ) {
-        for( locy = 0; locy < SEEY; locy++ ) {
-            // Get a reference to the field variable from the submap;
-            // contains all the pointers to the real field effects.
-            field &curfield = current_submap->get_field( { static_cast<int>( locx ), static_cast<int>( locy ) } );
-
-            // when displayed_field_type == fd_null it means that `curfield` has no fields inside
-            // avoids instantiating (relatively) expensive map iterator
-            if( !curfield.displayed_field_type() ) {
+    // Loop through the tiles of this submap that may hold fields, in the order of a scan
+    // over all of them. A field spreading to a later tile is processed in the same pass.
+    submap_field_tiles &field_tiles = current_submap->field_tiles;
+    for( int tile = field_tiles.next( 0 ); tile >= 0; tile = field_tiles.next( tile + 1 ) ) {
+        const point l = submap_field_tiles::tile_point( tile );
+        locx = l.x;
+        locy = l.y;
+        // Get a reference to the field variable from the submap;
+        // contains all the pointers to the real field effects.
+        field &curfield = current_submap->get_field( { static_cast<int>( locx ), static_cast<int>( locy ) } );
+
+        // when displayed_field_type == fd_null it means that `curfield` has no fields inside
+        // avoids instantiating (relatively) expensive map iterator
+        if( !curfield.displayed_field_type() ) {
+            field_tiles.erase( l );
+            continue;
+        }
+
+        // This is a translation from local coordinates to submap coordinates.
+        // All submaps are in one long 1d array.
+        thep.x = locx + sm_offset.x;
+        thep.y = locy + sm_offset.y;
+        // A const reference to the tripoint above, so that the code below doesn't accidentally change it
+        const tripoint &p = thep;
+
+        // This should be true only when the field in the current tile changes transparency state,
+        // More correctly: not just when the field is opaque, but when it changes state
+        // to a more/less transparent one
+        bool dirty_transparency_cache = false;
+
+        for( auto it = curfield.begin(); it != curfield.end(); ) {
+            // Iterating through all field effects in the submap's field.
+            field_entry &cur = it->second;
+
+            // Holds cur.get_field_type() as that is what the old system used before rewrite.
+            field_type_id cur_fd_type_id = cur.get_field_type();
+
+            // The field might have been killed by processing a neighbor field
+            if( !cur.is_field_alive() ) {
+                if( !cur_fd_type_id->get_transparent( cur.get_field_intensity() - 1 ) ) {
+                    dirty_transparency_cache = true;
+                }
+                --current_submap->field_count;
+                curfield.remove_field( it++ );
+                invalidate_inventory_caches();
                 continue;
             }
 
-            // This is a translation from local coordinates to submap coordinates.
-            // All submaps are in one long 1d array.
-            thep.x = locx + sm_offset.x;
-            thep.y = locy + sm_offset.y;
-            // A const reference to the tripoint above, so that the code below doesn't accidentally change it
-            const tripoint &p = thep;
-
-            // This should be true only when the field in the current tile changes transparency state,
-            // More correctly: not just when the field is opaque, but when it changes state
-            // to a more/less transparent one
-            bool dirty_transparency_cache = false;
-
-            for( auto it = curfield.begin(); it != curfield.end(); ) {
-                // Iterating through all field effects in the submap's field.
-                field_entry &cur = it->second;
-
-                // Holds cur.get_field_type() as that is what the old system used before rewrite.
-                field_type_id cur_fd_type_id = cur.get_field_type();
+            // Again, legacy support in the event someone Mods set_field_intensity to allow more values.
+            if( cur.get_field_intensity() > 3 || cur.get_field_intensity() < 1 ) {
+                // TODO: Remove this eventually as we would suppoort more than 3 field intensity levels
+                debugmsg( "Whoooooa intensity of %d", cur.get_field_intensity() );
+            }
 
-                // The field might have been killed by processing a neighbor field
-                if( !cur.is_field_alive() ) {
-                    if( !cur_fd_type_id->get_transparent( cur.get_field_intensity() - 1 ) ) {
-                        dirty_transparency_cache = true;
-                    }
-                    --current_submap->field_count;
-                    curfield.remove_field( it++ );
-                    continue;
-                }
+            dirty_transparency_cache |= cur_fd_type_id->dirty_transparency_cache;
 
-                // Again, legacy support in the event someone Mods set_field_intensity to allow more values.
-                if( cur.get_field_intensity() > 3 || cur.get_field_intensity() < 1 ) {
-                    // TODO: Remove this eventually as we would suppoort more than 3 field intensity levels
-                    debugmsg( "Whoooooa intensity of %d", cur.get_field_intensity() );
-                }
+            // Don't process "newborn" fields. This gives the player time to run if they need to.
+            if( cur.get_field_age() == 0_turns ) {
+                cur_fd_type_id = fd_null;
+            }
 
-                dirty_transparency_cache |= cur_fd_type_id->dirty_transparency_cache;
+            const field_type &cur_fd_type = *cur_fd_type_id;
 
-                // Don't process "newborn" fields. This gives the player time to run if they need to.
-                if( cur.get_field_age() == 0_turns ) {
-                    cur_fd_type_id = fd_null;
-                }
+            // Upgrade field intensity
+            if( cur.intensity_upgrade_chance() > 0 &&
+                one_in( cur.intensity_upgrade_chance() ) &&
+                cur.intensity_upgrade_duration() > 0_turns &&
+                calendar::once_every( cur.intensity_upgrade_duration() ) ) {
+                cur.set_field_intensity( cur.get_field_intensity() + 1 );
+            }
 
-                const field_type &cur_fd_type = *cur_fd_type_id;
+            int part;
+            const ter_t &ter = map_tile.get_ter_t();
+            // Dissipate faster in water
+            if( ter.has_flag( TFLAG_SWIMMABLE ) ) {
+                cur.mod_field_age( cur.get_underwater_age_speedup() );
+            }
+            if( cur_fd_type_id == fd_acid ) {
+                // Try to fall by a z-level
+                if( zlevels && p.z > -OVERMAP_DEPTH ) {
+                    tripoint dst{ p.xy(), p.z - 1 };
+                    if( valid_move( p, dst, true, true ) ) {
+                        field_entry *acid_there = field_at( dst ).find_field( fd_acid );
+                        if( acid_there == nullptr ) {
+                            add_field( dst, fd_acid, cur.get_field_intensity(), cur.get_field_age() );
+                        } else {
+                            // Math can be a bit off,
+                            // but "boiling" falling acid can be allowed to be stronger
+                            // than acid that just lies there
+                            const int sum_intensity = cur.get_field_intensity() + acid_there->get_field_intensity();
+                            const int new_intensity = std::min( 3, sum_intensity );
+                            // No way to get precise elapsed time, let's always reset
+                            // Allow falling acid to last longer than regular acid to show it off
+                            const time_duration new_age = -1_minutes * ( sum_intensity - new_intensity );
+                            acid_there->set_field_intensity( new_intensity );
+                            acid_there->set_field_age( new_age );
+                        }
 
-                // Upgrade field intensity
-                if( cur.intensity_upgrade_chance() > 0 &&
-                    one_in( cur.intensity_upgrade_chance() ) &&
-                    cur.intensity_upgrade_duration() > 0_turns &&
-                    calendar::once_every( cur.intensity_upgrade_duration() ) ) {
-                    cur.set_field_intensity( cur.get_field_intensity() + 1 );
+                        // Set ourselves up for removal
+                        cur.set_field_intensity( 0 );
+                    }
                 }
-
-                int part;
+                // TODO: Allow spreading to the sides if age < 0 && intensity == 3
+            }
+            if( cur_fd_type.apply_slime_factor > 0 ) {
+                sblk.apply_slime( p, cur.get_field_intensity() * cur_fd_type.apply_slime_factor );
+            }
+            if( cur_fd_type_id == fd_fire ) {
+                cur.set_field_age( std::max( -24_hours, cur.get_field_age() ) );
+                // Entire objects for ter/frn for flags
                 const ter_t &ter = map_tile.get_ter_t();
-                // Dissipate faster in water
-                if( ter.has_flag( TFLAG_SWIMMABLE ) ) {
-                    cur.mod_field_age( cur.get_underwater_age_speedup() );
-                }
-                if( cur_fd_type_id == fd_acid ) {
-                    // Try to fall by a z-level
-                    if( zlevels && p.z > -OVERMAP_DEPTH ) {
-                        tripoint dst{ p.xy(), p.z - 1 };
-                        if( valid_move( p, dst, true, true ) ) {
-                            field_entry *acid_there = field_at( dst ).find_field( fd_acid );
-                            if( acid_there == nullptr ) {
-                                add_field( dst, fd_acid, cur.get_field_intensity(), cur.get_field_age() );
-                            } else {
-                                // Math can be a bit off,
-                                // but "boiling" falling acid can be allowed to be stronger
-                                // than acid that just lies there
-                                const int sum_intensity = cur.get_field_intensity() + acid_there->get_field_intensity();
-                                const int new_intensity = std::min( 3, sum_intensity );
-                                // No way to get precise elapsed time, let's always reset
-                                // Allow falling acid to last longer than regular acid to show it off
-                                const time_duration new_age = -1_minutes * ( sum_intensity - new_intensity );
-                                acid_there->set_field_intensity( new_intensity );
-                                acid_there->set_field_age( new_age );
+                const furn_t &frn = map_tile.get_furn_t();
+
+                // We've got ter/furn cached, so let's use that
+                const bool is_sealed = ter_furn_has_flag( ter, frn, TFLAG_SEALED ) &&
+                                       !ter_furn_has_flag( ter, frn, TFLAG_ALLOW_FIELD_EFFECT );
+                // Consumed items count
+                int consumed = 0;
+                // How much time to add to the fire's life due to burned items/terrain/furniture
+                time_duration time_added = 0_turns;
+                // Checks if the fire can spread
+                const bool can_spread = !ter_furn_has_flag( ter, frn, TFLAG_FIRE_CONTAINER );
+                const bool no_floor = ter.has_flag( TFLAG_NO_FLOOR );
+                // If the flames are in furniture with fire_container flag like brazier or oven,
+                // they're fully contained, so skip consuming terrain
+                const bool can_burn = !no_floor && can_spread &&
+                                      ( check_flammable( ter ) || check_flammable( frn ) );
+                // The huge indent below should probably be somehow moved away from here
+                // without forcing the function to use i_at( p ) for fires without items
+                if( !is_sealed && map_tile.get_item_count() > 0 ) {
+                    map_stack items_here = i_at( p );
+                    std::vector<item> new_content;
+                    for( auto explosive = items_here.begin(); explosive != items_here.end(); ) {
+                        if( explosive->will_explode_in_fire() ) {
+                            // We need to make a copy because the iterator validity is not predictable
+                            item copy = *explosive;
+                            explosive = items_here.erase( explosive );
+                            if( copy.detonate( p, new_content ) ) {
+                                // Need to restart, iterators may not be valid
+                                explosive = items_here.begin();
                             }
-
-                            // Set ourselves up for removal
-                            cur.set_field_intensity( 0 );
+                        } else {
+                            ++explosive;
                         }
                     }
-                    // TODO: Allow spreading to the sides if age < 0 && intensity == 3
-                }
-                if( cur_fd_type.apply_slime_factor > 0 ) {
-                    sblk.apply_slime( p, cur.get_field_intensity() * cur_fd_type.apply_slime_factor );
-                }
-                if( cur_fd_type_id == fd_fire ) {
-                    cur.set_field_age( std::max( -24_hours, cur.get_field_age() ) );
-                    // Entire objects for ter/frn for flags
-                    const ter_t &ter = map_tile.get_ter_t();
-                    const furn_t &frn = map_tile.get_furn_t();
-
-                    // We've got ter/furn cached, so let's use that
-                    const bool is_sealed = ter_furn_has_flag( ter, frn, TFLAG_SEALED ) &&
-                                           !ter_furn_has_flag( ter, frn, TFLAG_ALLOW_FIELD_EFFECT );
-                    // Consumed items count
-                    int consumed = 0;
-                    // How much time to add to the fire's life due to burned items/terrain/furniture
-                    time_duration time_added = 0_turns;
-                    // Checks if the fire can spread
-                    const bool can_spread = !ter_furn_has_flag( ter, frn, TFLAG_FIRE_CONTAINER );
-                    const bool no_floor = ter.has_flag( TFLAG_NO_FLOOR );
-                    // If the flames are in furniture with fire_container flag like brazier or oven,
-                    // they're fully contained, so skip consuming terrain
-                    const bool can_burn = !no_floor && can_spread &&
-                                          ( check_flammable( ter ) || check_flammable( frn ) );
-                    // The huge indent below should probably be somehow moved away from here
-                    // without forcing the function to use i_at( p ) for fires without items
-                    if( !is_sealed && map_tile.get_item_count() > 0 ) {
-                        map_stack items_here = i_at( p );
-                        std::vector<item> new_content;
-                        for( auto explosive = items_here.begin(); explosive != items_here.end(); ) {
-                            if( explosive->will_explode_in_fire() ) {
-                                // We need to make a copy because the iterator validity is not predictable
-                                item copy = *explosive;
-                                explosive = items_here.erase( explosive );
-                                if( copy.detonate( p, new_content ) ) {
-                                    // Need to restart, iterators may not be valid
-                                    explosive = items_here.begin();
-                                }
-                            } else {
-                                ++explosive;
-                            }
-                        }
 
-                        fire_data frd( cur.get_field_intensity(), !can_spread );
-                        // The highest # of items this fire can remove in one turn
-                        int max_consume = cur.get_field_intensity() * 2;
-
-                        for( auto fuel = items_here.begin(); fuel != items_here.end() && consumed < max_consume; ) {
-                            // `item::burn` modifies the charges in order to simulate some of them getting
-                            // destroyed by the fire, this changes the item weight, but may not actually
-                            // destroy it. We need to spawn products anyway.
-                            const units::mass old_weight = fuel->weight( false );
-                            bool destroyed = fuel->burn( frd );
-                            // If the item is considered destroyed, it may have negative charge count,
-                            // see `item::burn?. This in turn means `item::weight` returns a negative value,
-                            // which we can not use, so only call `weight` when it's still an existing item.
-                            const units::mass new_weight = destroyed ? 0_gram : fuel->weight( false );
-                            if( old_weight != new_weight ) {
-                                create_burnproducts( p, *fuel, old_weight - new_weight );
-                            }
+                    fire_data frd( cur.get_field_intensity(), !can_spread );
+                    // The highest # of items this fire can remove in one turn
+                    int max_consume = cur.get_field_intensity() * 2;
+
+                    for( auto fuel = items_here.begin(); fuel != items_here.end() && consumed < max_consume; ) {
+                        // `item::burn` modifies the charges in order to simulate some of them getting
+                        // destroyed by the fire, this changes the item weight, but may not actually
+                        // destroy it. We need to spawn products anyway.
+                        const units::mass old_weight = fuel->weight( false );
+                        bool destroyed = fuel->burn( frd );
+                        // If the item is considered destroyed, it may have negative charge count,
+                        // see `item::burn?. This in turn means `item::weight` returns a negative value,
+                        // which we can not use, so only call `weight` when it's still an existing item.
+                        const units::mass new_weight = destroyed ? 0_gram : fuel->weight( false );
+                        if( old_weight != new_weight ) {
+                            create_burnproducts( p, *fuel, old_weight - new_weight );
+                        }
 
-                            if( destroyed ) {
-                                // If we decided the item was destroyed by fire, remove it.
-                                // But remember its contents, except for irremovable mods, if any
-                                const std::list<item *> content_list = fuel->contents.all_items_top();
-                                for( item *it : content_list ) {
-                                    if( !it->is_irremovable() ) {
-                                        new_content.push_back( item( *it ) );
-                                    }
+                        if( destroyed ) {
+                            // If we decided the item was destroyed by fire, remove it.
+                            // But remember its contents, except for irremovable mods, if any
+                            const std::list<item *> content_list = fuel->contents.all_items_top();
+                            for( item *it : content_list ) {
+                                if( !it->is_irremovable() ) {
+                                    new_content.push_back( item( *it ) );
                                 }
-                                fuel = items_here.erase( fuel );
-                                consumed++;
-                            } else {
-                                ++fuel;
                             }
+                            fuel = items_here.erase( fuel );
+                            consumed++;
+                        } else {
+                            ++fuel;
                         }
-
-                        spawn_items( p, new_content );
-                        time_added = 1_turns * roll_remainder( frd.fuel_produced );
                     }
 
-                    // Get the part of the vehicle in the fire (_internal skips the boundary check)
-                    vehicle *veh = veh_at_internal( p, part );
-                    if( veh != nullptr ) {
-                        veh->damage( part, cur.get_field_intensity() * 10, DT_HEAT, true );
-                        // Damage the vehicle in the fire.
-                    }
-                    if( can_burn ) {
-                        if( ter.has_flag( TFLAG_SWIMMABLE ) ) {
-                            // Flames die quickly on water
-                            cur.set_field_age( cur.get_field_age() + 4_minutes );
-                        }
+                    spawn_items( p, new_content );
+                    time_added = 1_turns * roll_remainder( frd.fuel_produced );
+                }
 
-                        // Consume the terrain we're on
-                        if( ter_furn_has_flag( ter, frn, TFLAG_FLAMMABLE ) ) {
-                            // The fire feeds on the ground itself until max intensity.
-                            time_added += 1_turns * ( 5 - cur.get_field_intensity() );
-                            if( cur.get_field_intensity() > 1 &&
-                                one_in( 200 - cur.get_field_intensity() * 50 ) ) {
-                                destroy( p, false );
-                            }
+                // Get the part of the vehicle in the fire (_internal skips the boundary check)
+                vehicle *veh = veh_at_internal( p, part );
+                if( veh != nullptr ) {
+                    veh->damage( part, cur.get_field_intensity() * 10, DT_HEAT, true );
+                    // Damage the vehicle in the fire.
+                }
+                if( can_burn ) {
+                    if( ter.has_flag( TFLAG_SWIMMABLE ) ) {
+                        // Flames die quickly on water
+                        cur.set_field_age( cur.get_field_age() + 4_minutes );
+                    }
 
-                        } else if( ter_furn_has_flag( ter, frn, TFLAG_FLAMMABLE_HARD ) &&
-                                   one_in( 3 ) ) {
-                            // The fire feeds on the ground itself until max intensity.
-                            time_added += 1_turns * ( 4 - cur.get_field_intensity() );
-                            if( cur.get_field_intensity() > 1 &&
-                                one_in( 200 - cur.get_field_intensity() * 50 ) ) {
-                                destroy( p, false );
-                            }
+                    // Consume the terrain we're on
+                    if( ter_furn_has_flag( ter, frn, TFLAG_FLAMMABLE ) ) {
+                        // The fire feeds on the ground itself until max intensity.
+                        time_added += 1_turns * ( 5 - cur.get_field_intensity() );
+                        if( cur.get_field_intensity() > 1 &&
+                            one_in( 200 - cur.get_field_intensity() * 50 ) ) {
+                            destroy( p, false );
+                        }
 
-                        } else if( ter.has_flag( TFLAG_FLAMMABLE_ASH ) ) {
-                            // The fire feeds on the ground itself until max intensity.
-                            time_added += 1_turns * ( 5 - cur.get_field_intensity() );
-                            if( cur.get_field_intensity() > 1 &&
-                                one_in( 200 - cur.get_field_intensity() * 50 ) ) {
-                                if( p.z > 0 ) {
-                                    // We're in the air
-                                    ter_set( p, t_open_air );
-                                } else {
-                                    ter_set( p, t_dirt );
-                                }
-                            }
+                    } else if( ter_furn_has_flag( ter, frn, TFLAG_FLAMMABLE_HARD ) &&
+                               one_in( 3 ) ) {
+                        // The fire feeds on the ground itself until max intensity.
+                        time_added += 1_turns * ( 4 - cur.get_field_intensity() );
+                        if( cur.get_field_intensity() > 1 &&
+                            one_in( 200 - cur.get_field_intensity() * 50 ) ) {
+                            destroy( p, false );
+                        }
 
-                        } else if( frn.has_flag( TFLAG_FLAMMABLE_ASH ) ) {
-                            // The fire feeds on the ground itself until max intensity.
-                            time_added += 1_turns * ( 5 - cur.get_field_intensity() );
-                            if( cur.get_field_intensity() > 1 &&
-                                one_in( 200 - cur.get_field_intensity() * 50 ) ) {
-                                furn_set( p, f_ash );
+                    } else if( ter.has_flag( TFLAG_FLAMMABLE_ASH ) ) {
+                        // The fire feeds on the ground itself until max intensity.
+                        time_added += 1_turns * ( 5 - cur.get_field_intensity() );
+                        if( cur.get_field_intensity() > 1 &&
+                            one_in( 200 - cur.get_field_intensity() * 50 ) ) {
+                            if( p.z > 0 ) {
+                                // We're in the air
+                                ter_set( p, t_open_air );
+                            } else {
+                                ter_set( p, t_dirt );
                             }
+                        }
 
+                    } else if( frn.has_flag( TFLAG_FLAMMABLE_ASH ) ) {
+                        // The fire feeds on the ground itself until max intensity.
+                        time_added += 1_turns * ( 5 - cur.get_field_intensity() );
+                        if( cur.get_field_intensity() > 1 &&
+                            one_in( 200 - cur.get_field_intensity() * 50 ) ) {
+                            furn_set( p, f_ash );
                         }
+
                     }
+                }
 
-                    if( ter.has_flag( TFLAG_NO_FLOOR ) && zlevels && p.z > -OVERMAP_DEPTH ) {
-                        // We're hanging in the air - let's fall down
-                        tripoint dst{ p.xy(), p.z - 1 };
-                        if( valid_move( p, dst, true, true ) ) {
-                            maptile dst_tile = maptile_at_internal( dst );
-                            field_entry *fire_there = dst_tile.find_field( fd_fire );
-                            if( fire_there == nullptr ) {
-                                add_field( dst, fd_fire, 1, 0_turns, false );
+                if( ter.has_flag( TFLAG_NO_FLOOR ) && zlevels && p.z > -OVERMAP_DEPTH ) {
+                    // We're hanging in the air - let's fall down
+                    tripoint dst{ p.xy(), p.z - 1 };
+                    if( valid_move( p, dst, true, true ) ) {
+                        maptile dst_tile = maptile_at_internal( dst );
+                        field_entry *fire_there = dst_tile.find_field( fd_fire );
+                        if( fire_there == nullptr ) {
+                            add_field( dst, fd_fire, 1, 0_turns, false );
+                            cur.set_field_intensity( cur.get_field_intensity() - 1 );
+                        } else {
+                            // Don't fuel raging fires or they'll burn forever
+                            // as they can produce small fires above themselves
+                            int new_intensity = std::max( cur.get_field_intensity(),
+                                                          fire_there->get_field_intensity() );
+                            // Allow smaller fires to combine
+                            if( new_intensity < 3 &&
+                                cur.get_field_intensity() == fire_there->get_field_intensity() ) {
+                                new_intensity++;
+                            }
+                            // A raging fire below us can support us for a while
+                            // Otherwise decay and decay fast
+                            if( fire_there->get_field_intensity() < 3 || one_in( 10 ) ) {
                                 cur.set_field_intensity( cur.get_field_intensity() - 1 );
-                            } else {
-                                // Don't fuel raging fires or they'll burn forever
-                                // as they can produce small fires above themselves
-                                int new_intensity = std::max( cur.get_field_intensity(),
-                                                              fire_there->get_field_intensity() );
-                                // Allow smaller fires to combine
-                                if( new_intensity < 3 &&
-                                    cur.get_field_intensity() == fire_there->get_field_intensity() ) {
-                                    new_intensity++;
-                                }
-                                // A raging fire below us can support us for a while
-                                // Otherwise decay and decay fast
-                                if( fire_there->get_field_intensity() < 3 || one_in( 10 ) ) {
-                                    cur.set_field_intensity( cur.get_field_intensity() - 1 );
-                                }
-                                fire_there->set_field_intensity( new_intensity );
                             }
-                            break;
+                            fire_there->set_field_intensity( new_intensity );
                         }
+                        break;
                     }
-                    // Lower age is a longer lasting fire
-                    if( time_added != 0_turns ) {
-                        cur.set_field_age( cur.get_field_age() - time_added );
-                    } else if( can_burn ) {
-                        // Nothing to burn = fire should be dying out faster
-                        // Drain more power from big fires, so that they stop raging over nothing
-                        // Except for fires on stoves and fireplaces, those are made to keep the fire alive
-                        cur.mod_field_age( 10_seconds * cur.get_field_intensity() );
-                    }
+                }
+                // Lower age is a longer lasting fire
+                if( time_added != 0_turns ) {
+                    cur.set_field_age( cur.get_field_age() - time_added );
+                } else if( can_burn ) {
+                    // Nothing to burn = fire should be dying out faster
+                    // Drain more power from big fires, so that they stop raging over nothing
+                    // Except for fires on stoves and fireplaces, those are made to keep the fire alive
+                    cur.mod_field_age( 10_seconds * cur.get_field_intensity() );
+                }
 
-                    // Allow raging fires (and only raging fires) to spread up
-                    // Spreading down is achieved by wrecking the walls/floor and then falling
-                    if( zlevels && cur.get_field_intensity() == 3 && p.z < OVERMAP_HEIGHT ) {
-                        const tripoint dst_p = tripoint( p.xy(), p.z + 1 );
-                        // Let it burn through the floor
-                        maptile dst = maptile_at_internal( dst_p );
-                        const auto &dst_ter = dst.get_ter_t();
-                        if( dst_ter.has_flag( TFLAG_NO_FLOOR ) ||
-                            dst_ter.has_flag( TFLAG_FLAMMABLE ) ||
-                            dst_ter.has_flag( TFLAG_FLAMMABLE_ASH ) ||
-                            dst_ter.has_flag( TFLAG_FLAMMABLE_HARD ) ) {
-                            field_entry *nearfire = dst.find_field( fd_fire );
-                            if( nearfire != nullptr ) {
-                                nearfire->mod_field_age( -2_turns );
-                            } else {
-                                add_field( dst_p, fd_fire, 1, 0_turns, false );
-                            }
-                            // Fueling fires above doesn't cost fuel
+                // Allow raging fires (and only raging fires) to spread up
+                // Spreading down is achieved by wrecking the walls/floor and then falling
+                if( zlevels && cur.get_field_intensity() == 3 && p.z < OVERMAP_HEIGHT ) {
+                    const tripoint dst_p = tripoint( p.xy(), p.z + 1 );
+                    // Let it burn through the floor
+                    maptile dst = maptile_at_internal( dst_p );
+                    const auto &dst_ter = dst.get_ter_t();
+                    if( dst_ter.has_flag( TFLAG_NO_FLOOR ) ||
+                        dst_ter.has_flag( TFLAG_FLAMMABLE ) ||
+                        dst_ter.has_flag( TFLAG_FLAMMABLE_ASH ) ||
+                        dst_ter.has_flag( TFLAG_FLAMMABLE_HARD ) ) {
+                        field_entry *nearfire = dst.find_field( fd_fire );
+                        if( nearfire != nullptr ) {
+                            nearfire->mod_field_age( -2_turns );
+                        } else {
+                            add_field( dst_p, fd_fire, 1, 0_turns, false );
                         }
+                        // Fueling fires above doesn't cost fuel
                     }
+                }
 
-                    // Below we will access our nearest 8 neighbors, so let's cache them now
-                    // This should probably be done more globally, because large fires will re-do it a lot
-                    auto neighs = get_neighbors( p );
-
-                    // If the flames are in a pit, it can't spread to non-pit
-                    const bool in_pit = can_spread && ter.id.id() == t_pit;
-
-                    // Count adjacent fires, to optimize out needless smoke and hot air
-                    int adjacent_fires = 0;
-
-                    // If the flames are big, they contribute to adjacent flames
-                    if( can_spread ) {
-                        if( cur.get_field_intensity() > 1 && one_in( 3 ) ) {
-                            // Basically: Scan around for a spot,
-                            // if there is more fire there, make it bigger and give it some fuel.
-                            // This is how big fires spend their excess age:
-                            // making other fires bigger. Flashpoint.
-                            size_t end_it = static_cast<size_t>( rng( 0, neighs.size() - 1 ) );
-                            for( size_t i = ( end_it + 1 ) % neighs.size(), count = 0;
-                                 count != neighs.size() && cur.get_field_age() < 0_turns;
-                                 i = ( i + 1 ) % neighs.size(), count++ ) {
-                                maptile &dst = neighs[i].second;
-                                auto dstfld = dst.find_field( fd_fire );
-                                // If the fire exists and is weaker than ours, boost it
-                                if( dstfld != nullptr &&
-                                    ( dstfld->get_field_intensity() <= cur.get_field_intensity() ||
-                                      dstfld->get_field_age() > cur.get_field_age() ) &&
-                                    ( in_pit == ( dst.get_ter() == t_pit ) ) ) {
-                                    if( dstfld->get_field_intensity() < 2 ) {
-                                        dstfld->set_field_intensity( dstfld->get_field_intensity() + 1 );
-                                    }
-
-                                    dstfld->set_field_age( dstfld->get_field_age() - 5_minutes );
-                                    cur.set_field_age( cur.get_field_age() + 5_minutes );
+                // Below we will access our nearest 8 neighbors, so let's cache them now
+                // This should probably be done more globally, because large fires will re-do it a lot
+                auto neighs = get_neighbors( p );
+
+                // If the flames are in a pit, it can't spread to non-pit
+                const bool in_pit = can_spread && ter.id.id() == t_pit;
+
+                // Count adjacent fires, to optimize out needless smoke and hot air
+                int adjacent_fires = 0;
+
+                // If the flames are big, they contribute to adjacent flames
+                if( can_spread ) {
+                    if( cur.get_field_intensity() > 1 && one_in( 3 ) ) {
+                        // Basically: Scan around for a spot,
+                        // if there is more fire there, make it bigger and give it some fuel.
+                        // This is how big fires spend their excess age:
+                        // making other fires bigger. Flashpoint.
+                        size_t end_it = static_cast<size_t>( rng( 0, neighs.size() - 1 ) );
+                        for( size_t i = ( end_it + 1 ) % neighs.size(), count = 0;
+                             count != neighs.size() && cur.get_field_age() < 0_turns;
+                             i = ( i + 1 ) % neighs.size(), count++ ) {
+                            maptile &dst = neighs[i].second;
+                            auto dstfld = dst.find_field( fd_fire );
+                            // If the fire exists and is weaker than ours, boost it
+                            if( dstfld != nullptr &&
+                                ( dstfld->get_field_intensity() <= cur.get_field_intensity() ||
+                                  dstfld->get_field_age() > cur.get_field_age() ) &&
+                                ( in_pit == ( dst.get_ter() == t_pit ) ) ) {
+                                if( dstfld->get_field_intensity() < 2 ) {
+                                    dstfld->set_field_intensity( dstfld->get_field_intensity() + 1 );
                                 }
-                                if( dstfld != nullptr ) {
+
+                                dstfld->set_field_age( dstfld->get_field_age() - 5_minutes );
+                                cur.set_field_age( cur.get_field_age() + 5_minutes );
+                            }
+                            if( dstfld != nullptr ) {
+                                adjacent_fires++;
+                            }
+                        }
+                    } else if( cur.get_field_age() < 0_turns && cur.get_field_intensity() < 3 ) {
+                        // See if we can grow into a stage 2/3 fire, for this
+                        // burning neighbors are necessary in addition to
+                        // field age < 0, or alternatively, a LOT of fuel.
+
+                        // The maximum fire intensity is 1 for a lone fire, 2 for at least 1 neighbor,
+                        // 3 for at least 2 neighbors.
+                        int maximum_intensity = 1;
+
+                        // The following logic looks a bit complex due to optimization concerns, so here are the semantics:
+                        // 1. Calculate maximum field intensity based on fuel, -50 minutes is 2(medium), -500 minutes is 3(raging)
+                        // 2. Calculate maximum field intensity based on neighbors, 3 neighbors is 2(medium), 7 or more neighbors is 3(raging)
+                        // 3. Pick the higher maximum between 1. and 2.
+                        if( cur.get_field_age() < -500_minutes ) {
+                            maximum_intensity = 3;
+                        } else {
+                            for( auto &neigh : neighs ) {
+                                if( neigh.second.get_field().find_field( fd_fire ) != nullptr ) {
                                     adjacent_fires++;
                                 }
                             }
-                        } else if( cur.get_field_age() < 0_turns && cur.get_field_intensity() < 3 ) {
-                            // See if we can grow into a stage 2/3 fire, for this
-                            // burning neighbors are necessary in addition to
-                            // field age < 0, or alternatively, a LOT of fuel.
-
-                            // The maximum fire intensity is 1 for a lone fire, 2 for at least 1 neighbor,
-                            // 3 for at least 2 neighbors.
-                            int maximum_intensity = 1;
-
-                            // The following logic looks a bit complex due to optimization concerns, so here are the semantics:
-                            // 1. Calculate maximum field intensity based on fuel, -50 minutes is 2(medium), -500 minutes is 3(raging)
-                            // 2. Calculate maximum field intensity based on neighbors, 3 neighbors is 2(medium), 7 or more neighbors is 3(raging)
-                            // 3. Pick the higher maximum between 1. and 2.
-                            if( cur.get_field_age() < -500_minutes ) {
-                                maximum_intensity = 3;
-                            } else {
-                                for( auto &neigh : neighs ) {
-                                    if( neigh.second.get_field().find_field( fd_fire ) != nullptr ) {
-                                        adjacent_fires++;
-                                    }
-                                }
-                                maximum_intensity = 1 + ( adjacent_fires >= 3 ) + ( adjacent_fires >= 7 );
+                            maximum_intensity = 1 + ( adjacent_fires >= 3 ) + ( adjacent_fires >= 7 );
 
-                                if( maximum_intensity < 2 && cur.get_field_age() < -50_minutes ) {
-                                    maximum_intensity = 2;
-                                }
+                            if( maximum_intensity < 2 && cur.get_field_age() < -50_minutes ) {
+                                maximum_intensity = 2;
                             }
+                        }
 
-                            // If we consumed a lot, the flames grow higher
-                            if( cur.get_field_intensity() < maximum_intensity && cur.get_field_age() < 0_turns ) {
-                                // Fires under 0 age grow in size. Level 3 fires under 0 spread later on.
-                                // Weaken the newly-grown fire
-                                cur.set_field_intensity( cur.get_field_intensity() + 1 );
-                                cur.set_field_age( cur.get_field_age() + 10_minutes * cur.get_field_intensity() );
-                            }
+                        // If we consumed a lot, the flames grow higher
+                        if( cur.get_field_intensity() < maximum_intensity && cur.get_field_age() < 0_turns ) {
+                            // Fires under 0 age grow in size. Level 3 fires under 0 spread later on.
+                            // Weaken the newly-grown fire
+                            cur.set_field_intensity( cur.get_field_intensity() + 1 );
+                            cur.set_field_age( cur.get_field_age() + 10_minutes * cur.get_field_intensity() );
                         }
+                    }
 
-                        // Consume adjacent fuel / terrain / webs to spread.
-                        // Our iterator will start at end_i + 1 and increment from there and then wrap around.
-                        // This guarantees it will check all neighbors, starting from a random one
-                        const size_t end_i = static_cast<size_t>( rng( 0, neighs.size() - 1 ) );
-                        for( size_t i = ( end_i + 1 ) % neighs.size(), count = 0;
-                             count != neighs.size();
-                             i = ( i + 1 ) % neighs.size(), count++ ) {
-                            if( one_in( cur.get_field_intensity() * 2 ) ) {
-                                // Skip some processing to save on CPU
-                                continue;
-                            }
+                    // Consume adjacent fuel / terrain / webs to spread.
+                    // Our iterator will start at end_i + 1 and increment from there and then wrap around.
+                    // This guarantees it will check all neighbors, starting from a random one
+                    const size_t end_i = static_cast<size_t>( rng( 0, neighs.size() - 1 ) );
+                    for( size_t i = ( end_i + 1 ) % neighs.size(), count = 0;
+                         count != neighs.size();
+                         i = ( i + 1 ) % neighs.size(), count++ ) {
+                        if( one_in( cur.get_field_intensity() * 2 ) ) {
+                            // Skip some processing to save on CPU
+                            continue;
+                        }
 
-                            tripoint &dst_p = neighs[i].first;
-                            maptile &dst = neighs[i].second;
-                            // No bounds checking here: we'll treat the invalid neighbors as valid.
-                            // We're using the map tile wrapper, so we can treat invalid tiles as sentinels.
-                            // This will create small oddities on map edges, but nothing more noticeable than
-                            // "cut-off" that happens with bounds checks.
-
-                            field_entry *nearfire = dst.find_field( fd_fire );
-                            if( nearfire != nullptr ) {
-                                // We handled supporting fires in the section above, no need to do it here
-                                continue;
-                            }
+                        tripoint &dst_p = neighs[i].first;
+                        maptile &dst = neighs[i].second;
+                        // No bounds checking here: we'll treat the invalid neighbors as valid.
+                        // We're using the map tile wrapper, so we can treat invalid tiles as sentinels.
+                        // This will create small oddities on map edges, but nothing more noticeable than
+                        // "cut-off" that happens with bounds checks.
 
-                            field_entry *nearwebfld = dst.find_field( fd_web );
-                            int spread_chance = 25 * ( cur.get_field_intensity() - 1 );
-                            if( nearwebfld != nullptr ) {
-                                spread_chance = 50 + spread_chance / 2;
-                            }
+                        field_entry *nearfire = dst.find_field( fd_fire );
+                        if( nearfire != nullptr ) {
+                            // We handled supporting fires in the section above, no need to do it here
+                            continue;
+                        }
 
-                            const ter_t &dster = dst.get_ter_t();
-                            const furn_t &dsfrn = dst.get_furn_t();
-                            // Allow weaker fires to spread occasionally
-                            const int power = cur.get_field_intensity() + one_in( 5 );
-                            if( can_spread && rng( 1, 100 ) < spread_chance &&
-                                ( check_flammable( dster ) || check_flammable( dsfrn ) ) &&
-                                ( in_pit == ( dster.id.id() == t_pit ) ) &&
-                                (
-                                    ( power >= 3 && cur.get_field_age() < 0_turns && one_in( 20 ) ) ||
-                                    ( power >= 2 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE ) && one_in( 2 ) ) ) ||
-                                    ( power >= 2 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE_ASH ) && one_in( 2 ) ) ) ||
-                                    ( power >= 3 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE_HARD ) && one_in( 5 ) ) ) ||
-                                    nearwebfld || ( dst.get_item_count() > 0 &&
-                                                    flammable_items_at( p + eight_horizontal_neighbors[i] ) &&
-                                                    one_in( 5 ) )
-                                ) ) {
-                                // Nearby open flammable ground? Set it on fire.
-                                add_field( dst_p, fd_fire, 1, 0_turns, false );
-                                tmpfld = dst.find_field( fd_fire );
-                                if( tmpfld != nullptr ) {
-                                    // Make the new fire quite weak, so that it doesn't start jumping around instantly
-                                    tmpfld->set_field_age( 2_minutes );
-                                    // Consume a bit of our fuel
-                                    cur.set_field_age( cur.get_field_age() + 1_minutes );
-                                }
-                                if( nearwebfld ) {
-                                    nearwebfld->set_field_intensity( 0 );
-                                }
+                        field_entry *nearwebfld = dst.find_field( fd_web );
+                        int spread_chance = 25 * ( cur.get_field_intensity() - 1 );
+                        if( nearwebfld != nullptr ) {
+                            spread_chance = 50 + spread_chance / 2;
+                        }
+
+                        const ter_t &dster = dst.get_ter_t();
+                        const furn_t &dsfrn = dst.get_furn_t();
+                        // Allow weaker fires to spread occasionally
+                        const int power = cur.get_field_intensity() + one_in( 5 );
+                        if( can_spread && rng( 1, 100 ) < spread_chance &&
+                            ( check_flammable( dster ) || check_flammable( dsfrn ) ) &&
+                            ( in_pit == ( dster.id.id() == t_pit ) ) &&
+                            (
+                                ( power >= 3 && cur.get_field_age() < 0_turns && one_in( 20 ) ) ||
+                                ( power >= 2 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE ) && one_in( 2 ) ) ) ||
+                                ( power >= 2 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE_ASH ) && one_in( 2 ) ) ) ||
+                                ( power >= 3 && ( ter_furn_has_flag( dster, dsfrn, TFLAG_FLAMMABLE_HARD ) && one_in( 5 ) ) ) ||
+                                nearwebfld || ( dst.get_item_count() > 0 &&
+                                                flammable_items_at( p + eight_horizontal_neighbors[i] ) &&
+                                                one_in( 5 ) )
+                            ) ) {
+                            // Nearby open flammable ground? Set it on fire.
+                            add_field( dst_p, fd_fire, 1, 0_turns, false );
+                            tmpfld = dst.find_field( fd_fire );
+                            if( tmpfld != nullptr ) {
+                                // Make the new fire quite weak, so that it doesn't start jumping around instantly
+                                tmpfld->set_field_age( 2_minutes );
+                                // Consume a bit of our fuel
+                                cur.set_field_age( cur.get_field_age() + 1_minutes );
+                            }
+                            if( nearwebfld ) {
+                                nearwebfld->set_field_intensity( 0 );
                             }
                         }
                     }
                 }
+            }
 
-                // Spread gaseous fields
-                if( cur.gas_can_spread() ) {
-                    const int gas_percent_spread = cur_fd_type.percent_spread;
-                    if( gas_percent_spread > 0 ) {
-                        const time_duration outdoor_age_speedup = cur_fd_type.outdoor_age_speedup;
-                        spread_gas( cur, p, gas_percent_spread, outdoor_age_speedup, sblk );
-                    }
+            // Spread gaseous fields
+            if( cur.gas_can_spread() ) {
+                const int gas_percent_spread = cur_fd_type.percent_spread;
+                if( gas_percent_spread > 0 ) {
+                    const time_duration outdoor_age_speedup = cur_fd_type.outdoor_age_speedup;
+                    spread_gas( cur, p, gas_percent_spread, outdoor_age_speedup, sblk );
                 }
+            }
 
-                if( cur_fd_type_id == fd_fungal_haze ) {
-                    if( one_in( 10 - 2 * cur.get_field_intensity() ) ) {
-                        // Haze'd terrain
-                        fungal_effects( *g, here ).spread_fungus( p );
-                    }
+            if( cur_fd_type_id == fd_fungal_haze ) {
+                if( one_in( 10 - 2 * cur.get_field_intensity() ) ) {
+                    // Haze'd terrain
+                    fungal_effects( *g, here ).spread_fungus( p );
                 }
+            }
 
-                // Process npc complaints
-                const std::tuple<int, std::string, time_duration, std::string> &npc_complain_data =
-                    cur_fd_type.npc_complain_data;
-                const int chance = std::get<0>( npc_complain_data );
-                if( chance > 0 && one_in( chance ) ) {
-                    if( npc *const np = g->critter_at<npc>( p, false ) ) {
-                        np->complain_about( std::get<1>( npc_complain_data ),
-                                            std::get<2>( npc_complain_data ),
-                                            std::get<3>( npc_complain_data ) );
-                    }
+            // Process npc complaints
+            const std::tuple<int, std::string, time_duration, std::string> &npc_complain_data =
+                cur_fd_type.npc_complain_data;
+            const int chance = std::get<0>( npc_complain_data );
+            if( chance > 0 && one_in( chance ) ) {
+                if( npc *const np = g->critter_at<npc>( p, false ) ) {
+                    np->complain_about( std::get<1>( npc_complain_data ),
+                                        std::get<2>( npc_complain_data ),
+                                        std::get<3>( npc_complain_data ) );
                 }
+            }
 
-                // Apply radiation
-                if( cur.extra_radiation_max() > 0 ) {
-                    int extra_radiation = rng( cur.extra_radiation_min(), cur.extra_radiation_max() );
-                    adjust_radiation( p, extra_radiation );
-                }
+            // Apply radiation
+            if( cur.extra_radiation_max() > 0 ) {
+                int extra_radiation = rng( cur.extra_radiation_min(), cur.extra_radiation_max() );
+                adjust_radiation( p, extra_radiation );
+            }
 
-                // Apply wandering fields from vents
-                if( cur_fd_type.wandering_field ) {
-                    for( const tripoint &pnt : points_in_radius( p, cur.get_field_intensity() - 1 ) ) {
-                        field &wandering_field = get_field( pnt );
-                        tmpfld = wandering_field.find_field( cur_fd_type.wandering_field );
-                        if( tmpfld && tmpfld->get_field_intensity() < cur.get_field_intensity() ) {
-                            tmpfld->set_field_intensity( tmpfld->get_field_intensity() + 1 );
-                        } else {
-                            add_field( pnt, cur_fd_type.wandering_field, cur.get_field_intensity() );
-                        }
+            // Apply wandering fields from vents
+            if( cur_fd_type.wandering_field ) {
+                for( const tripoint &pnt : points_in_radius( p, cur.get_field_intensity() - 1 ) ) {
+                    field &wandering_field = get_field( pnt );
+                    tmpfld = wandering_field.find_field( cur_fd_type.wandering_field );
+                    if( tmpfld && tmpfld->get_field_intensity() < cur.get_field_intensity() ) {
+                        tmpfld->set_field_intensity( tmpfld->get_field_intensity() + 1 );
+                    } else {
+                        add_field( pnt, cur_fd_type.wandering_field, cur.get_field_intensity() );
                     }
                 }
+            }
 
-                if( cur_fd_type_id == fd_fire_vent ) {
+            if( cur_fd_type_id == fd_fire_vent ) {
 
-                    if( cur.get_field_intensity() > 1 ) {
-                        if( one_in( 3 ) ) {
-                            cur.set_field_intensity( cur.get_field_intensity() - 1 );
-                        }
-                        create_hot_air( p, cur.get_field_intensity() );
-                    } else {
-                        dirty_transparency_cache = true;
-                        add_field( p, fd_flame_burst, 3, cur.get_field_age() );
-                        cur.set_field_intensity( 0 );
-                    }
-                }
-                if( cur_fd_type_id == fd_flame_burst ) {
-                    if( cur.get_field_intensity() > 1 ) {
+                if( cur.get_field_intensity() > 1 ) {
+                    if( one_in( 3 ) ) {
                         cur.set_field_intensity( cur.get_field_intensity() - 1 );
-                        create_hot_air( p, cur.get_field_intensity() );
-                    } else {
-                        dirty_transparency_cache = true;
-                        add_field( p, fd_fire_vent, 3, cur.get_field_age() );
-                        cur.set_field_intensity( 0 );
                     }
+                    create_hot_air( p, cur.get_field_intensity() );
+                } else {
+                    dirty_transparency_cache = true;
+                    add_field( p, fd_flame_burst, 3, cur.get_field_age() );
+                    cur.set_field_intensity( 0 );
                 }
-                if( cur_fd_type_id == fd_electricity ) {
-                    // 4 in 5 chance to spread
-                    if( !one_in( 5 ) ) {
-                        std::vector<tripoint> valid;
-                        // We're grounded
-                        if( impassable( p ) && cur.get_field_intensity() > 1 ) {
-                            int tries = 0;
-                            tripoint pnt;
-                            pnt.z = p.z;
-                            while( tries < 10 && cur.get_field_age() < 5_minutes && cur.get_field_intensity() > 1 ) {
-                                pnt.x = p.x + rng( -1, 1 );
-                                pnt.y = p.y + rng( -1, 1 );
-                                if( passable( pnt ) && !obstructed_by_vehicle_rotation( p, pnt ) ) {
-                                    add_field( pnt, fd_electricity, 1, cur.get_field_age() + 1_turns );
-                                    cur.set_field_intensity( cur.get_field_intensity() - 1 );
-                                    tries = 0;
-                                } else {
-                                    tries++;
-                                }
-                            }
-                            // We're not grounded; attempt to ground
-                        } else {
-                            for( const tripoint &dst : points_in_radius( p, 1 ) ) {
-                                // Grounded tiles first
-                                if( impassable( dst ) ) {
-                                    valid.push_back( dst );
-                                }
-                            }
-                            // Spread to adjacent space, then
-                            if( valid.empty() ) {
-                                tripoint dst( p + point( rng( -1, 1 ), rng( -1, 1 ) ) );
-                                field_entry *elec = get_field( dst ).find_field( fd_electricity );
-                                bool pass = passable( dst ) && !obstructed_by_vehicle_rotation( p, dst );
-                                if( pass && elec != nullptr &&
-                                    elec->get_field_intensity() < 3 ) {
-                                    elec->set_field_intensity( elec->get_field_intensity() + 1 );
-                                    cur.set_field_intensity( cur.get_field_intensity() - 1 );
-                                } else if( pass ) {
-                                    add_field( dst, fd_electricity, 1, cur.get_field_age() + 1_turns );
-                                }
+            }
+            if( cur_fd_type_id == fd_flame_burst ) {
+                if( cur.get_field_intensity() > 1 ) {
+                    cur.set_field_intensity( cur.get_field_intensity() - 1 );
+                    create_hot_air( p, cur.get_field_intensity() );
+                } else {
+                    dirty_transparency_cache = true;
+                    add_field( p, fd_fire_vent, 3, cur.get_field_age() );
+                    cur.set_field_intensity( 0 );
+                }
+            }
+            if( cur_fd_type_id == fd_electricity ) {
+                // 4 in 5 chance to spread
+                if( !one_in( 5 ) ) {
+                    std::vector<tripoint> valid;
+                    // We're grounded
+                    if( impassable( p ) && cur.get_field_intensity() > 1 ) {
+                        int tries = 0;
+                        tripoint pnt;
+                        pnt.z = p.z;
+                        while( tries < 10 && cur.get_field_age() < 5_minutes && cur.get_field_intensity() > 1 ) {
+                            pnt.x = p.x + rng( -1, 1 );
+                            pnt.y = p.y + rng( -1, 1 );
+                            if( passable( pnt ) && !obstructed_by_vehicle_rotation( p, pnt ) ) {
+                                add_field( pnt, fd_electricity, 1, cur.get_field_age() + 1_turns );
                                 cur.set_field_intensity( cur.get_field_intensity() - 1 );
+                                tries = 0;
+                            } else {
+                                tries++;
                             }
-                            while( !valid.empty() && cur.get_field_intensity() > 1 ) {
-                                const tripoint target = random_entry_removed( valid );
-                                add_field( target, fd_electricity, 1, cur.get_field_age() + 1_turns );
+                        }
+                        // We're not grounded; attempt to ground
+                    } else {
+                        for( const tripoint &dst : points_in_radius( p, 1 ) ) {
+                            // Grounded tiles first
+                            if( impassable( dst ) ) {
+                                valid.push_back( dst );
+                            }
+                        }
+                        // Spread to adjacent space, then
+                        if( valid.empty() ) {
+                            tripoint dst( p + point( rng( -1, 1 ), rng( -1, 1 ) ) );
+                            field_entry *elec = get_field( dst ).find_field( fd_electricity );
+                            bool pass = passable( dst ) && !obstructed_by_vehicle_rotation( p, dst );
+                            if( pass && elec != nullptr &&
+                                elec->get_field_intensity() < 3 ) {
+                                elec->set_field_intensity( elec->get_field_intensity() + 1 );
                                 cur.set_field_intensity( cur.get_field_intensity() - 1 );
+                            } else if( pass ) {
+                                add_field( dst, fd_electricity, 1, cur.get_field_age() + 1_turns );
                             }
+                            cur.set_field_intensity( cur.get_field_intensity() - 1 );
+                        }
+                        while( !valid.empty() && cur.get_field_intensity() > 1 ) {
+                            const tripoint target = random_entry_removed( valid );
+                            add_field( target, fd_electricity, 1, cur.get_field_age() + 1_turns );
+                            cur.set_field_intensity( cur.get_field_intensity() - 1 );
                         }
                     }
                 }
+            }
 
-                int monster_spawn_chance = cur.monster_spawn_chance();
-                int monster_spawn_count = cur.monster_spawn_count();
-                if( monster_spawn_count > 0 && monster_spawn_chance > 0 && one_in( monster_spawn_chance ) ) {
-                    for( ; monster_spawn_count > 0; monster_spawn_count-- ) {
-                        MonsterGroupResult spawn_details = MonsterGroupManager::GetResultFromGroup(
-                                                               cur.monster_spawn_group(), &monster_spawn_count );
-                        if( !spawn_details.name ) {
-                            continue;
-                        }
-                        if( const std::optional<tripoint> spawn_point = random_point(
-                                    points_in_radius( p, cur.monster_spawn_radius() ),
-                        [this]( const tripoint & n ) {
-                        return passable( n );
-                        } ) ) {
-                            add_spawn( spawn_details.name, spawn_details.pack_size, *spawn_point );
-                        }
+            int monster_spawn_chance = cur.monster_spawn_chance();
+            int monster_spawn_count = cur.monster_spawn_count();
+            if( monster_spawn_count > 0 && monster_spawn_chance > 0 && one_in( monster_spawn_chance ) ) {
+                for( ; monster_spawn_count > 0; monster_spawn_count-- ) {
+                    MonsterGroupResult spawn_details = MonsterGroupManager::GetResultFromGroup(
+                                                           cur.monster_spawn_group(), &monster_spawn_count );
+                    if( !spawn_details.name ) {
+                        continue;
+                    }
+                    if( const std::optional<tripoint> spawn_point = random_point(
+                                points_in_radius( p, cur.monster_spawn_radius() ),
+                    [this]( const tripoint & n ) {
+                    return passable( n );
+                    } ) ) {
+                        add_spawn( spawn_details.name, spawn_details.pack_size, *spawn_point );
                     }
                 }
+            }
 
-                if( cur_fd_type_id == fd_push_items ) {
-                    map_stack items = i_at( p );
-                    for( auto pushee = items.begin(); pushee != items.end(); ) {
-                        if( pushee->typeId() != itype_rock ||
-                            pushee->age() < 1_turns ) {
-                            pushee++;
-                        } else {
-                            item tmp = *pushee;
-                            tmp.set_age( 0_turns );
-                            pushee = items.erase( pushee );
-                            std::vector<tripoint> valid;
-                            for( const tripoint &dst : points_in_radius( p, 1 ) ) {
-                                if( get_field( dst, fd_push_items ) != nullptr ) {
-                                    valid.push_back( dst );
-                                }
+            if( cur_fd_type_id == fd_push_items ) {
+                map_stack items = i_at( p );
+                for( auto pushee = items.begin(); pushee != items.end(); ) {
+                    if( pushee->typeId() != itype_rock ||
+                        pushee->age() < 1_turns ) {
+                        pushee++;
+                    } else {
+                        item tmp = *pushee;
+                        tmp.set_age( 0_turns );
+                        pushee = items.erase( pushee );
+                        std::vector<tripoint> valid;
+                        for( const tripoint &dst : points_in_radius( p, 1 ) ) {
+                            if( get_field( dst, fd_push_items ) != nullptr ) {
+                                valid.push_back( dst );
+                            }
+                        }
+                        if( !valid.empty() ) {
+                            tripoint newp = random_entry( valid );
+                            add_item_or_charges( newp, tmp );
+                            if( g->u.pos() == newp ) {
+                                add_msg( m_bad, _( "A %s hits you!" ), tmp.tname() );
+                                const bodypart_id hit = g->u.get_random_body_part();
+                                g->u.deal_damage( nullptr, hit, damage_instance( DT_BASH, 6 ) );
+                                g->u.check_dead_state();
                             }
-                            if( !valid.empty() ) {
-                                tripoint newp = random_entry( valid );
-                                add_item_or_charges( newp, tmp );
-                                if( g->u.pos() == newp ) {
-                                    add_msg( m_bad, _( "A %s hits you!" ), tmp.tname() );
-                                    const bodypart_id hit = g->u.get_random_body_part();
-                                    g->u.deal_damage( nullptr, hit, damage_instance( DT_BASH, 6 ) );
-                                    g->u.check_dead_state();
-                                }
 
-                                if( npc *const p = g->critter_at<npc>( newp ) ) {
-                                    // TODO: combine with player character code above
-                                    const bodypart_id hit = g->u.get_random_body_part();
-                                    p->deal_damage( nullptr, hit, damage_instance( DT_BASH, 6 ) );
-                                    if( g->u.sees( newp ) ) {
-                                        add_msg( _( "A %1$s hits %2$s!" ), tmp.tname(), p->name );
-                                    }
-                                    p->check_dead_state();
-                                } else if( monster *const mon = g->critter_at<monster>( newp ) ) {
-                                    mon->apply_damage( nullptr, bodypart_id( "torso" ),
-                                                       6 - mon->get_armor_bash( bodypart_id( "torso" ) ) );
-                                    if( g->u.sees( newp ) ) {
-                                        add_msg( _( "A %1$s hits the %2$s!" ), tmp.tname(), mon->name() );
-                                    }
-                                    mon->check_dead_state();
+                            if( npc *const p = g->critter_at<npc>( newp ) ) {
+                                // TODO: combine with player character code above
+                                const bodypart_id hit = g->u.get_random_body_part();
+                                p->deal_damage( nullptr, hit, damage_instance( DT_BASH, 6 ) );
+                                if( g->u.sees( newp ) ) {
+                                    add_msg( _( "A %1$s hits %2$s!" ), tmp.tname(), p->name );
                                 }
+                                p->check_dead_state();
+                            } else if( monster *const mon = g->critter_at<monster>( newp ) ) {
+                                mon->apply_damage( nullptr, bodypart_id( "torso" ),
+                                                   6 - mon->get_armor_bash( bodypart_id( "torso" ) ) );
+                                if( g->u.sees( newp ) ) {
+                                    add_msg( _( "A %1$s hits the %2$s!" ), tmp.tname(), mon->name() );
+                                }
+                                mon->check_dead_state();
                             }
                         }
                     }
                 }
-                if( cur_fd_type_id == fd_shock_vent ) {
-                    if( cur.get_field_intensity() > 1 ) {
-                        if( one_in( 5 ) ) {
-                            cur.set_field_intensity( cur.get_field_intensity() - 1 );
+            }
+            if( cur_fd_type_id == fd_shock_vent ) {
+                if( cur.get_field_intensity() > 1 ) {
+                    if( one_in( 5 ) ) {
+                        cur.set_field_intensity( cur.get_field_intensity() - 1 );
+                    }
+                } else {
+                    cur.set_field_intensity( 3 );
+                    int num_bolts = rng( 3, 6 );
+                    for( int i = 0; i < num_bolts; i++ ) {
+                        int xdir = 0;
+                        int ydir = 0;
+                        while( xdir == 0 && ydir == 0 ) {
+                            xdir = rng( -1, 1 );
+                            ydir = rng( -1, 1 );
                         }
-                    } else {
-                        cur.set_field_intensity( 3 );
-                        int num_bolts = rng( 3, 6 );
-                        for( int i = 0; i < num_bolts; i++ ) {
-                            int xdir = 0;
-                            int ydir = 0;
-                            while( xdir == 0 && ydir == 0 ) {
-                                xdir = rng( -1, 1 );
-                                ydir = rng( -1, 1 );
-                            }
-                            int dist = rng( 4, 12 );
-                            int boltx = p.x;
-                            int bolty = p.y;
-                            for( int n = 0; n < dist; n++ ) {
-                                boltx += xdir;
-                                bolty += ydir;
-                                add_field( tripoint( boltx, bolty, p.z ), fd_electricity, rng( 2, 3 ) );
-                                if( one_in( 4 ) ) {
-                                    if( xdir == 0 ) {
-                                        xdir = rng( 0, 1 ) * 2 - 1;
-                                    } else {
-                                        xdir = 0;
-                                    }
+                        int dist = rng( 4, 12 );
+                        int boltx = p.x;
+                        int bolty = p.y;
+                        for( int n = 0; n < dist; n++ ) {
+                            boltx += xdir;
+                            bolty += ydir;
+                            add_field( tripoint( boltx, bolty, p.z ), fd_electricity, rng( 2, 3 ) );
+                            if( one_in( 4 ) ) {
+                                if( xdir == 0 ) {
+                                    xdir = rng( 0, 1 ) * 2 - 1;
+                                } else {
+                                    xdir = 0;
                                 }
-                                if( one_in( 4 ) ) {
-                                    if( ydir == 0 ) {
-                                        ydir = rng( 0, 1 ) * 2 - 1;
-                                    } else {
-                                        ydir = 0;
-                                    }
+                            }
+                            if( one_in( 4 ) ) {
+                                if( ydir == 0 ) {
+                                    ydir = rng( 0, 1 ) * 2 - 1;
+                                } else {
+                                    ydir = 0;
                                 }
                             }
                         }
                     }
                 }
-                if( cur_fd_type_id == fd_acid_vent ) {
+            }
+            if( cur_fd_type_id == fd_acid_vent ) {
 
-                    if( cur.get_field_intensity() > 1 ) {
-                        if( cur.get_field_age() >= 1_minutes ) {
-                            cur.set_field_intensity( cur.get_field_intensity() - 1 );
-                            cur.set_field_age( 0_turns );
-                        }
-                    } else {
-                        cur.set_field_intensity( 3 );
-                        for( const tripoint &t : points_in_radius( p, 5 ) ) {
-                            const field_entry *acid = get_field( t, fd_acid );
-                            if( acid != nullptr && acid->get_field_intensity() == 0 ) {
-                                int new_intensity = 3 - rl_dist( p, t ) / 2 + ( one_in( 3 ) ? 1 : 0 );
-                                if( new_intensity > 3 ) {
-                                    new_intensity = 3;
-                                }
-                                if( new_intensity > 0 ) {
-                                    add_field( t, fd_acid, new_intensity );
-                                }
+                if( cur.get_field_intensity() > 1 ) {
+                    if( cur.get_field_age() >= 1_minutes ) {
+                        cur.set_field_intensity( cur.get_field_intensity() - 1 );
+                        cur.set_field_age( 0_turns );
+                    }
+                } else {
+                    cur.set_field_intensity( 3 );
+                    for( const tripoint &t : points_in_radius( p, 5 ) ) {
+                        const field_entry *acid = get_field( t, fd_acid );
+                        if( acid != nullptr && acid->get_field_intensity() == 0 ) {
+                            int new_intensity = 3 - rl_dist( p, t ) / 2 + ( one_in( 3 ) ? 1 : 0 );
+                            if( new_intensity > 3 ) {
+                                new_intensity = 3;
+                            }
+                            if( new_intensity > 0 ) {
+                                add_field( t, fd_acid, new_intensity );
                             }
                         }
                     }
                 }
-                if( cur_fd_type_id == fd_bees ) {
-                    // Poor bees are vulnerable to so many other fields.
-                    // TODO: maybe adjust effects based on different fields.
-                    if( curfield.find_field( fd_web ) ||
-                        curfield.find_field( fd_fire ) ||
-                        curfield.find_field( fd_smoke ) ||
-                        curfield.find_field( fd_toxic_gas ) ||
-                        curfield.find_field( fd_tear_gas ) ||
-                        curfield.find_field( fd_relax_gas ) ||
-                        curfield.find_field( fd_nuke_gas ) ||
-                        curfield.find_field( fd_gas_vent ) ||
-                        curfield.find_field( fd_smoke_vent ) ||
-                        curfield.find_field( fd_fungicidal_gas ) ||
-                        curfield.find_field( fd_insecticidal_gas ) ||
-                        curfield.find_field( fd_fire_vent ) ||
-                        curfield.find_field( fd_flame_burst ) ||
-                        curfield.find_field( fd_electricity ) ||
-                        curfield.find_field( fd_fatigue ) ||
-                        curfield.find_field( fd_shock_vent ) ||
-                        curfield.find_field( fd_plasma ) ||
-                        curfield.find_field( fd_laser ) ||
-                        curfield.find_field( fd_dazzling ) ||
-                        curfield.find_field( fd_electricity ) ||
-                        curfield.find_field( fd_incendiary ) ) {
-                        // Kill them at the end of processing.
-                        cur.set_field_intensity( 0 );
-                    } else {
-                        // Bees chase the player if in range, wander randomly otherwise.
-                        if( !g->u.is_underwater() &&
-                            rl_dist( p, g->u.pos() ) < 10 &&
-                            clear_path( p, g->u.pos(), 10, 1, 100 ) ) {
-
-                            std::vector<point> candidate_positions =
-                                squares_in_direction( p.xy(), point( g->u.posx(), g->u.posy() ) );
-                            for( point candidate_position : candidate_positions ) {
-                                field &target_field = get_field( tripoint( candidate_position, p.z ) );
-                                // Only shift if there are no bees already there.
-                                // TODO: Figure out a way to merge bee fields without allowing
-                                // Them to effectively move several times in a turn depending
-                                // on iteration direction.
-                                if( !target_field.find_field( fd_bees ) ) {
-                                    add_field( tripoint( candidate_position, p.z ), fd_bees,
-                                               cur.get_field_intensity(), cur.get_field_age() );
-                                    cur.set_field_intensity( 0 );
-                                    break;
-                                }
+            }
+            if( cur_fd_type_id == fd_bees ) {
+                // Poor bees are vulnerable to so many other fields.
+                // TODO: maybe adjust effects based on different fields.
+                if( curfield.find_field( fd_web ) ||
+                    curfield.find_field( fd_fire ) ||
+                    curfield.find_field( fd_smoke ) ||
+                    curfield.find_field( fd_toxic_gas ) ||
+                    curfield.find_field( fd_tear_gas ) ||
+                    curfield.find_field( fd_relax_gas ) ||
+                    curfield.find_field( fd_nuke_gas ) ||
+                    curfield.find_field( fd_gas_vent ) ||
+                    curfield.find_field( fd_smoke_vent ) ||
+                    curfield.find_field( fd_fungicidal_gas ) ||
+                    curfield.find_field( fd_insecticidal_gas ) ||
+                    curfield.find_field( fd_fire_vent ) ||
+                    curfield.find_field( fd_flame_burst ) ||
+                    curfield.find_field( fd_electricity ) ||
+                    curfield.find_field( fd_fatigue ) ||
+                    curfield.find_field( fd_shock_vent ) ||
+                    curfield.find_field( fd_plasma ) ||
+                    curfield.find_field( fd_laser ) ||
+                    curfield.find_field( fd_dazzling ) ||
+                    curfield.find_field( fd_electricity ) ||
+                    curfield.find_field( fd_incendiary ) ) {
+                    // Kill them at the end of processing.
+                    cur.set_field_intensity( 0 );
+                } else {
+                    // Bees chase the player if in range, wander randomly otherwise.
+                    if( !g->u.is_underwater() &&
+                        rl_dist( p, g->u.pos() ) < 10 &&
+                        clear_path( p, g->u.pos(), 10, 1, 100 ) ) {
+
+                        std::vector<point> candidate_positions =
+                            squares_in_direction( p.xy(), point( g->u.posx(), g->u.posy() ) );
+                        for( point candidate_position : candidate_positions ) {
+                            field &target_field = get_field( tripoint( candidate_position, p.z ) );
+                            // Only shift if there are no bees already there.
+                            // TODO: Figure out a way to merge bee fields without allowing
+                            // Them to effectively move several times in a turn depending
+                            // on iteration direction.
+                            if( !target_field.find_field( fd_bees ) ) {
+                                add_field( tripoint( candidate_position, p.z ), fd_bees,
+                                           cur.get_field_intensity(), cur.get_field_age() );
+                                cur.set_field_intensity( 0 );
+                                break;
                             }
-                        } else {
-                            spread_gas( cur, p, 5, 0_turns, sblk );
                         }
+                    } else {
+                        spread_gas( cur, p, 5, 0_turns, sblk );
                     }
                 }
-                if( cur_fd_type_id == fd_incendiary ) {
-                    // Needed for variable scope
-                    tripoint dst( p + point( rng( -1, 1 ), rng( -1, 1 ) ) );
-                    if( has_flag( TFLAG_FLAMMABLE, dst ) ||
-                        has_flag( TFLAG_FLAMMABLE_ASH, dst ) ||
-                        has_flag( TFLAG_FLAMMABLE_HARD, dst ) ) {
-                        add_field( dst, fd_fire, 1 );
-                    }
-
-                    // Check piles for flammable items and set those on fire
-                    if( flammable_items_at( dst ) ) {
-                        add_field( dst, fd_fire, 1 );
-                    }
-
-                    create_hot_air( p, cur.get_field_intensity() );
+            }
+            if( cur_fd_type_id == fd_incendiary ) {
+                // Needed for variable scope
+                tripoint dst( p + point( rng( -1, 1 ), rng( -1, 1 ) ) );
+                if( has_flag( TFLAG_FLAMMABLE, dst ) ||
+                    has_flag( TFLAG_FLAMMABLE_ASH, dst ) ||
+                    has_flag( TFLAG_FLAMMABLE_HARD, dst ) ) {
+                    add_field( dst, fd_fire, 1 );
                 }
-                if( cur_fd_type_id == fd_fungicidal_gas ) {
-                    // Check the terrain and replace it accordingly to simulate the fungus dieing off
-                    const ter_t &ter = map_tile.get_ter_t();
-                    const furn_t &frn = map_tile.get_furn_t();
-                    const int intensity = cur.get_field_intensity();
-                    if( ter.has_flag( flag_FUNGUS ) && one_in( 10 / intensity ) ) {
-                        ter_set( p, t_dirt );
-                    }
-                    if( frn.has_flag( flag_FUNGUS ) && one_in( 10 / intensity ) ) {
-                        furn_set( p, f_null );
-                    }
+
+                // Check piles for flammable items and set those on fire
+                if( flammable_items_at( dst ) ) {
+                    add_field( dst, fd_fire, 1 );
                 }
 
-                cur.set_field_age( cur.get_field_age() + 1_turns );
-                auto &fdata = cur.get_field_type().obj();
-                if( fdata.half_life > 0_turns && cur.get_field_age() > 0_turns &&
-                    dice( 2, to_turns<int>( cur.get_field_age() ) ) > to_turns<int>( fdata.half_life ) ) {
-                    cur.set_field_age( 0_turns );
-                    cur.set_field_intensity( cur.get_field_intensity() - 1 );
+                create_hot_air( p, cur.get_field_intensity() );
+            }
+            if( cur_fd_type_id == fd_fungicidal_gas ) {
+                // Check the terrain and replace it accordingly to simulate the fungus dieing off
+                const ter_t &ter = map_tile.get_ter_t();
+                const furn_t &frn = map_tile.get_furn_t();
+                const int intensity = cur.get_field_intensity();
+                if( ter.has_flag( flag_FUNGUS ) && one_in( 10 / intensity ) ) {
+                    ter_set( p, t_dirt );
                 }
-                if( !cur.is_field_alive() ) {
-                    --current_submap->field_count;
-                    curfield.remove_field( it++ );
-                } else {
-                    ++it;
+                if( frn.has_flag( flag_FUNGUS ) && one_in( 10 / intensity ) ) {
+                    furn_set( p, f_null );
                 }
             }
 
-            if( dirty_transparency_cache ) {
-                set_transparency_cache_dirty( thep );
-                set_seen_cache_dirty( thep );
+            cur.set_field_age( cur.get_field_age() + 1_turns );
+            auto &fdata = cur.get_field_type().obj();
+            if( fdata.half_life > 0_turns && cur.get_field_age() > 0_turns &&
+                dice( 2, to_turns<int>( cur.get_field_age() ) ) > to_turns<int>( fdata.half_life ) ) {
+                cur.set_field_age( 0_turns );
+                cur.set_field_intensity( cur.get_field_intensity() - 1 );
             }
+            if( !cur.is_field_alive() ) {
+                --current_submap->field_count;
+                curfield.remove_field( it++ );
+                invalidate_inventory_caches();
+            } else {
+                ++it;
+            }
+        }
+
+        if( dirty_transparency_cache ) {
+            set_transparency_cache_dirty( thep );
+            set_seen_cache_dirty( thep );
+        }
+
+        if( curfield.field_count() == 0 ) {
+            field_tiles.erase( l );
         }
     }
     const int minz = zlevels ? -OVERMAP_DEPTH : abs_sub.z;
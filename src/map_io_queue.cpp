@@ -0,0 +1,246 @@
+#include "map_io_queue.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
+struct map_io_queue::state {
+    struct queued_read {
+        tripoint om_addr;
+        read_job job;
+    };
+    struct queued_write {
+        std::vector<tripoint> quads;
+        write_job job;
+    };
+    struct read_result {
+        saved_quad_data data;
+        std::exception_ptr error;
+    };
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::deque<queued_write> writes;
+    // Reads the main thread is waiting for run before prefetches
+    std::deque<queued_read> urgent_reads;
+    std::deque<queued_read> prefetches;
+    // Quads with a read queued or running
+    std::set<tripoint> reading;
+    // Quads with a write queued or running, reads of them are not trusted until it is done
+    std::map<tripoint, int> writing;
+    std::map<tripoint, read_result> finished;
+    std::vector<std::string> write_errors;
+    bool busy = false;
+    bool stopping = false;
+
+    // Must be called with the mutex held
+    void start_thread() {
+        if( !thread.joinable() ) {
+            thread = std::thread( [this]() {
+                worker_loop();
+            } );
+        }
+    }
+
+    bool is_idle() const {
+        return !busy && writes.empty() && urgent_reads.empty() && prefetches.empty();
+    }
+
+    void run_write( std::unique_lock<std::mutex> &lock ) {
+        queued_write next = std::move( writes.front() );
+        writes.pop_front();
+        busy = true;
+        lock.unlock();
+        std::string error;
+        try {
+            next.job();
+        } catch( const std::exception &err ) {
+            error = err.what();
+        }
+        lock.lock();
+        busy = false;
+        for( const tripoint &quad : next.quads ) {
+            if( --writing[quad] == 0 ) {
+                writing.erase( quad );
+            }
+            finished.erase( quad );
+        }
+        if( !error.empty() ) {
+            write_errors.push_back( error );
+        }
+        done.notify_all();
+    }
+
+    void run_read( std::unique_lock<std::mutex> &lock ) {
+        std::deque<queued_read> &queue = urgent_reads.empty() ? prefetches : urgent_reads;
+        queued_read next = std::move( queue.front() );
+        queue.pop_front();
+        busy = true;
+        lock.unlock();
+        read_result result;
+        try {
+            result.data = next.job();
+        } catch( ... ) {
+            result.error = std::current_exception();
+        }
+        lock.lock();
+        busy = false;
+        reading.erase( next.om_addr );
+        // A write queued while this ran may have replaced what was read
+        if( writing.count( next.om_addr ) == 0 ) {
+            finished[next.om_addr] = std::move( result );
+        }
+        done.notify_all();
+    }
+
+    void worker_loop() {
+        std::unique_lock<std::mutex> lock( mutex );
+        while( true ) {
+            wake.wait( lock, [this]() {
+                return stopping || !writes.empty() || !urgent_reads.empty() || !prefetches.empty();
+            } );
+            if( !writes.empty() ) {
+                run_write( lock );
+            } else if( stopping ) {
+                return;
+            } else {
+                run_read( lock );
+            }
+        }
+    }
+};
+
+map_io_queue::map_io_queue() : st( std::make_unique<state>() )
+{
+}
+
+map_io_queue::~map_io_queue()
+{
+    {
+        std::lock_guard<std::mutex> lock( st->mutex );
+        if( !st->thread.joinable() ) {
+            return;
+        }
+        // Pending writes still run, reads nobody waits for are dropped
+        st->stopping = true;
+        st->prefetches.clear();
+    }
+    st->wake.notify_all();
+    st->thread.join();
+}
+
+void map_io_queue::write( const std::vector<tripoint> &quads, write_job job )
+{
+    {
+        std::lock_guard<std::mutex> lock( st->mutex );
+        for( const tripoint &quad : quads ) {
+            st->writing[quad]++;
+            st->finished.erase( quad );
+        }
+        st->writes.push_back( { quads, std::move( job ) } );
+        st->start_thread();
+    }
+    st->wake.notify_one();
+}
+
+void map_io_queue::prefetch( const tripoint &om_addr, read_job job )
+{
+    {
+        std::lock_guard<std::mutex> lock( st->mutex );
+        if( st->reading.count( om_addr ) > 0 || st->finished.count( om_addr ) > 0 ) {
+            return;
+        }
+        st->reading.insert( om_addr );
+        st->prefetches.push_back( { om_addr, std::move( job ) } );
+        st->start_thread();
+    }
+    st->wake.notify_one();
+}
+
+saved_quad_data map_io_queue::read( const tripoint &om_addr, const read_job &job )
+{
+    std::unique_lock<std::mutex> lock( st->mutex );
+    st->start_thread();
+    while( true ) {
+        const auto iter = st->finished.find( om_addr );
+        if( iter != st->finished.end() && st->writing.count( om_addr ) == 0 ) {
+            const state::read_result result = std::move( iter->second );
+            st->finished.erase( iter );
+            lock.unlock();
+            if( result.error ) {
+                std::rethrow_exception( result.error );
+            }
+            return result.data;
+        }
+        if( st->reading.count( om_addr ) == 0 ) {
+            st->reading.insert( om_addr );
+            st->urgent_reads.push_back( { om_addr, job } );
+            st->wake.notify_one();
+        } else {
+            // Move a queued prefetch of this quad to the front
+            const auto queued = std::find_if( st->prefetches.begin(), st->prefetches.end(),
+            [&om_addr]( const state::queued_read & r ) {
+                return r.om_addr == om_addr;
+            } );
+            if( queued != st->prefetches.end() ) {
+                st->urgent_reads.push_back( std::move( *queued ) );
+                st->prefetches.erase( queued );
+                st->wake.notify_one();
+            }
+        }
+        st->done.wait( lock );
+    }
+}
+
+void map_io_queue::drop_prefetches_except( const std::set<tripoint> &keep )
+{
+    std::lock_guard<std::mutex> lock( st->mutex );
+    for( auto iter = st->finished.begin(); iter != st->finished.end(); ) {
+        if( keep.count( iter->first ) == 0 ) {
+            iter = st->finished.erase( iter );
+        } else {
+            ++iter;
+        }
+    }
+    for( auto iter = st->prefetches.begin(); iter != st->prefetches.end(); ) {
+        if( keep.count( iter->om_addr ) == 0 ) {
+            st->reading.erase( iter->om_addr );
+            iter = st->prefetches.erase( iter );
+        } else {
+            ++iter;
+        }
+    }
+}
+
+bool map_io_queue::is_prefetched( const tripoint &om_addr )
+{
+    std::lock_guard<std::mutex> lock( st->mutex );
+    return st->finished.count( om_addr ) > 0 && st->writing.count( om_addr ) == 0;
+}
+
+void map_io_queue::wait_idle()
+{
+    std::unique_lock<std::mutex> lock( st->mutex );
+    st->done.wait( lock, [this]() {
+        return st->is_idle();
+    } );
+}
+
+std::vector<std::string> map_io_queue::take_write_errors()
+{
+    std::lock_guard<std::mutex> lock( st->mutex );
+    std::vector<std::string> result;
+    result.swap( st->write_errors );
+    return result;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef CATA_SRC_MAP_IO_QUEUE_H
+#define CATA_SRC_MAP_IO_QUEUE_H
+
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "point.h"
+
+/** Bytes of one saved quad as they are on disk, not yet decoded. */
+struct saved_quad_data {
+    enum class format : int {
+        none,
+        json,
+        binary
+    };
+    format fmt = format::none;
+    // File the data came from, for error messages
+    std::string path;
+    std::string data;
+};
+
+/**
+ * Background thread doing the disk side of mapbuffer loads and saves.
+ *
+ * The jobs only touch files, never game state: submaps are encoded before a write is
+ * queued and decoded after a read returns, both on the main thread.
+ * Writes run in the order they were queued and before any read, so a read sees every
+ * write queued before it. Reads are either queued ahead of time with @ref prefetch or
+ * waited for with @ref read, which also collects finished prefetches.
+ */
+class map_io_queue
+{
+    public:
+        using read_job = std::function<saved_quad_data()>;
+        using write_job = std::function<void()>;
+
+        map_io_queue();
+        ~map_io_queue();
+        map_io_queue( const map_io_queue & ) = delete;
+        map_io_queue &operator=( const map_io_queue & ) = delete;
+
+        /** Queues a write affecting the given quads (overmap terrain coordinates). */
+        void write( const std::vector<tripoint> &quads, write_job job );
+        /** Queues a read of the quad unless it is already queued or done. */
+        void prefetch( const tripoint &om_addr, read_job job );
+        /**
+         * Returns the data of the quad, reading it now if it has not been prefetched.
+         * Rethrows any exception the read threw.
+         */
+        saved_quad_data read( const tripoint &om_addr, const read_job &job );
+        /** Drops finished and queued prefetches of quads not in keep. */
+        void drop_prefetches_except( const std::set<tripoint> &keep );
+        /** Whether a prefetch of the quad has finished and is waiting to be collected. */
+        bool is_prefetched( const tripoint &om_addr );
+        /** Blocks until every queued job has run. */
+        void wait_idle();
+        /** Messages of the writes that failed since the last call. */
+        std::vector<std::string> take_write_errors();
+
+    private:
+        // Queues, results and the thread itself, see map_io_queue.cpp
+        struct state;
+        std::unique_ptr<state> st;
+};
+
+#endif // CATA_SRC_MAP_IO_QUEUE_H
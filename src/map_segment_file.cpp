@@ -0,0 +1,441 @@
+#include "map_segment_file.h"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "filesystem.h"
+#include "fstream_utils.h"
+#include "game.h"
+#include "game_constants.h"
+#include "int_id.h"
+#include "json.h"
+#include "string_formatter.h"
+#include "string_id.h"
+#include "submap.h"
+#include "trap.h"
+#include "type_id.h"
+
+namespace
+{
+
+constexpr char segment_magic[4] = { 'C', 'S', 'E', 'G' };
+// Magic, format version and quad count
+constexpr int header_size = 12;
+// Quad x, y, z and size
+constexpr int index_entry_size = 16;
+constexpr int cells_per_submap = SEEX * SEEY;
+
+void write_u32( std::string &out, uint32_t value )
+{
+    for( int i = 0; i < 4; i++ ) {
+        out.push_back( static_cast<char>( ( value >> ( 8 * i ) ) & 0xff ) );
+    }
+}
+
+uint32_t read_u32( const std::string &data, size_t pos )
+{
+    uint32_t value = 0;
+    for( int i = 0; i < 4; i++ ) {
+        value |= static_cast<uint32_t>( static_cast<unsigned char>( data[pos + i] ) ) << ( 8 * i );
+    }
+    return value;
+}
+
+void write_varint( std::string &out, uint64_t value )
+{
+    while( value >= 0x80 ) {
+        out.push_back( static_cast<char>( ( value & 0x7f ) | 0x80 ) );
+        value >>= 7;
+    }
+    out.push_back( static_cast<char>( value ) );
+}
+
+void write_svarint( std::string &out, int64_t value )
+{
+    // Zigzag encoding keeps small negative numbers short
+    write_varint( out, ( static_cast<uint64_t>( value ) << 1 ) ^ static_cast<uint64_t>( value >> 63 ) );
+}
+
+void write_string( std::string &out, const std::string &str )
+{
+    write_varint( out, str.size() );
+    out += str;
+}
+
+class byte_reader
+{
+    public:
+        explicit byte_reader( const std::string &data ) : data( data ) {}
+
+        uint64_t varint() {
+            uint64_t value = 0;
+            for( int shift = 0; shift < 64; shift += 7 ) {
+                need( 1 );
+                const unsigned char byte = static_cast<unsigned char>( data[pos++] );
+                value |= static_cast<uint64_t>( byte & 0x7f ) << shift;
+                if( !( byte & 0x80 ) ) {
+                    return value;
+                }
+            }
+            throw std::runtime_error( "malformed variable length integer" );
+        }
+
+        int64_t svarint() {
+            const uint64_t value = varint();
+            return static_cast<int64_t>( value >> 1 ) ^ -static_cast<int64_t>( value & 1 );
+        }
+
+        int small_int() {
+            return static_cast<int>( svarint() );
+        }
+
+        std::string string() {
+            const uint64_t size = varint();
+            need( size );
+            std::string result = data.substr( pos, size );
+            pos += size;
+            return result;
+        }
+
+        bool at_end() const {
+            return pos == data.size();
+        }
+
+    private:
+        void need( uint64_t bytes ) const {
+            if( bytes > data.size() - pos ) {
+                throw std::runtime_error( "unexpected end of quad data" );
+            }
+        }
+
+        const std::string &data;
+        size_t pos = 0;
+};
+
+// Cells are visited row by row, the same order submap::store uses for its RLE
+template<typename F>
+void write_runs( std::string &out, const std::vector<int64_t> &cells, F write_value )
+{
+    size_t start = 0;
+    while( start < cells.size() ) {
+        size_t end = start + 1;
+        while( end < cells.size() && cells[end] == cells[start] ) {
+            end++;
+        }
+        write_varint( out, end - start );
+        write_value( out, cells[start] );
+        start = end;
+    }
+}
+
+template<typename F, typename G>
+void read_runs( byte_reader &in, F read_value, G set_cell )
+{
+    int cell = 0;
+    while( cell < cells_per_submap ) {
+        const uint64_t length = in.varint();
+        const int64_t value = read_value( in );
+        if( length == 0 || length > static_cast<uint64_t>( cells_per_submap - cell ) ) {
+            throw std::runtime_error( "run-length data does not fit the submap" );
+        }
+        for( uint64_t i = 0; i < length; i++, cell++ ) {
+            set_cell( point( cell % SEEX, cell / SEEX ), value );
+        }
+    }
+}
+
+// Writes a table of the string ids used by the layer, then the runs of table indices
+template<typename F>
+void write_id_layer( std::string &out, F get_id )
+{
+    std::vector<int64_t> cells;
+    cells.reserve( cells_per_submap );
+    std::vector<std::string> names;
+    std::unordered_map<int, int> table_index;
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const auto id = get_id( point( i, j ) );
+            const auto inserted = table_index.emplace( id.to_i(), static_cast<int>( names.size() ) );
+            if( inserted.second ) {
+                names.push_back( id.id().str() );
+            }
+            cells.push_back( inserted.first->second );
+        }
+    }
+    write_varint( out, names.size() );
+    for( const std::string &name : names ) {
+        write_string( out, name );
+    }
+    write_runs( out, cells, []( std::string & o, int64_t v ) {
+        write_varint( o, static_cast<uint64_t>( v ) );
+    } );
+}
+
+template<typename T, typename F>
+void read_id_layer( byte_reader &in, F set_id )
+{
+    const uint64_t table_size = in.varint();
+    std::vector<int_id<T>> ids;
+    for( uint64_t i = 0; i < table_size; i++ ) {
+        ids.push_back( string_id<T>( in.string() ).id() );
+    }
+    read_runs( in, []( byte_reader & r ) {
+        return static_cast<int64_t>( r.varint() );
+    }, [&]( point p, int64_t index ) {
+        if( index < 0 || static_cast<uint64_t>( index ) >= ids.size() ) {
+            throw std::runtime_error( "id index out of range" );
+        }
+        set_id( p, ids[index] );
+    } );
+}
+
+} // namespace
+
+map_segment_file::map_segment_file( const std::string &path ) : path( path )
+{
+}
+
+void map_segment_file::load_index()
+{
+    if( index_loaded ) {
+        return;
+    }
+    if( !file_exist( path ) ) {
+        index.clear();
+        index_loaded = true;
+        return;
+    }
+    cata_ifstream fin = std::move( cata_ifstream().mode( cata_ios_mode::binary ).open( path ) );
+    if( !fin.is_open() ) {
+        throw std::runtime_error( string_format( "could not open %s", path ) );
+    }
+    std::string header( header_size, '\0' );
+    fin->read( &header[0], header_size );
+    if( fin.fail() || header.compare( 0, 4, segment_magic, 4 ) != 0 ) {
+        throw std::runtime_error( string_format( "%s is not a map segment file", path ) );
+    }
+    const uint32_t version = read_u32( header, 4 );
+    if( version > static_cast<uint32_t>( format_version ) ) {
+        throw std::runtime_error( string_format( "%s has unsupported format version %d", path,
+                                  version ) );
+    }
+    const uint32_t count = read_u32( header, 8 );
+    std::string entries( static_cast<size_t>( count ) * index_entry_size, '\0' );
+    if( count > 0 ) {
+        fin->read( &entries[0], entries.size() );
+        if( fin.fail() ) {
+            throw std::runtime_error( string_format( "%s has a truncated quad index", path ) );
+        }
+    }
+    // Only a completely read index is kept, a partial one would make update() drop the
+    // quads missing from it
+    std::map<tripoint, quad_entry> loaded;
+    long long offset = header_size + static_cast<long long>( entries.size() );
+    for( uint32_t i = 0; i < count; i++ ) {
+        const size_t pos = static_cast<size_t>( i ) * index_entry_size;
+        const tripoint om_addr( static_cast<int32_t>( read_u32( entries, pos ) ),
+                                static_cast<int32_t>( read_u32( entries, pos + 4 ) ),
+                                static_cast<int32_t>( read_u32( entries, pos + 8 ) ) );
+        quad_entry &entry = loaded[om_addr];
+        entry.offset = offset;
+        entry.size = read_u32( entries, pos + 12 );
+        offset += entry.size;
+    }
+    index = std::move( loaded );
+    index_loaded = true;
+}
+
+std::string map_segment_file::read_data( const quad_entry &entry )
+{
+    cata_ifstream fin = std::move( cata_ifstream().mode( cata_ios_mode::binary ).open( path ) );
+    if( !fin.is_open() ) {
+        throw std::runtime_error( string_format( "could not open %s", path ) );
+    }
+    std::string data( entry.size, '\0' );
+    fin->seekg( entry.offset );
+    if( entry.size > 0 ) {
+        fin->read( &data[0], entry.size );
+    }
+    if( fin.fail() ) {
+        throw std::runtime_error( string_format( "%s is truncated", path ) );
+    }
+    return data;
+}
+
+bool map_segment_file::has_quad( const tripoint &om_addr )
+{
+    load_index();
+    return index.count( om_addr ) > 0;
+}
+
+std::vector<tripoint> map_segment_file::quads()
+{
+    load_index();
+    std::vector<tripoint> result;
+    result.reserve( index.size() );
+    for( const std::pair<const tripoint, quad_entry> &entry : index ) {
+        result.push_back( entry.first );
+    }
+    return result;
+}
+
+map_quad_submaps map_segment_file::read_quad( const tripoint &om_addr )
+{
+    const std::string data = read_quad_data( om_addr );
+    if( data.empty() ) {
+        return map_quad_submaps();
+    }
+    try {
+        return decode_quad( data );
+    } catch( const std::exception &err ) {
+        throw std::runtime_error( string_format( "quad %s in %s: %s", om_addr.to_string(), path,
+                                  err.what() ) );
+    }
+}
+
+std::string map_segment_file::read_quad_data( const tripoint &om_addr )
+{
+    load_index();
+    const auto iter = index.find( om_addr );
+    if( iter == index.end() ) {
+        return std::string();
+    }
+    return read_data( iter->second );
+}
+
+void map_segment_file::update( const map_segment_changes &changes )
+{
+    try {
+        load_index();
+    } catch( const std::exception &err ) {
+        throw std::runtime_error( string_format( "%s, the file was left unchanged", err.what() ) );
+    }
+    // Quads kept from the old file have to be read before it is replaced
+    std::map<tripoint, std::string> contents;
+    for( const std::pair<const tripoint, quad_entry> &entry : index ) {
+        if( changes.quads.count( entry.first ) == 0 && changes.removed.count( entry.first ) == 0 ) {
+            contents.emplace( entry.first, read_data( entry.second ) );
+        }
+    }
+    for( const std::pair<const tripoint, std::string> &quad : changes.quads ) {
+        contents[quad.first] = quad.second;
+    }
+
+    index.clear();
+    if( contents.empty() ) {
+        if( file_exist( path ) ) {
+            remove_file( path );
+        }
+        return;
+    }
+
+    std::string header( segment_magic, 4 );
+    write_u32( header, format_version );
+    write_u32( header, contents.size() );
+    long long offset = header_size + static_cast<long long>( contents.size() ) * index_entry_size;
+    for( const std::pair<const tripoint, std::string> &quad : contents ) {
+        write_u32( header, static_cast<uint32_t>( quad.first.x ) );
+        write_u32( header, static_cast<uint32_t>( quad.first.y ) );
+        write_u32( header, static_cast<uint32_t>( quad.first.z ) );
+        write_u32( header, quad.second.size() );
+        quad_entry &entry = index[quad.first];
+        entry.offset = offset;
+        entry.size = quad.second.size();
+        offset += entry.size;
+    }
+    write_to_file( path, [&]( std::ostream & fout ) {
+        fout.write( header.data(), header.size() );
+        for( const std::pair<const tripoint, std::string> &quad : contents ) {
+            fout.write( quad.second.data(), quad.second.size() );
+        }
+    } );
+}
+
+std::string map_segment_file::encode_quad( const std::vector<std::pair<tripoint, const submap *>>
+        &quad )
+{
+    std::string out;
+    write_varint( out, quad.size() );
+    for( const std::pair<tripoint, const submap *> &elem : quad ) {
+        const submap &sm = *elem.second;
+        write_svarint( out, elem.first.x );
+        write_svarint( out, elem.first.y );
+        write_svarint( out, elem.first.z );
+        write_varint( out, savegame_version );
+
+        write_id_layer( out, [&sm]( point p ) {
+            return sm.get_ter( p );
+        } );
+        write_id_layer( out, [&sm]( point p ) {
+            return sm.get_furn( p );
+        } );
+        write_id_layer( out, [&sm]( point p ) {
+            return sm.get_trap( p );
+        } );
+        std::vector<int64_t> radiation;
+        radiation.reserve( cells_per_submap );
+        for( int j = 0; j < SEEY; j++ ) {
+            for( int i = 0; i < SEEX; i++ ) {
+                radiation.push_back( sm.get_radiation( point( i, j ) ) );
+            }
+        }
+        write_runs( out, radiation, []( std::string & o, int64_t v ) {
+            write_svarint( o, v );
+        } );
+
+        std::ostringstream contents;
+        JsonOut jsout( contents );
+        jsout.start_object();
+        sm.store_contents( jsout );
+        jsout.end_object();
+        write_string( out, contents.str() );
+    }
+    return out;
+}
+
+map_quad_submaps map_segment_file::decode_quad( const std::string &data )
+{
+    byte_reader in( data );
+    map_quad_submaps result;
+    const uint64_t count = in.varint();
+    for( uint64_t n = 0; n < count; n++ ) {
+        tripoint pos;
+        pos.x = in.small_int();
+        pos.y = in.small_int();
+        pos.z = in.small_int();
+        const int version = static_cast<int>( in.varint() );
+        std::unique_ptr<submap> sm = std::make_unique<submap>();
+
+        read_id_layer<ter_t>( in, [&sm]( point p, const ter_id & id ) {
+            sm->set_ter( p, id );
+        } );
+        read_id_layer<furn_t>( in, [&sm]( point p, const furn_id & id ) {
+            sm->set_furn( p, id );
+        } );
+        read_id_layer<trap>( in, [&sm]( point p, const trap_id & id ) {
+            sm->set_trap( p, id );
+        } );
+        read_runs( in, []( byte_reader & r ) {
+            return r.svarint();
+        }, [&sm]( point p, int64_t value ) {
+            sm->set_radiation( p, static_cast<int>( value ) );
+        } );
+
+        std::istringstream contents( in.string() );
+        JsonIn jsin( contents );
+        jsin.start_object();
+        while( !jsin.end_object() ) {
+            const std::string member_name = jsin.get_member_name();
+            sm->load( jsin, member_name, version );
+        }
+        result.emplace_back( pos, std::move( sm ) );
+    }
+    if( !in.at_end() ) {
+        throw std::runtime_error( "trailing data after the last submap" );
+    }
+    return result;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef CATA_SRC_MAP_SEGMENT_FILE_H
+#define CATA_SRC_MAP_SEGMENT_FILE_H
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "point.h"
+
+class submap;
+
+/** Submaps of one quad, keyed by their absolute submap coordinates. */
+using map_quad_submaps = std::vector<std::pair<tripoint, std::unique_ptr<submap>>>;
+
+/** Pending changes to one segment file, applied by @ref map_segment_file::update. */
+struct map_segment_changes {
+    // Encoded quads to add or replace, by overmap terrain coordinates
+    std::map<tripoint, std::string> quads;
+    // Quads to drop from the file, by overmap terrain coordinates
+    std::set<tripoint> removed;
+    // Legacy JSON quad files superseded by the new quads, deleted once the segment is written
+    std::vector<std::string> legacy_files;
+};
+
+/**
+ * Binary save file holding every saved quad of one map segment (32x32 overmap terrains).
+ *
+ * The file starts with a small header and an index of the quads it holds, followed by
+ * the encoded quads. Only the index is read when the file is first used, a quad is read
+ * from disk when it is looked up.
+ *
+ * A quad is encoded as its submaps. The terrain, furniture, trap and radiation layers are
+ * run-length encoded against a per-submap table of ids. Items, fields, vehicles and the
+ * other sparse members are kept as compact JSON, read back through submap::load.
+ */
+class map_segment_file
+{
+    public:
+        /** Bumped whenever the layout of the file or of an encoded quad changes. */
+        static constexpr int format_version = 1;
+
+        explicit map_segment_file( const std::string &path );
+
+        const std::string &get_path() const {
+            return path;
+        }
+
+        bool has_quad( const tripoint &om_addr );
+        /** Overmap terrain coordinates of all quads in the file. */
+        std::vector<tripoint> quads();
+        /** Reads and decodes one quad, throws if the file is damaged. */
+        map_quad_submaps read_quad( const tripoint &om_addr );
+        /** Reads one quad without decoding it, see @ref decode_quad. */
+        std::string read_quad_data( const tripoint &om_addr );
+
+        /**
+         * Rewrites the file with the given changes applied. The file is removed when
+         * no quads are left in it. Throws and leaves the file alone if its index can't
+         * be read, rewriting it would lose the quads that are not in the changes.
+         */
+        void update( const map_segment_changes &changes );
+
+        static std::string encode_quad( const std::vector<std::pair<tripoint, const submap *>> &quad );
+        static map_quad_submaps decode_quad( const std::string &data );
+
+    private:
+        struct quad_entry {
+            long long offset = 0;
+            long long size = 0;
+        };
+
+        void load_index();
+        std::string read_data( const quad_entry &entry );
+
+        std::string path;
+        bool index_loaded = false;
+        std::map<tripoint, quad_entry> index;
+};
+
+#endif // CATA_SRC_MAP_SEGMENT_FILE_H
@@ -18,6 +18,9 @@
 #include "game_constants.h"
 #include "json.h"
 #include "map.h"
+#include "map_io_queue.h"
+#include "map_segment_file.h"
+#include "options.h"
 #include "output.h"
 #include "popup.h"
 #include "string_formatter.h"
@@ -37,14 +40,172 @@ static std::string find_dirname( const tripoint &om_addr )
                           segment_addr.y, segment_addr.z );
 }
 
+static std::string find_segment_path( const tripoint &segment_addr )
+{
+    return string_format( "%s/maps/%d.%d.%d.seg", g->get_world_base_save_path(), segment_addr.x,
+                          segment_addr.y, segment_addr.z );
+}
+
+// Submaps of one quad that are present in the buffer, in save order
+using quad_submap_list = std::vector<std::pair<tripoint, const submap *>>;
+
+static std::string encode_quad_json( const quad_submap_list &quad )
+{
+    std::ostringstream fout;
+    JsonOut jsout( fout );
+    jsout.start_array();
+    for( const std::pair<tripoint, const submap *> &elem : quad ) {
+        const tripoint &submap_addr = elem.first;
+        jsout.start_object();
+
+        jsout.member( "version", savegame_version );
+        jsout.member( "coordinates" );
+
+        jsout.start_array();
+        jsout.write( submap_addr.x );
+        jsout.write( submap_addr.y );
+        jsout.write( submap_addr.z );
+        jsout.end_array();
+
+        elem.second->store( jsout );
+
+        jsout.end_object();
+    }
+
+    jsout.end_array();
+    return fout.str();
+}
+
+static void write_text_file( const std::string &path, const std::string &text )
+{
+    write_to_file( path, [&text]( std::ostream & fout ) {
+        fout.write( text.data(), text.size() );
+    } );
+}
+
+/** Everything one save writes to the files of one segment, encoded on the main thread. */
+struct mapbuffer::segment_save {
+    std::string dirname;
+    std::string segment_path;
+    map_segment_changes binary;
+    // Legacy JSON quad files: path and text
+    std::map<tripoint, std::pair<std::string, std::string>> json;
+};
+
 mapbuffer MAPBUFFER;
 
-mapbuffer::mapbuffer() = default;
+mapbuffer::mapbuffer() : io( std::make_unique<map_io_queue>() )
+{
+}
+
 mapbuffer::~mapbuffer() = default;
 
 void mapbuffer::clear()
 {
+    wait_for_io();
+    io->drop_prefetches_except( {} );
     submaps.clear();
+    segment_files.clear();
+}
+
+void mapbuffer::wait_for_io()
+{
+    io->wait_idle();
+    report_io_errors();
+}
+
+void mapbuffer::report_io_errors()
+{
+    for( const std::string &error : io->take_write_errors() ) {
+        debugmsg( "Failed to save the map: %s", error );
+    }
+}
+
+map_segment_file &mapbuffer::get_segment_file( const std::string &path )
+{
+    std::unique_ptr<map_segment_file> &file = segment_files[path];
+    if( !file ) {
+        file = std::make_unique<map_segment_file>( path );
+    }
+    return *file;
+}
+
+std::function<saved_quad_data()> mapbuffer::make_read_job( const tripoint &om_addr )
+{
+    // Paths depend on the active world, so they are built here and not on the io thread
+    const std::string segment_path = find_segment_path( omt_to_seg_copy( om_addr ) );
+    const std::string dirname = find_dirname( om_addr );
+    const std::string quad_path = find_quad_path( dirname, om_addr );
+    // Fix for old saves where the path was generated using std::stringstream, which
+    // did format the number using the current locale. That formatting may insert
+    // thousands separators, so the resulting path is "map/1,234.7.8.map" instead
+    // of "map/1234.7.8.map".
+    std::ostringstream buffer;
+    buffer << dirname << "/" << om_addr.x << "." << om_addr.y << "." << om_addr.z << ".map";
+    const std::string locale_quad_path = buffer.str();
+
+    return [this, om_addr, segment_path, quad_path, locale_quad_path]() {
+        saved_quad_data result;
+        map_segment_file &segment = get_segment_file( segment_path );
+        if( segment.has_quad( om_addr ) ) {
+            result.fmt = saved_quad_data::format::binary;
+            result.path = segment_path;
+            result.data = segment.read_quad_data( om_addr );
+            return result;
+        }
+        std::string path = quad_path;
+        if( !file_exist( path ) ) {
+            if( !file_exist( locale_quad_path ) ) {
+                return result;
+            }
+            path = locale_quad_path;
+        }
+        result.fmt = saved_quad_data::format::json;
+        result.path = path;
+        result.data = read_entire_file( path );
+        if( result.data.empty() ) {
+            throw std::runtime_error( string_format( "could not read %s", path ) );
+        }
+        return result;
+    };
+}
+
+void mapbuffer::prefetch_ahead( const tripoint &abs_sub, point direction, int distance,
+                                int zmin, int zmax )
+{
+    if( !prefetch_enabled || direction == point_zero || distance <= 0 ) {
+        return;
+    }
+    const point map_min = abs_sub.xy();
+    const point map_max = map_min + point( MAPSIZE - 1, MAPSIZE - 1 );
+    const point ahead_min = map_min + point( direction.x < 0 ? -distance : 0,
+                            direction.y < 0 ? -distance : 0 );
+    const point ahead_max = map_max + point( direction.x > 0 ? distance : 0,
+                            direction.y > 0 ? distance : 0 );
+    std::set<tripoint> wanted;
+    for( int z = zmin; z <= zmax; z++ ) {
+        for( int x = ahead_min.x; x <= ahead_max.x; x++ ) {
+            for( int y = ahead_min.y; y <= ahead_max.y; y++ ) {
+                if( x >= map_min.x && x <= map_max.x && y >= map_min.y && y <= map_max.y ) {
+                    continue;
+                }
+                const tripoint om_addr = sm_to_omt_copy( tripoint( x, y, z ) );
+                if( !is_submap_loaded( omt_to_sm_copy( om_addr ) ) ) {
+                    wanted.insert( om_addr );
+                }
+            }
+        }
+    }
+    // Whatever was read for an earlier heading is not needed any more
+    io->drop_prefetches_except( wanted );
+    for( const tripoint &om_addr : wanted ) {
+        io->prefetch( om_addr, make_read_job( om_addr ) );
+    }
+}
+
+bool mapbuffer::is_prefetched( const tripoint &om_addr )
+{
+    return io->is_prefetched( om_addr );
 }
 
 bool mapbuffer::add_submap( const tripoint &p, std::unique_ptr<submap> &sm )
@@ -97,6 +258,7 @@ submap *mapbuffer::lookup_submap( const tripoint &p )
 
 void mapbuffer::save( bool delete_after_save )
 {
+    report_io_errors();
     assure_dir_exist( g->get_world_base_save_path() + "/maps" );
 
     int num_saved_submaps = 0;
@@ -111,6 +273,8 @@ void mapbuffer::save( bool delete_after_save )
     // A set of already-saved submaps, in global overmap coordinates.
     std::set<tripoint> saved_submaps;
     std::list<tripoint> submaps_to_delete;
+    // Files are written by the io thread once all quads of their segment are encoded
+    std::map<tripoint, segment_save> segment_saves;
     static constexpr std::chrono::milliseconds update_interval( 500 );
     auto last_update = std::chrono::steady_clock::now();
 
@@ -148,9 +312,12 @@ void mapbuffer::save( bool delete_after_save )
                    delete_after_save || zlev_del ||
                    om_addr.x < map_origin.x || om_addr.y < map_origin.y ||
                    om_addr.x > map_origin.x + HALF_MAPSIZE ||
-                   om_addr.y > map_origin.y + HALF_MAPSIZE );
+                   om_addr.y > map_origin.y + HALF_MAPSIZE, segment_saves );
         num_saved_submaps += 4;
     }
+    for( std::pair<const tripoint, segment_save> &elem : segment_saves ) {
+        queue_segment_save( std::move( elem.second ) );
+    }
     for( auto &elem : submaps_to_delete ) {
         remove_submap( elem );
     }
@@ -160,7 +327,7 @@ void mapbuffer::save( bool delete_after_save )
 
 void mapbuffer::save_quad( const std::string &dirname, const std::string &filename,
                            const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                           bool delete_after_save )
+                           bool delete_after_save, std::map<tripoint, segment_save> &segment_saves )
 {
     std::vector<point> offsets;
     std::vector<tripoint> submap_addrs;
@@ -198,43 +365,68 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
         return;
     }
 
-    // Don't create the directory if it would be empty
-    assure_dir_exist( dirname );
-    write_to_file( filename, [&]( std::ostream & fout ) {
-        JsonOut jsout( fout );
-        jsout.start_array();
-        for( auto &submap_addr : submap_addrs ) {
-            if( submaps.count( submap_addr ) == 0 ) {
-                continue;
-            }
-
-            submap *sm = submaps[submap_addr].get();
-
-            if( sm == nullptr ) {
-                continue;
-            }
+    quad_submap_list quad;
+    for( auto &submap_addr : submap_addrs ) {
+        if( submaps.count( submap_addr ) == 0 ) {
+            continue;
+        }
 
-            jsout.start_object();
+        submap *sm = submaps[submap_addr].get();
 
-            jsout.member( "version", savegame_version );
-            jsout.member( "coordinates" );
+        if( sm == nullptr ) {
+            continue;
+        }
 
-            jsout.start_array();
-            jsout.write( submap_addr.x );
-            jsout.write( submap_addr.y );
-            jsout.write( submap_addr.z );
-            jsout.end_array();
+        quad.emplace_back( submap_addr, sm );
 
-            sm->store( jsout );
+        if( delete_after_save ) {
+            submaps_to_delete.push_back( submap_addr );
+        }
+    }
 
-            jsout.end_object();
+    const tripoint segment_addr = omt_to_seg_copy( om_addr );
+    segment_save &save = segment_saves[segment_addr];
+    save.dirname = dirname;
+    save.segment_path = find_segment_path( segment_addr );
+    if( get_option<bool>( "BINARY_MAP_SAVES" ) ) {
+        save.binary.quads[om_addr] = map_segment_file::encode_quad( quad );
+        save.binary.legacy_files.push_back( filename );
+    } else {
+        save.json[om_addr] = std::make_pair( filename, encode_quad_json( quad ) );
+    }
+}
 
-            if( delete_after_save ) {
-                submaps_to_delete.push_back( submap_addr );
+void mapbuffer::queue_segment_save( segment_save &&save )
+{
+    std::vector<tripoint> quads;
+    for( const std::pair<const tripoint, std::string> &elem : save.binary.quads ) {
+        quads.push_back( elem.first );
+    }
+    for( const std::pair<const tripoint, std::pair<std::string, std::string>> &elem : save.json ) {
+        quads.push_back( elem.first );
+    }
+    std::shared_ptr<segment_save> shared = std::make_shared<segment_save>( std::move( save ) );
+    io->write( quads, [this, shared]() {
+        map_segment_file &segment = get_segment_file( shared->segment_path );
+        if( !shared->json.empty() ) {
+            // Don't create the directory if it would be empty
+            assure_dir_exist( shared->dirname );
+        }
+        for( const std::pair<const tripoint, std::pair<std::string, std::string>> &elem : shared->json ) {
+            write_text_file( elem.second.first, elem.second.second );
+            // An older binary copy would shadow the JSON file on load
+            if( segment.has_quad( elem.first ) ) {
+                shared->binary.removed.insert( elem.first );
+            }
+        }
+        if( !shared->binary.quads.empty() || !shared->binary.removed.empty() ) {
+            segment.update( shared->binary );
+        }
+        for( const std::string &legacy_file : shared->binary.legacy_files ) {
+            if( file_exist( legacy_file ) ) {
+                remove_file( legacy_file );
             }
         }
-
-        jsout.end_array();
     } );
 }
 
@@ -244,29 +436,29 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
 {
     // Map the tripoint to the submap quad that stores it.
     const tripoint om_addr = sm_to_omt_copy( p );
-    const std::string dirname = find_dirname( om_addr );
-    std::string quad_path = find_quad_path( dirname, om_addr );
-
-    if( !file_exist( quad_path ) ) {
-        // Fix for old saves where the path was generated using std::stringstream, which
-        // did format the number using the current locale. That formatting may insert
-        // thousands separators, so the resulting path is "map/1,234.7.8.map" instead
-        // of "map/1234.7.8.map".
-        std::ostringstream buffer;
-        buffer << dirname << "/" << om_addr.x << "." << om_addr.y << "." << om_addr.z << ".map";
-        if( file_exist( buffer.str() ) ) {
-            quad_path = buffer.str();
+    const saved_quad_data saved = io->read( om_addr, make_read_job( om_addr ) );
+    switch( saved.fmt ) {
+        case saved_quad_data::format::none:
+            // If it doesn't exist, trigger generating it.
+            return nullptr;
+        case saved_quad_data::format::binary:
+            for( std::pair<tripoint, std::unique_ptr<submap>> &elem : map_segment_file::decode_quad(
+                     saved.data ) ) {
+                if( !add_submap( elem.first, elem.second ) ) {
+                    debugmsg( "submap %d,%d,%d was already loaded", elem.first.x, elem.first.y, elem.first.z );
+                }
+            }
+            break;
+        case saved_quad_data::format::json: {
+            std::istringstream fin( saved.data );
+            JsonIn jsin( fin, saved.path );
+            deserialize( jsin );
+            break;
         }
     }
-
-    using namespace std::placeholders;
-    if( !read_from_file_optional_json( quad_path, std::bind( &mapbuffer::deserialize, this, _1 ) ) ) {
-        // If it doesn't exist, trigger generating it.
-        return nullptr;
-    }
     if( submaps.count( p ) == 0 ) {
         debugmsg( "file %s did not contain the expected submap %d,%d,%d",
-                  quad_path, p.x, p.y, p.z );
+                  saved.path, p.x, p.y, p.z );
         return nullptr;
     }
     return submaps[ p ].get();
@@ -300,3 +492,56 @@ void mapbuffer::deserialize( JsonIn &jsin )
         }
     }
 }
+
+int mapbuffer::convert_saved_maps( bool to_binary )
+{
+    const std::string maps_dir = g->get_world_base_save_path() + "/maps";
+    // Files are touched directly below, nothing may be read or written in the background
+    wait_for_io();
+    io->drop_prefetches_except( {} );
+    int converted = 0;
+    if( to_binary ) {
+        std::map<tripoint, map_segment_changes> segment_changes;
+        for( const std::string &quad_path : get_files_from_path( ".map", maps_dir, true, true ) ) {
+            mapbuffer loaded;
+            using namespace std::placeholders;
+            if( !read_from_file_optional_json( quad_path, std::bind( &mapbuffer::deserialize, &loaded,
+                                               _1 ) ) || loaded.submaps.empty() ) {
+                continue;
+            }
+            quad_submap_list quad;
+            for( const auto &elem : loaded.submaps ) {
+                quad.emplace_back( elem.first, elem.second.get() );
+            }
+            const tripoint om_addr = sm_to_omt_copy( quad.front().first );
+            map_segment_changes &changes = segment_changes[omt_to_seg_copy( om_addr )];
+            changes.quads[om_addr] = map_segment_file::encode_quad( quad );
+            changes.legacy_files.push_back( quad_path );
+            converted++;
+        }
+        for( const std::pair<const tripoint, map_segment_changes> &changes : segment_changes ) {
+            get_segment_file( find_segment_path( changes.first ) ).update( changes.second );
+            for( const std::string &legacy_file : changes.second.legacy_files ) {
+                remove_file( legacy_file );
+            }
+        }
+    } else {
+        for( const std::string &segment_path : get_files_from_path( ".seg", maps_dir, false, true ) ) {
+            map_segment_file segment( segment_path );
+            for( const tripoint &om_addr : segment.quads() ) {
+                const map_quad_submaps loaded = segment.read_quad( om_addr );
+                quad_submap_list quad;
+                for( const std::pair<tripoint, std::unique_ptr<submap>> &elem : loaded ) {
+                    quad.emplace_back( elem.first, elem.second.get() );
+                }
+                const std::string dirname = find_dirname( om_addr );
+                assure_dir_exist( dirname );
+                write_text_file( find_quad_path( dirname, om_addr ), encode_quad_json( quad ) );
+                converted++;
+            }
+            remove_file( segment_path );
+        }
+        segment_files.clear();
+    }
+    return converted;
+}
@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_MAPBUFFER_H
 #define CATA_SRC_MAPBUFFER_H
 
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -12,6 +13,9 @@
 
 class submap;
 class JsonIn;
+class map_io_queue;
+class map_segment_file;
+struct saved_quad_data;
 
 /**
  * Store, buffer, save and load the entire world map.
@@ -23,14 +27,38 @@ class mapbuffer
         ~mapbuffer();
 
         /** Store all submaps in this instance into savefiles.
+         * The submaps are encoded right away, the files are written in the background.
          * @param delete_after_save If true, the saved submaps are removed
          * from the mapbuffer (and deleted).
          **/
         void save( bool delete_after_save = false );
 
+        /** Blocks until every file queued by @ref save is written. */
+        void wait_for_io();
+
+        /**
+         * Starts reading the saved quads just beyond the edge of the map at abs_sub,
+         * on the sides it is moving towards, so loading them later does not wait on the disk.
+         * @param direction Sign of the movement on each axis.
+         * @param distance How many submaps past the edge to read.
+         */
+        void prefetch_ahead( const tripoint &abs_sub, point direction, int distance, int zmin, int zmax );
+        /** Whether the quad at om_addr has been read ahead and is waiting to be loaded. */
+        bool is_prefetched( const tripoint &om_addr );
+        // Cleared by benchmarks to compare with loading everything on demand
+        bool prefetch_enabled = true;
+
         /** Delete all buffered submaps. **/
         void clear();
 
+        /**
+         * Rewrites every saved quad of the current world in the binary segment format
+         * (see @ref map_segment_file) or back to the legacy JSON files.
+         * Submaps held in the buffer are not touched, call @ref save first.
+         * @return The number of quads converted.
+         */
+        int convert_saved_maps( bool to_binary );
+
         /** Add a new submap to the buffer.
          *
          * @param x, y, z The absolute world position in submap coordinates.
@@ -74,6 +102,8 @@ class mapbuffer
         }
 
     private:
+        struct segment_save;
+
         // There's a very good reason this is private,
         // if not handled carefully, this can erase in-use submaps and crash the game.
         void remove_submap( tripoint addr );
@@ -81,8 +111,18 @@ class mapbuffer
         void deserialize( JsonIn &jsin );
         void save_quad( const std::string &dirname, const std::string &filename,
                         const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                        bool delete_after_save );
+                        bool delete_after_save, std::map<tripoint, segment_save> &segment_saves );
+        void queue_segment_save( segment_save &&save );
+        void report_io_errors();
+        /** Reads the saved data of a quad, runs on the io thread. */
+        std::function<saved_quad_data()> make_read_job( const tripoint &om_addr );
+        /** Only used from io jobs, or while the io thread is idle. */
+        map_segment_file &get_segment_file( const std::string &path );
         submap_map_t submaps;
+        // Segment files used so far, keyed by path
+        std::map<std::string, std::unique_ptr<map_segment_file>> segment_files;
+        // Declared last so pending writes finish before the members above go away
+        std::unique_ptr<map_io_queue> io;
 };
 
 extern mapbuffer MAPBUFFER;
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <climits>
 #include <cmath>
 #include <cstdlib>
 #include <iterator>
@@ -291,7 +292,7 @@ float monster::rate_target( Creature &c, float best, bool smart ) const
         return FLT_MAX;
     }
 
-    if( !sees( c ) ) {
+    if( !planning_sees( c ) ) {
         return FLT_MAX;
     }
 
@@ -313,14 +314,111 @@ float monster::rate_target( Creature &c, float best, bool smart ) const
     return FLT_MAX;
 }
 
+void monster::prepare_plan( const monster_plan_candidates &candidates )
+{
+    planned_sight.clear();
+    planned_sight_pos = pos();
+    planned_sight_turn = calendar::turn;
+    const bool docile = friendly != 0 && has_effect( effect_docile );
+    if( docile || has_effect( effect_ai_waiting ) ) {
+        return;
+    }
+
+    // Same cutoffs as rate_target(), with the loosest limit plan() starts from
+    const bool smart_planning = has_flag( MF_PRIORITIZE_TARGETS );
+    const int max_sight_range = std::max( type->vision_day, type->vision_night );
+    const int target_radius = smart_planning ? INT_MAX / 2 : max_sight_range - 1;
+    const auto add_candidate = [&]( const Creature & c ) {
+        const auto d = rl_dist_fast( pos(), c.pos() );
+        if( d <= 0 || ( !smart_planning && d >= max_sight_range ) ) {
+            return;
+        }
+        planned_sight.push_back( { &c, c.pos(), sees( c ) } );
+    };
+    const auto is_hostile = [this]( const mfaction_id & other ) {
+        const mf_attitude faction_att = faction.obj().attitude( other );
+        return faction_att != MFA_NEUTRAL && faction_att != MFA_FRIENDLY;
+    };
+
+    if( friendly == 0 ) {
+        add_candidate( g->u );
+    }
+    for( const std::pair<const npc *, mfaction_id> &who : candidates.npcs ) {
+        if( is_hostile( who.second ) ) {
+            add_candidate( *who.first );
+        }
+    }
+    const bool group_morale = has_flag( MF_GROUP_MORALE ) && morale < type->morale;
+    const bool swarms = has_flag( MF_SWARMS );
+    const mfaction_id player_faction = mfaction_str_id( "player" ).id();
+    const mfaction_id actual_faction = friendly == 0 ? faction : player_faction;
+    for( const monster *mon : g->critter_tracker->find_in_radius( pos(), target_radius ) ) {
+        if( mon == this ) {
+            continue;
+        }
+        const mfaction_id mon_faction = mon->friendly == 0 ? mon->faction : player_faction;
+        if( ( friendly != 0 && mon->friendly == 0 ) ||
+            ( friendly == 0 && is_hostile( mon_faction ) ) ||
+            ( ( group_morale || swarms ) && mon_faction == actual_faction ) ) {
+            add_candidate( *mon );
+        }
+    }
+
+    std::sort( planned_sight.begin(), planned_sight.end(),
+    []( const planned_sight_entry & a, const planned_sight_entry & b ) {
+        return std::less<const Creature *>()( a.critter, b.critter );
+    } );
+}
+
+bool monster::planning_sees( const Creature &c ) const
+{
+    if( planned_sight.empty() || planned_sight_pos != pos() || planned_sight_turn != calendar::turn ) {
+        return sees( c );
+    }
+    const auto iter = std::lower_bound( planned_sight.begin(), planned_sight.end(), &c,
+    []( const planned_sight_entry & entry, const Creature * critter ) {
+        return std::less<const Creature *>()( entry.critter, critter );
+    } );
+    if( iter == planned_sight.end() || iter->critter != &c || iter->critter_pos != c.pos() ) {
+        return sees( c );
+    }
+    return iter->visible;
+}
+
+void monster::update_vision_bitmap()
+{
+    if( !vision_bitmap ) {
+        vision_bitmap = cata::make_value<fov_bitmap>();
+    }
+    get_map().update_fov_bitmap( *vision_bitmap, pos() );
+    vision_bitmap_turn = calendar::turn;
+}
+
+bool monster::sees_through_map( const tripoint &t, int range ) const
+{
+    // Doors opened or walls destroyed since the update make the bitmap stale
+    if( vision_bitmap && vision_bitmap_turn == calendar::turn && vision_bitmap->covers( t ) &&
+        vision_bitmap->origin == pos() && get_map().is_fov_bitmap_current( *vision_bitmap ) ) {
+        return ( range < 0 || rl_dist( pos(), t ) <= range ) && vision_bitmap->test( t );
+    }
+    return Creature::sees_through_map( t, range );
+}
+
 void monster::plan()
 {
-    const auto &factions = g->critter_tracker->factions();
+    // Sight checked by prepare_plan() only applies to the first plan of the turn
+    on_out_of_scope forget_planned_sight( [this]() {
+        planned_sight.clear();
+    } );
+    const Creature_tracker &tracker = *g->critter_tracker;
+    const auto &factions = tracker.factions();
 
     // Bots are more intelligent than most living stuff
     bool smart_planning = has_flag( MF_PRIORITIZE_TARGETS );
     Creature *target = nullptr;
     int max_sight_range = std::max( type->vision_day, type->vision_night );
+    // Without smart planning rate_target() rules out monsters at max_sight_range and beyond
+    const int target_radius = smart_planning ? INT_MAX / 2 : max_sight_range - 1;
     // 8.6f is rating for tank drone 60 tiles away, moose 16 or boomer 33
     float dist = !smart_planning ? max_sight_range : 8.6f;
     bool fleeing = false;
@@ -338,7 +436,7 @@ void monster::plan()
     auto mood = attitude();
 
     // If we can see the player, move toward them or flee, simpleminded animals are too dumb to follow the player.
-    if( friendly == 0 && sees( g->u ) && !waiting ) {
+    if( friendly == 0 && planning_sees( g->u ) && !waiting ) {
         dist = rate_target( g->u, dist, smart_planning );
         fleeing = fleeing || is_fleeing( g->u );
         target = &g->u;
@@ -376,11 +474,11 @@ void monster::plan()
             }
         }
     } else if( friendly != 0 && !docile && !waiting ) {
-        for( monster &tmp : g->all_monsters() ) {
-            if( tmp.friendly == 0 ) {
-                float rating = rate_target( tmp, dist, smart_planning );
+        for( monster *tmp : tracker.find_in_radius( pos(), target_radius ) ) {
+            if( tmp->friendly == 0 ) {
+                float rating = rate_target( *tmp, dist, smart_planning );
                 if( rating < dist ) {
-                    target = &tmp;
+                    target = tmp;
                     dist = rating;
                 }
             }
@@ -449,35 +547,30 @@ void monster::plan()
 
     fleeing = fleeing || ( mood == MATT_FLEE );
     if( friendly == 0 ) {
-        for( const auto &fac : factions ) {
-            auto faction_att = faction.obj().attitude( fac.first );
+        const mfaction_id player_faction = mfaction_str_id( "player" ).id();
+        for( monster *mon_ptr : tracker.find_in_radius( pos(), target_radius ) ) {
+            monster &mon = *mon_ptr;
+            auto faction_att = faction.obj().attitude( mon.friendly == 0 ? mon.faction : player_faction );
             if( faction_att == MFA_NEUTRAL || faction_att == MFA_FRIENDLY ) {
                 continue;
             }
 
-            for( const weak_ptr_fast<monster> &weak : fac.second ) {
-                const shared_ptr_fast<monster> shared = weak.lock();
-                if( !shared ) {
-                    continue;
-                }
-                monster &mon = *shared;
-                float rating = rate_target( mon, dist, smart_planning );
-                if( rating == dist ) {
-                    ++valid_targets;
-                    if( one_in( valid_targets ) ) {
-                        target = &mon;
-                    }
-                }
-                if( rating < dist ) {
+            float rating = rate_target( mon, dist, smart_planning );
+            if( rating == dist ) {
+                ++valid_targets;
+                if( one_in( valid_targets ) ) {
                     target = &mon;
-                    dist = rating;
-                    valid_targets = 1;
-                }
-                if( rating <= 5 ) {
-                    anger += angers_hostile_near;
-                    morale -= fears_hostile_near;
                 }
             }
+            if( rating < dist ) {
+                target = &mon;
+                dist = rating;
+                valid_targets = 1;
+            }
+            if( rating <= 5 ) {
+                anger += angers_hostile_near;
+                morale -= fears_hostile_near;
+            }
         }
     }
 
@@ -494,12 +587,8 @@ void monster::plan()
     }
     swarms = swarms && target == nullptr; // Only swarm if we have no target
     if( group_morale || swarms ) {
-        for( const weak_ptr_fast<monster> &weak : myfaction_iter->second ) {
-            const shared_ptr_fast<monster> shared = weak.lock();
-            if( !shared ) {
-                continue;
-            }
-            monster &mon = *shared;
+        for( monster *mon_ptr : tracker.find_in_radius( pos(), target_radius, actual_faction ) ) {
+            monster &mon = *mon_ptr;
             float rating = rate_target( mon, dist, smart_planning );
             if( group_morale && rating <= 10 ) {
                 morale += 10 - rating;
@@ -867,7 +956,8 @@ void monster::move()
             if( pf_settings.max_dist >= rl_dist( pos(), goal ) &&
                 ( path.empty() || rl_dist( pos(), path.front() ) >= 2 || path.back() != goal ) ) {
                 // We need a new path
-                path = g->m.route( pos(), goal, pf_settings, get_path_avoid() );
+                // Hordes often chase the same target, so share the search with them
+                path = g->m.route_shared( pos(), goal, pf_settings, get_path_avoid() );
             }
 
             // Try to respect old paths, even if we can't pathfind at the moment
@@ -22,6 +22,7 @@
 #include "damage.h"
 #include "effect.h"
 #include "enums.h"
+#include "fov_bitmap.h"
 #include "pldata.h"
 #include "point.h"
 #include "type_id.h"
@@ -35,6 +36,7 @@ class JsonObject;
 class JsonOut;
 class effect;
 class item;
+class npc;
 class player;
 struct dealt_projectile_attack;
 struct pathfinding_settings;
@@ -42,6 +44,12 @@ struct trap;
 
 enum class mon_trigger;
 
+/** Creatures that monsters may consider as targets, collected once per turn for monster::prepare_plan(). */
+struct monster_plan_candidates {
+    /** NPCs along with their monster faction */
+    std::vector<std::pair<const npc *, mfaction_id>> npcs;
+};
+
 class mon_special_attack
 {
     public:
@@ -216,6 +224,17 @@ class monster : public Creature, public visitable<monster>
 
         // How good of a target is given creature (checks for visibility)
         float rate_target( Creature &c, float best, bool smart = false ) const;
+        /**
+         * Checks ahead of time which of the candidates the next plan() may rate can be seen.
+         * Only reads shared state, so it may run for many monsters at once.
+         */
+        void prepare_plan( const monster_plan_candidates &candidates );
+        /**
+         * Casts the field of view used by @ref sees for the rest of the turn, unless the one
+         * from an earlier turn is still valid. Changes to the map during the turn make
+         * @ref sees fall back to lines of sight. Only reads shared state, like @ref prepare_plan.
+         */
+        void update_vision_bitmap();
         void plan();
         void move(); // Actual movement
         void footsteps( const tripoint &p ); // noise made by movement
@@ -568,10 +587,31 @@ class monster : public Creature, public visitable<monster>
         std::bitset<NUM_MEFF> effect_cache;
         std::optional<time_duration> summon_time_limit = std::nullopt;
 
+        struct planned_sight_entry {
+            const Creature *critter;
+            tripoint critter_pos;
+            bool visible;
+        };
+        /** Results of prepare_plan(), sorted by creature. Only valid this turn and while neither side has moved. */
+        std::vector<planned_sight_entry> planned_sight;
+        tripoint planned_sight_pos;
+        time_point planned_sight_turn;
+        /** Like sees(), but uses the result of prepare_plan() if there is one. */
+        bool planning_sees( const Creature &c ) const;
+
+        /**
+         * Field of view from update_vision_bitmap(), only used in the turn it was updated and
+         * while the map around it stays the same.
+         */
+        cata::value_ptr<fov_bitmap> vision_bitmap;
+        time_point vision_bitmap_turn;
+
         player *find_dragged_foe();
         void nursebot_operate( player *dragged_foe );
 
     protected:
+        bool sees_through_map( const tripoint &t, int range ) const override;
+
         void store( JsonOut &json ) const;
         void load( const JsonObject &data );
 
@@ -105,15 +105,7 @@ bool Character::has_trait( const trait_id &b ) const
 
 bool Character::has_trait_flag( const std::string &b ) const
 {
-    // UGLY, SLOW, should be cached as my_mutation_flags or something
-    for( const trait_id &mut : get_mutations() ) {
-        const mutation_branch &mut_data = mut.obj();
-        if( mut_data.flags.count( b ) > 0 ) {
-            return true;
-        }
-    }
-
-    return false;
+    return cached_mutation_flags.test( mutation_branch::flag_index( b ) );
 }
 
 bool Character::has_base_trait( const trait_id &b ) const
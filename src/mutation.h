@@ -15,6 +15,7 @@
 #include "calendar.h"
 #include "creature.h"
 #include "damage.h"
+#include "flag_bitset.h"
 #include "hash_utils.h"
 #include "memory_fast.h"
 #include "point.h"
@@ -264,6 +265,8 @@ struct mutation_branch {
         std::vector<trait_id> additions; // Mutations that add to this one
         std::vector<std::string> category; // Mutation Categories
         std::set<std::string> flags; // Mutation flags
+        /** @ref flags by the ids from @ref flag_index, filled in by @ref finalize */
+        flag_bitset flag_bits;
         std::map<body_part, tripoint> protection; // Mutation wet effects
         std::map<body_part, int> encumbrance_always; // Mutation encumbrance that always applies
         // Mutation encumbrance that applies when covered with unfitting item
@@ -323,6 +326,12 @@ struct mutation_branch {
          */
         static bool trait_is_blacklisted( const trait_id &tid );
 
+        /**
+         * Dense id of a mutation flag, -1 if no mutation has it.
+         * Ids are assigned in @ref finalize and stay valid until @ref reset_all.
+         */
+        static int flag_index( const std::string &flag );
+
         /** called after all JSON has been read and performs any necessary cleanup tasks */
         static void finalize();
         static void finalize_trait_blacklist();
@@ -6,6 +6,8 @@
 #include <memory>
 #include <set>
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "assign.h"
@@ -58,6 +60,8 @@ std::string enum_to_string<m_size>( m_size data )
 namespace
 {
 generic_factory<mutation_branch> trait_factory( "trait" );
+/** Dense ids of the flags of all mutations, see mutation_branch::flag_index */
+std::unordered_map<std::string, int> trait_flag_ids;
 } // namespace
 
 static std::vector<dream> all_dreams;
@@ -650,6 +654,7 @@ void mutation_branch::reset_all()
     mutations_category.clear();
     trait_factory.reset();
     trait_blacklist.clear();
+    trait_flag_ids.clear();
     trait_groups.clear();
     trait_groups.emplace( trait_group::Trait_group_tag( "EMPTY_GROUP" ),
                           make_shared_fast<Trait_group_collection>( 100 ) );
@@ -715,12 +720,23 @@ bool mutation_branch::trait_is_blacklisted( const trait_id &tid )
     return trait_blacklist.count( tid );
 }
 
+int mutation_branch::flag_index( const std::string &flag )
+{
+    const auto iter = trait_flag_ids.find( flag );
+    return iter != trait_flag_ids.end() ? iter->second : -1;
+}
+
 void mutation_branch::finalize()
 {
-    for( const mutation_branch &branch : get_all() ) {
+    for( mutation_branch &branch : const_cast<std::vector<mutation_branch>&>( get_all() ) ) {
         for( const std::string &cat : branch.category ) {
             mutations_category[cat].push_back( trait_id( branch.id ) );
         }
+        branch.flag_bits.clear();
+        for( const std::string &flag : branch.flags ) {
+            const auto iter = trait_flag_ids.emplace( flag, static_cast<int>( trait_flag_ids.size() ) );
+            branch.flag_bits.set( iter.first->second );
+        }
     }
     finalize_trait_blacklist();
 }
@@ -2888,6 +2888,7 @@ void Character::clear_mutations()
         unset_mutation( my_mutations.begin()->first );
     }
     cached_mutations.clear();
+    cached_mutation_flags.clear();
 }
 
 void Character::clear_skills()
@@ -0,0 +1,56 @@
+#include "npc_threat_field.h"
+
+#include <cstdlib>
+
+#include "field_type.h"
+#include "game.h"
+#include "game_constants.h"
+#include "map.h"
+#include "mapdata.h"
+#include "monster.h"
+#include "mtype.h"
+
+void npc_threat_field::build( const map &here )
+{
+    clear();
+
+    for( monster &critter : g->all_monsters() ) {
+        monster_threats.push_back( { g->shared_from( critter ), static_cast<float>( critter.type->difficulty ) } );
+    }
+
+    const int zmin = here.has_zlevels() ? -OVERMAP_DEPTH : here.get_abs_sub().z;
+    const int zmax = here.has_zlevels() ? OVERMAP_HEIGHT : here.get_abs_sub().z;
+    for( int z = zmin; z <= zmax; z++ ) {
+        for( const tripoint &p : here.get_field_tiles( fd_fire, z ) ) {
+            if( !here.has_flag( TFLAG_FIRE_CONTAINER, p ) ) {
+                fires.push_back( p );
+            }
+        }
+    }
+    built = true;
+}
+
+void npc_threat_field::clear()
+{
+    built = false;
+    monster_threats.clear();
+    fires.clear();
+}
+
+std::vector<tripoint> npc_threat_field::fires_near( const tripoint &center, int radius ) const
+{
+    std::vector<tripoint> result;
+    for( const tripoint &p : fires ) {
+        if( p.z == center.z && p != center && std::abs( p.x - center.x ) <= radius &&
+            std::abs( p.y - center.y ) <= radius ) {
+            result.push_back( p );
+        }
+    }
+    return result;
+}
+
+npc_threat_field &get_npc_threat_field()
+{
+    static npc_threat_field field;
+    return field;
+}
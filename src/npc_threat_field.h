@@ -0,0 +1,61 @@
+#pragma once
+#ifndef CATA_SRC_NPC_THREAT_FIELD_H
+#define CATA_SRC_NPC_THREAT_FIELD_H
+
+#include <vector>
+
+#include "memory_fast.h"
+#include "point.h"
+
+class map;
+class monster;
+
+/**
+ * The part of npc::assess_danger that does not depend on which NPC is asking:
+ * the monsters that may threaten someone and the tiles that are on fire.
+ * game::monmove builds it once before the NPCs move, so a camp of followers
+ * does not rescan the map and every monster's stats once per NPC.
+ * Everything that depends on the NPC (attitude, sight, rules, friends) is
+ * still checked by each NPC on its own.
+ */
+class npc_threat_field
+{
+    public:
+        struct monster_threat {
+            weak_ptr_fast<monster> critter;
+            /** Difficulty of the monster's type */
+            float difficulty;
+        };
+
+        /** Rebuilds the field from the current state of @p here and its monsters. */
+        void build( const map &here );
+        /** Drops the field, NPCs will scan on their own until it is built again. */
+        void clear();
+        bool is_built() const {
+            return built;
+        }
+
+        /**
+         * Monsters in the order of @ref game::all_monsters when the field was built.
+         * Monsters that died or were removed since then are still listed, and must be
+         * skipped unless @ref game::shared_from still finds them.
+         */
+        const std::vector<monster_threat> &monsters() const {
+            return monster_threats;
+        }
+        /**
+         * Tiles with uncontained fire within @p radius (@ref square_dist, same z-level)
+         * of @p center, not counting @p center itself.
+         */
+        std::vector<tripoint> fires_near( const tripoint &center, int radius ) const;
+
+    private:
+        bool built = false;
+        std::vector<monster_threat> monster_threats;
+        std::vector<tripoint> fires;
+};
+
+/** Field shared by all NPCs during the NPC pass of @ref game::monmove. */
+npc_threat_field &get_npc_threat_field();
+
+#endif // CATA_SRC_NPC_THREAT_FIELD_H
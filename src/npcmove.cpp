@@ -49,6 +49,7 @@
 #include "mission.h"
 #include "monster.h"
 #include "mtype.h"
+#include "npc_threat_field.h"
 #include "npctalk.h"
 #include "options.h"
 #include "overmap.h"
@@ -421,21 +422,21 @@ void npc::assess_danger()
     for( direction threat_dir : npc_threat_dir ) {
         cur_threat_map[ threat_dir ] = 0.25f * ai_cache.threat_map[ threat_dir ];
     }
-    map &here = get_map();
+    // Outside of the NPC pass of game::monmove nobody shares the field, so build our own
+    npc_threat_field own_field;
+    const npc_threat_field *field = &get_npc_threat_field();
+    if( !field->is_built() ) {
+        own_field.build( get_map() );
+        field = &own_field;
+    }
     // first, check if we're about to be consumed by fire
-    // TODO: Use the field cache
-    for( const tripoint &pt : here.points_in_radius( pos(), 6 ) ) {
-        if( pt == pos() || here.has_flag( TFLAG_FIRE_CONTAINER,  pt ) ) {
-            continue;
-        }
-        if( here.get_field( pt, fd_fire ) != nullptr ) {
-            int dist = rl_dist( pos(), pt );
-            cur_threat_map[direction_from( pos(), pt )] += 2.0f * ( NPC_DANGER_MAX - dist );
-            if( dist < 3 && !has_effect( effect_npc_fire_bad ) ) {
-                warn_about( "fire_bad", 1_minutes );
-                add_effect( effect_npc_fire_bad, 5_turns );
-                path.clear();
-            }
+    for( const tripoint &pt : field->fires_near( pos(), 6 ) ) {
+        int dist = rl_dist( pos(), pt );
+        cur_threat_map[direction_from( pos(), pt )] += 2.0f * ( NPC_DANGER_MAX - dist );
+        if( dist < 3 && !has_effect( effect_npc_fire_bad ) ) {
+            warn_about( "fire_bad", 1_minutes );
+            add_effect( effect_npc_fire_bad, 5_turns );
+            path.clear();
         }
     }
 
@@ -460,10 +461,16 @@ void npc::assess_danger()
         }
     }
 
-    for( const monster &critter : g->all_monsters() ) {
+    for( const npc_threat_field::monster_threat &entry : field->monsters() ) {
+        const shared_ptr_fast<monster> critter_ptr = entry.critter.lock();
+        // Dead or removed by an EMP, a trap or the like since the field was built
+        if( !critter_ptr || !g->shared_from( *critter_ptr ) ) {
+            continue;
+        }
+        const monster &critter = *critter_ptr;
         auto att = critter.attitude_to( *this );
         if( att == A_FRIENDLY ) {
-            ai_cache.friends.emplace_back( g->shared_from( critter ) );
+            ai_cache.friends.emplace_back( critter_ptr );
             continue;
         }
         if( att != A_HOSTILE && ( critter.friendly || !is_enemy() ) ) {
@@ -472,7 +479,8 @@ void npc::assess_danger()
         if( !sees( critter ) ) {
             continue;
         }
-        float critter_threat = evaluate_enemy( critter );
+        // Same as evaluate_enemy( critter ), without the dynamic_cast
+        float critter_threat = std::min( entry.difficulty, NPC_DANGER_MAX );
         // warn and consider the odds for distant enemies
         int dist = rl_dist( pos(), critter.pos() );
         if( ( is_enemy() || !critter.friendly ) ) {
@@ -522,7 +530,7 @@ void npc::assess_danger()
         cur_threat_map[direction_from( pos(), critter.pos() )] += priority;
         if( priority > highest_priority ) {
             highest_priority = priority;
-            ai_cache.target = g->shared_from( critter );
+            ai_cache.target = critter_ptr;
             ai_cache.danger = critter_danger;
         }
     }
@@ -2100,6 +2100,21 @@ void options_manager::add_options_debug()
          false
        );
 
+    add( "BINARY_MAP_SAVES", debug, translate_marker( "Binary map saves" ),
+         translate_marker( "If true, saved map areas are written as one compact binary file per map segment instead of JSON files.  Both formats can always be loaded.  Existing saves can be converted from the debug menu." ),
+         false
+       );
+
+    add( "DATA_SNAPSHOT", debug, translate_marker( "Game data snapshot" ),
+         translate_marker( "If true, the data files of the loaded content packs are kept in one snapshot file in the config directory.  Later starts with unchanged data read that one file instead of every data file on its own." ),
+         false
+       );
+
+    add( "MONSTER_VISION_BITMAPS", debug, translate_marker( "Monster vision maps" ),
+         translate_marker( "If true, monsters compute their whole field of view once per turn by shadowcasting, and only again after they move or their surroundings change.  Faster with many monsters, but what they see can differ slightly from the default line of sight checks next to corners." ),
+         false
+       );
+
     add_empty_line();
 
     add_option_group( debug, Group( "debug_log", to_translation( "Logging" ),
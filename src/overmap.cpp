@@ -1228,6 +1228,7 @@ oter_id overmap::get_default_terrain( int z ) const
 
 void overmap::init_layers()
 {
+    terrain_index_built = false;
     for( int k = 0; k < OVERMAP_LAYERS; ++k ) {
         const oter_id tid = get_default_terrain( k - OVERMAP_DEPTH );
 
@@ -1249,6 +1250,9 @@ void overmap::ter_set( const tripoint_om_omt &p, const oter_id &id )
     }
 
     layer[p.z() + OVERMAP_DEPTH].terrain[p.x()][p.y()] = id;
+    if( terrain_index_built ) {
+        terrain_index[id].set( terrain_chunk( p ) );
+    }
 }
 
 const oter_id &overmap::ter( const tripoint_om_omt &p ) const
@@ -4003,6 +4007,66 @@ bool overmap::check_ot( const std::string &otype, ot_match_type match_type,
     return is_ot_match( otype, oter, match_type );
 }
 
+std::vector<tripoint_om_omt> overmap::find_matching_terrain(
+    const std::vector<std::pair<std::string, ot_match_type>> &types, int min_z, int max_z )
+{
+    if( !terrain_index_built ) {
+        terrain_index.clear();
+        for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+            const oter_id *last = nullptr;
+            terrain_chunk_set *last_chunks = nullptr;
+            for( int y = 0; y < OMAPY; y++ ) {
+                for( int x = 0; x < OMAPX; x++ ) {
+                    const oter_id &here = layer[z + OVERMAP_DEPTH].terrain[x][y];
+                    // Terrain comes in large runs, skip the lookup for those
+                    if( last == nullptr || *last != here ) {
+                        last = &here;
+                        last_chunks = &terrain_index[here];
+                    }
+                    last_chunks->set( terrain_chunk( tripoint_om_omt( x, y, z ) ) );
+                }
+            }
+        }
+        terrain_index_built = true;
+    }
+
+    const auto matches = [&types]( const oter_id & oter ) {
+        return std::any_of( types.begin(), types.end(),
+        [&oter]( const std::pair<std::string, ot_match_type> &type ) {
+            return is_ot_match( type.first, oter, type.second );
+        } );
+    };
+    terrain_chunk_set chunks;
+    for( const std::pair<const oter_id, terrain_chunk_set> &entry : terrain_index ) {
+        if( matches( entry.first ) ) {
+            chunks |= entry.second;
+        }
+    }
+
+    std::vector<tripoint_om_omt> result;
+    if( chunks.none() ) {
+        return result;
+    }
+    for( int z = std::max( min_z, -OVERMAP_DEPTH ); z <= std::min( max_z, OVERMAP_HEIGHT ); z++ ) {
+        for( int cy = 0; cy < OMAPY; cy += terrain_chunk_size ) {
+            for( int cx = 0; cx < OMAPX; cx += terrain_chunk_size ) {
+                if( !chunks.test( terrain_chunk( tripoint_om_omt( cx, cy, z ) ) ) ) {
+                    continue;
+                }
+                for( int y = cy; y < cy + terrain_chunk_size; y++ ) {
+                    for( int x = cx; x < cx + terrain_chunk_size; x++ ) {
+                        const tripoint_om_omt p( x, y, z );
+                        if( matches( ter( p ) ) ) {
+                            result.push_back( p );
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
 bool overmap::check_overmap_special_type( const overmap_special_id &id,
         const tripoint_om_omt &location ) const
 {
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <array>
+#include <bitset>
 #include <climits>
 #include <cstdlib>
 #include <functional>
@@ -352,6 +353,21 @@ class overmap
         // TODO: Should have individual instances grouped by placement (ie. 2 adjacent houses aren't one house)
         std::unordered_map<tripoint_om_omt, overmap_special_id> overmap_special_placements;
 
+        // Square chunks of overmap terrains on one z-level, the unit of the terrain index
+        static constexpr int terrain_chunk_size = 12;
+        static constexpr int terrain_chunks_per_row = OMAPX / terrain_chunk_size;
+        static_assert( OMAPX % terrain_chunk_size == 0, "terrain chunks have to fill the overmap" );
+        using terrain_chunk_set = std::bitset<terrain_chunks_per_row *terrain_chunks_per_row *OVERMAP_LAYERS>;
+        // The chunks each terrain was placed in. Built by the first terrain search and kept up
+        // to date by ter_set. Chunks are not dropped when terrain is replaced, so it may list
+        // chunks that no longer hold the terrain.
+        std::unordered_map<oter_id, terrain_chunk_set> terrain_index;
+        bool terrain_index_built = false;
+        static int terrain_chunk( const tripoint_om_omt &p ) {
+            return ( ( p.z() + OVERMAP_DEPTH ) * terrain_chunks_per_row + p.y() / terrain_chunk_size ) *
+                   terrain_chunks_per_row + p.x() / terrain_chunk_size;
+        }
+
         pimpl<regional_settings> settings;
 
         oter_id get_default_terrain( int z ) const;
@@ -445,6 +461,12 @@ class overmap
         // Polishing
         bool check_ot( const std::string &otype, ot_match_type match_type,
                        const tripoint_om_omt &p ) const;
+        /**
+         * Every location between the given z-levels whose terrain matches one of the types,
+         * found through the terrain index instead of checking every location.
+         */
+        std::vector<tripoint_om_omt> find_matching_terrain(
+            const std::vector<std::pair<std::string, ot_match_type>> &types, int min_z, int max_z );
         bool check_overmap_special_type( const overmap_special_id &id,
                                          const tripoint_om_omt &location ) const;
         void chip_rock( const tripoint_om_omt &p );
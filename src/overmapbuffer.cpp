@@ -1008,6 +1008,101 @@ tripoint_abs_omt overmapbuffer::find_closest(
     return find_closest( origin, params );
 }
 
+/**
+ * Position of a point in the order closest_points_first lists the points around a center:
+ * the square distance first, then the index on that ring. Each ring starts next to its
+ * top right corner and goes down the right side, then along the bottom, the left side
+ * and the top.
+ */
+using spiral_position = std::pair<int, int>;
+
+static spiral_position get_spiral_position( point offset )
+{
+    const int r = std::max( std::abs( offset.x ), std::abs( offset.y ) );
+    if( r == 0 ) {
+        return { 0, 0 };
+    }
+    if( offset.x == r && offset.y > -r ) {
+        return { r, offset.y - ( 1 - r ) };
+    }
+    if( offset.y == r ) {
+        return { r, 2 * r + ( r - 1 - offset.x ) };
+    }
+    if( offset.x == -r ) {
+        return { r, 4 * r + ( r - 1 - offset.y ) };
+    }
+    return { r, 6 * r + ( offset.x - ( 1 - r ) ) };
+}
+
+/**
+ * The first position closest_points_first( origin, min_dist, max_dist ) reaches inside the
+ * rectangle, given as offsets from the origin. Empty if it never gets there.
+ */
+static std::optional<spiral_position> first_spiral_position( const inclusive_rectangle<point> &rect,
+        int min_dist, int max_dist )
+{
+    const auto axis_dist = []( int low, int high ) {
+        return low > 0 ? low : high < 0 ? -high : 0;
+    };
+    const int nearest = std::max( axis_dist( rect.p_min.x, rect.p_max.x ),
+                                  axis_dist( rect.p_min.y, rect.p_max.y ) );
+    const int farthest = std::max( { std::abs( rect.p_min.x ), std::abs( rect.p_max.x ),
+                                     std::abs( rect.p_min.y ), std::abs( rect.p_max.y )
+                                   } );
+    const int r = std::max( nearest, std::max( min_dist, 0 ) );
+    if( r > max_dist || r > farthest ) {
+        return std::nullopt;
+    }
+    if( r == 0 ) {
+        return spiral_position( 0, 0 );
+    }
+    // Walk the four sides of the ring in order, the first one crossing the rectangle wins
+    const auto crosses = []( int low, int high, int v ) {
+        return low <= v && v <= high;
+    };
+    if( crosses( rect.p_min.x, rect.p_max.x, r ) && std::max( 1 - r, rect.p_min.y ) <= std::min( r,
+            rect.p_max.y ) ) {
+        return get_spiral_position( point( r, std::max( 1 - r, rect.p_min.y ) ) );
+    }
+    if( crosses( rect.p_min.y, rect.p_max.y, r ) && std::max( -r, rect.p_min.x ) <= std::min( r - 1,
+            rect.p_max.x ) ) {
+        return get_spiral_position( point( std::min( r - 1, rect.p_max.x ), r ) );
+    }
+    if( crosses( rect.p_min.x, rect.p_max.x, -r ) && std::max( -r, rect.p_min.y ) <= std::min( r - 1,
+            rect.p_max.y ) ) {
+        return get_spiral_position( point( -r, std::min( r - 1, rect.p_max.y ) ) );
+    }
+    return get_spiral_position( point( std::max( 1 - r, rect.p_min.x ), -r ) );
+}
+
+/**
+ * Overmaps the search around origin covers, in the order closest_points_first first reaches
+ * them, each with the first position reached inside it.
+ */
+static std::vector<std::pair<spiral_position, point_abs_om>> overmaps_in_search_order(
+            const point_abs_omt &origin, int min_dist, int max_dist )
+{
+    std::vector<std::pair<spiral_position, point_abs_om>> result;
+    if( min_dist > max_dist || max_dist < 0 ) {
+        return result;
+    }
+    const point_abs_om min_om = project_to<coords::om>( origin - point( max_dist, max_dist ) );
+    const point_abs_om max_om = project_to<coords::om>( origin + point( max_dist, max_dist ) );
+    for( int y = min_om.y(); y <= max_om.y(); y++ ) {
+        for( int x = min_om.x(); x <= max_om.x(); x++ ) {
+            const point_abs_om om_pos( x, y );
+            const point corner = project_to<coords::omt>( om_pos ).raw() - origin.raw();
+            const inclusive_rectangle<point> rect( corner, corner + point( OMAPX - 1, OMAPY - 1 ) );
+            if( const std::optional<spiral_position> first = first_spiral_position( rect, min_dist,
+                    max_dist ) ) {
+                result.emplace_back( *first, om_pos );
+            }
+        }
+    }
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
 tripoint_abs_omt overmapbuffer::find_closest( const tripoint_abs_omt &origin,
         const omt_find_params &params )
 {
@@ -1034,68 +1129,95 @@ tripoint_abs_omt overmapbuffer::find_closest( const tripoint_abs_omt &origin,
     const int min_dist = params.min_distance;
     const int max_dist = params.search_range ? params.search_range : OMAPX * 5;
 
-    std::vector<tripoint_abs_omt> result;
-    std::optional<int> found_dist;
-
-    size_t num_overmaps = overmaps.size();
-    size_t counter = 0;
-
-    for( const point_abs_omt &loc_xy : closest_points_first( origin.xy(), min_dist, max_dist ) ) {
-        const int dist_xy = square_dist( origin.xy(), loc_xy );
-
-        if( found_dist && *found_dist < dist_xy ) {
-            break;
-        }
-
-        for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
-            const tripoint_abs_omt loc( loc_xy, z );
-            const int dist = square_dist( origin, loc );
-
+    // Matching locations found so far, in the order closest_points_first visits them, then by z.
+    // Overmaps are only looked at (and created) once the search reaches them, like a search
+    // checking every location would.
+    std::vector<std::pair<std::pair<spiral_position, int>, tripoint_abs_omt>> candidates;
+    const std::vector<std::pair<spiral_position, point_abs_om>> search_overmaps =
+        overmaps_in_search_order( origin.xy(), min_dist, max_dist );
+
+    for( size_t next_om = 0; ; next_om++ ) {
+        // Rings closer than the next overmap are completely covered by the candidates
+        const int covered_dist = next_om < search_overmaps.size() ?
+                                 search_overmaps[next_om].first.first : INT_MAX;
+
+        std::vector<tripoint_abs_omt> result;
+        std::optional<int> found_dist;
+        for( const auto &candidate : candidates ) {
+            const int dist_xy = candidate.first.first.first;
+            if( dist_xy >= covered_dist || ( found_dist && *found_dist < dist_xy ) ) {
+                break;
+            }
+            const int dist = square_dist( origin, candidate.second );
             if( found_dist && *found_dist < dist ) {
                 continue;
             }
+            found_dist = dist;
+            result.push_back( candidate.second );
+        }
+        if( next_om == search_overmaps.size() || ( found_dist && *found_dist < covered_dist ) ) {
+            return random_entry( result, overmap::invalid_tripoint );
+        }
 
-            if( is_findable_location( loc, params ) ) {
-                found_dist = dist;
-                result.push_back( loc );
-            }
-
-            counter += 1;
-            if( params.popup && ( num_overmaps != overmaps.size() || counter == 512 ) ) {
-                params.popup->refresh();
-                num_overmaps = overmaps.size();
-                counter = 0;
+        const point_abs_om &om_pos = search_overmaps[next_om].second;
+        overmap *om = params.existing_only ? get_existing( om_pos ) : &get( om_pos );
+        if( params.popup ) {
+            params.popup->refresh();
+        }
+        if( om == nullptr ) {
+            continue;
+        }
+        for( const tripoint_om_omt &local : om->find_matching_terrain( params.types, -OVERMAP_DEPTH,
+                OVERMAP_HEIGHT ) ) {
+            const tripoint_abs_omt loc = project_combine( om_pos, local );
+            const point offset = loc.xy().raw() - origin.xy().raw();
+            const int dist_xy = square_dist( point_zero, offset );
+            if( dist_xy < min_dist || dist_xy > max_dist || !is_findable_location( loc, params ) ) {
+                continue;
             }
+            candidates.emplace_back( std::make_pair( get_spiral_position( offset ), loc.z() ), loc );
         }
+        std::sort( candidates.begin(), candidates.end() );
     }
-
-    return random_entry( result, overmap::invalid_tripoint );
 }
 
 std::vector<tripoint_abs_omt> overmapbuffer::find_all( const tripoint_abs_omt &origin,
         const omt_find_params &params )
 {
-    std::vector<tripoint_abs_omt> result;
     // dist == 0 means search a whole overmap diameter.
     const int min_dist = params.min_distance;
     const int max_dist = params.search_range ? params.search_range : OMAPX;
 
-    size_t num_overmaps = overmaps.size();
-    size_t counter = 0;
-
-    for( const tripoint_abs_omt &loc : closest_points_first( origin, min_dist, max_dist ) ) {
-        if( is_findable_location( loc, params ) ) {
-            result.push_back( loc );
-        }
-
-        counter += 1;
-        if( params.popup && ( num_overmaps != overmaps.size() || counter == 512 ) ) {
+    // Sorted into the order closest_points_first visits them at the end
+    std::vector<std::pair<spiral_position, tripoint_abs_omt>> found;
+    for( const auto &search_om : overmaps_in_search_order( origin.xy(), min_dist, max_dist ) ) {
+        const point_abs_om &om_pos = search_om.second;
+        overmap *om = params.existing_only ? get_existing( om_pos ) : &get( om_pos );
+        if( params.popup ) {
             params.popup->refresh();
-            num_overmaps = overmaps.size();
-            counter = 0;
+        }
+        if( om == nullptr ) {
+            continue;
+        }
+        for( const tripoint_om_omt &local : om->find_matching_terrain( params.types, origin.z(),
+                origin.z() ) ) {
+            const tripoint_abs_omt loc = project_combine( om_pos, local );
+            const point offset = loc.xy().raw() - origin.xy().raw();
+            const int dist_xy = square_dist( point_zero, offset );
+            if( dist_xy < std::max( min_dist, 0 ) || dist_xy > max_dist ||
+                !is_findable_location( loc, params ) ) {
+                continue;
+            }
+            found.emplace_back( get_spiral_position( offset ), loc );
         }
     }
+    std::sort( found.begin(), found.end() );
 
+    std::vector<tripoint_abs_omt> result;
+    result.reserve( found.size() );
+    for( const auto &entry : found ) {
+        result.push_back( entry.second );
+    }
     return result;
 }
 
@@ -1,9 +1,10 @@
 #include "pathfinding.h"
 
+#include <cstdint>
 #include <cstdlib>
 #include <algorithm>
+#include <iterator>
 #include <optional>
-#include <queue>
 #include <set>
 #include <array>
 #include <memory>
@@ -37,43 +38,82 @@ constexpr int flat_index( const tripoint &p )
 }
 
 // Flattened 2D array representing a single z-level worth of pathfinding data
+// Cells are stamped with the generation of the search that last touched them,
+// so a layer can be reused by the next search without clearing it first.
 struct path_data_layer {
+    std::array< uint32_t, MAPSIZE_X *MAPSIZE_Y > generation;
     // State is accessed way more often than all other values here
     std::array< astar_state, MAPSIZE_X *MAPSIZE_Y > state;
     std::array< int, MAPSIZE_X *MAPSIZE_Y > score;
     std::array< int, MAPSIZE_X *MAPSIZE_Y > gscore;
     std::array< tripoint, MAPSIZE_X *MAPSIZE_Y > parent;
 
-    void init( point min, point max ) {
-        tripoint p;
-        for( p.x = min.x; p.x <= max.x; p.x++ ) {
-            for( p.y = min.y; p.y <= max.y; p.y++ ) {
-                const int ind = flat_index( p );
-                state[ind] = ASL_NONE; // Mark as unvisited
-            }
+    // Generation of the search currently using this layer
+    uint32_t current_generation = 0;
+
+    // Resets the cell if it was last written by an older search
+    void touch( const int index ) {
+        if( generation[index] != current_generation ) {
+            generation[index] = current_generation;
+            state[index] = ASL_NONE;
+            score[index] = 0;
+            gscore[index] = 0;
         }
     }
+
+    astar_state &state_at( const int index ) {
+        touch( index );
+        return state[index];
+    }
+
+    int &score_at( const int index ) {
+        touch( index );
+        return score[index];
+    }
+
+    int &gscore_at( const int index ) {
+        touch( index );
+        return gscore[index];
+    }
 };
 
+// Search state for map::route
+// One instance is kept per thread and reused between searches, so the large
+// per-layer arrays are allocated once instead of on every call.
 struct pathfinder {
-    point min;
-    point max;
-    pathfinder( point _min, point _max ) :
-        min( _min ), max( _max ) {
-    }
+    // Generation of the current search, 0 is reserved for untouched cells
+    uint32_t generation = 0;
 
-    std::priority_queue< std::pair<int, tripoint>, std::vector< std::pair<int, tripoint> >, pair_greater_cmp_first >
-    open;
+    std::vector< std::pair<int, tripoint> > open;
     std::array< std::unique_ptr< path_data_layer >, OVERMAP_LAYERS > path_data;
 
+    static pathfinder &get_thread_instance() {
+        thread_local pathfinder instance;
+        return instance;
+    }
+
+    // Invalidates all data left over from the previous search
+    void reset() {
+        open.clear();
+        if( ++generation == 0 ) {
+            // Wrapped around, old stamps could now collide with new ones
+            for( std::unique_ptr< path_data_layer > &ptr : path_data ) {
+                if( ptr != nullptr ) {
+                    ptr->generation.fill( 0 );
+                }
+            }
+            generation = 1;
+        }
+    }
+
     path_data_layer &get_layer( const int z ) {
         std::unique_ptr< path_data_layer > &ptr = path_data[z + OVERMAP_DEPTH];
-        if( ptr != nullptr ) {
-            return *ptr;
+        if( ptr == nullptr ) {
+            // Value-initialized, so every cell starts with generation 0
+            ptr = std::make_unique<path_data_layer>();
         }
 
-        ptr = std::make_unique<path_data_layer>();
-        ptr->init( min, max );
+        ptr->current_generation = generation;
         return *ptr;
     }
 
@@ -82,16 +122,17 @@ struct pathfinder {
     }
 
     tripoint get_next() {
-        const auto pt = open.top();
-        open.pop();
-        return pt.second;
+        std::pop_heap( open.begin(), open.end(), pair_greater_cmp_first() );
+        const tripoint pt = open.back().second;
+        open.pop_back();
+        return pt;
     }
 
     void add_point( const int gscore, const int score, const tripoint &from, const tripoint &to ) {
         auto &layer = get_layer( to.z );
         const int index = flat_index( to );
-        if( ( layer.state[index] == ASL_OPEN && gscore >= layer.gscore[index] ) ||
-            layer.state[index] == ASL_CLOSED ) {
+        const astar_state st = layer.state_at( index );
+        if( ( st == ASL_OPEN && gscore >= layer.gscore[index] ) || st == ASL_CLOSED ) {
             return;
         }
 
@@ -99,22 +140,161 @@ struct pathfinder {
         layer.gscore[index] = gscore;
         layer.parent[index] = from;
         layer.score [index] = score;
-        open.push( std::make_pair( score, to ) );
+        open.emplace_back( score, to );
+        std::push_heap( open.begin(), open.end(), pair_greater_cmp_first() );
     }
 
     void close_point( const tripoint &p ) {
         auto &layer = get_layer( p.z );
         const int index = flat_index( p );
-        layer.state[index] = ASL_CLOSED;
+        layer.state_at( index ) = ASL_CLOSED;
     }
 
     void unclose_point( const tripoint &p ) {
         auto &layer = get_layer( p.z );
         const int index = flat_index( p );
-        layer.state[index] = ASL_NONE;
+        layer.state_at( index ) = ASL_NONE;
     }
 };
 
+// Tiles the graph treats as walkable when walls can't be bashed, opened or climbed
+// Vehicle tiles are always included, their obstacles depend on the parts involved
+static bool graph_passable( const pf_special special )
+{
+    return !( special & PF_WALL ) || ( special & PF_VEHICLE );
+}
+
+static int find_component_root( std::vector<int> &parents, int i )
+{
+    while( parents[i] != i ) {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
+
+pathfinding_graph::pathfinding_graph()
+{
+    dirty = true;
+}
+
+void pathfinding_graph::build( const pf_special ( &special )[MAPSIZE_X][MAPSIZE_Y] )
+{
+    std::fill_n( &region[0][0], MAPSIZE_X * MAPSIZE_Y, -1 );
+    component.clear();
+    std::vector<bool> region_has_trap;
+
+    // Flood fill every submap on its own, giving the regions of each submap
+    std::vector<point> todo;
+    for( int smx = 0; smx < MAPSIZE; smx++ ) {
+        for( int smy = 0; smy < MAPSIZE; smy++ ) {
+            const point sm_min( smx * SEEX, smy * SEEY );
+            const point sm_max = sm_min + point( SEEX, SEEY );
+            for( int x = sm_min.x; x < sm_max.x; x++ ) {
+                for( int y = sm_min.y; y < sm_max.y; y++ ) {
+                    if( region[x][y] != -1 || !graph_passable( special[x][y] ) ) {
+                        continue;
+                    }
+
+                    const int16_t id = static_cast<int16_t>( component.size() );
+                    component.push_back( id );
+                    region_has_trap.push_back( false );
+                    region[x][y] = id;
+                    todo.emplace_back( x, y );
+                    while( !todo.empty() ) {
+                        const point cur = todo.back();
+                        todo.pop_back();
+                        if( special[cur.x][cur.y] & PF_TRAP ) {
+                            region_has_trap[id] = true;
+                        }
+                        for( const point &offset : eight_adjacent_offsets ) {
+                            const point next = cur + offset;
+                            if( next.x < sm_min.x || next.x >= sm_max.x ||
+                                next.y < sm_min.y || next.y >= sm_max.y ) {
+                                continue;
+                            }
+                            if( region[next.x][next.y] == -1 && graph_passable( special[next.x][next.y] ) ) {
+                                region[next.x][next.y] = id;
+                                todo.push_back( next );
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Merge regions connected by portals: walkable tiles touching across a submap border
+    // Only the forward half of the neighborhood is needed, the other half is symmetric
+    static constexpr std::array<point, 4> forward_offsets = {{
+            point_east, point_south_east, point_south, point_south_west
+        }
+    };
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            const int cur_region = region[x][y];
+            if( cur_region == -1 ) {
+                continue;
+            }
+            for( const point &offset : forward_offsets ) {
+                const point next = point( x, y ) + offset;
+                if( next.x < 0 || next.x >= MAPSIZE_X || next.y < 0 || next.y >= MAPSIZE_Y ) {
+                    continue;
+                }
+                const int next_region = region[next.x][next.y];
+                if( next_region == -1 || next_region == cur_region ) {
+                    continue;
+                }
+                const int root_a = find_component_root( component, cur_region );
+                const int root_b = find_component_root( component, next_region );
+                if( root_a != root_b ) {
+                    component[std::max( root_a, root_b )] = std::min( root_a, root_b );
+                }
+            }
+        }
+    }
+
+    component_has_trap.assign( component.size(), false );
+    for( int i = 0; i < static_cast<int>( component.size() ); i++ ) {
+        component[i] = find_component_root( component, i );
+        if( region_has_trap[i] ) {
+            component_has_trap[component[i]] = true;
+        }
+    }
+
+    dirty = false;
+}
+
+bool pathfinding_graph::may_reach( point from, point to, const bool leave_by_ledge ) const
+{
+    const int to_region = region[to.x][to.y];
+    if( to_region == -1 ) {
+        return false;
+    }
+    const int to_component = component[to_region];
+
+    // The starting tile is left even if it is a wall, so check its neighbors too
+    for( int dx = -1; dx <= 1; dx++ ) {
+        for( int dy = -1; dy <= 1; dy++ ) {
+            const point p = from + point( dx, dy );
+            if( p.x < 0 || p.x >= MAPSIZE_X || p.y < 0 || p.y >= MAPSIZE_Y ) {
+                continue;
+            }
+            const int p_region = region[p.x][p.y];
+            if( p_region == -1 ) {
+                continue;
+            }
+            const int p_component = component[p_region];
+            if( p_component == to_component ||
+                ( leave_by_ledge && component_has_trap[p_component] ) ) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 // Modifies `t` to be a tile with `flag` in the overmap tile that `t` was originally on
 // return false if it could not find a suitable point
 template<ter_bitflags flag>
@@ -191,6 +371,143 @@ bool is_disjoint( const Set1 &set1, const Set2 &set2 )
     return true;
 }
 
+pf_step map::pathfinding_step( const tripoint &cur, const vehicle *cur_veh, const tripoint &p,
+                               const pf_special p_special, const pathfinding_settings &settings,
+                               int &step_cost ) const
+{
+    static const auto non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP | PF_SHARP;
+
+    const int bash = settings.bash_strength;
+    const int climb_cost = settings.climb_cost;
+    const bool doors = settings.allow_open_doors;
+    const bool trapavoid = settings.avoid_traps;
+
+    int part = -1;
+    const vehicle *veh = veh_at_internal( p, part );
+    if( cur_veh &&
+        !cur_veh->allowed_move( cur_veh->tripoint_to_mount( cur ), cur_veh->tripoint_to_mount( p ) ) ) {
+        //Trying to squeeze through a vehicle hole, skip this movement but don't close the tile as other paths may lead to it
+        return pf_step::skip;
+    }
+
+    if( veh && veh != cur_veh &&
+        !veh->allowed_move( veh->tripoint_to_mount( cur ), veh->tripoint_to_mount( p ) ) ) {
+        //Same as above but moving into rather than out of a vehicle
+        return pf_step::skip;
+    }
+
+    // TODO: De-uglify, de-huge-n
+    if( !( p_special & non_normal ) ) {
+        // Boring flat dirt - the most common case above the ground
+        step_cost = 2;
+        return pf_step::walk;
+    }
+
+    if( settings.avoid_rough_terrain ) {
+        // Close all rough terrain tiles
+        return pf_step::close;
+    }
+
+    const maptile &tile = maptile_at_internal( p );
+    const auto &terrain = tile.get_ter_t();
+    const auto &furniture = tile.get_furn_t();
+
+    const int cost = move_cost_internal( furniture, terrain, veh, part );
+    // Don't calculate bash rating unless we intend to actually use it
+    const int rating = ( bash == 0 || cost != 0 ) ? -1 :
+                       bash_rating_internal( bash, furniture, terrain, false, veh, part );
+
+    if( cost == 0 && rating <= 0 && ( !doors || !terrain.open || !furniture.open ) && veh == nullptr &&
+        climb_cost <= 0 ) {
+        // Close it so that next time we won't try to calculate costs
+        return pf_step::close;
+    }
+
+    step_cost = cost;
+    if( cost == 0 ) {
+        if( climb_cost > 0 && p_special & PF_CLIMBABLE ) {
+            // Climbing fences
+            step_cost += climb_cost;
+        } else if( doors && ( terrain.open || furniture.open ) &&
+                   ( !terrain.has_flag( "OPENCLOSE_INSIDE" ) || !furniture.has_flag( "OPENCLOSE_INSIDE" ) ||
+                     !is_outside( cur ) ) ) {
+            // Only try to open INSIDE doors from the inside
+            // To open and then move onto the tile
+            step_cost += 4;
+        } else if( veh != nullptr ) {
+            const auto vpobst = vpart_position( const_cast<vehicle &>( *veh ), part ).obstacle_at_part();
+            part = vpobst ? vpobst->part_index() : -1;
+            int dummy = -1;
+            if( doors && veh->part_flag( part, VPFLAG_OPENABLE ) &&
+                ( !veh->part_flag( part, "OPENCLOSE_INSIDE" ) ||
+                  veh_at_internal( cur, dummy ) == veh ) ) {
+                // Handle car doors, but don't try to path through curtains
+                step_cost += 10; // One turn to open, 4 to move there
+            } else if( part >= 0 && bash > 0 ) {
+                // Car obstacle that isn't a door
+                // TODO: Account for armor
+                int hp = veh->cpart( part ).hp();
+                if( hp / 20 > bash ) {
+                    // Threshold damage thing means we just can't bash this down
+                    return pf_step::close;
+                } else if( hp / 10 > bash ) {
+                    // Threshold damage thing means we will fail to deal damage pretty often
+                    hp *= 2;
+                }
+
+                step_cost += 2 * hp / bash + 8 + 4;
+            } else if( part >= 0 ) {
+                if( !doors || !veh->part_flag( part, VPFLAG_OPENABLE ) ) {
+                    // Won't be openable, don't try from other sides
+                    return pf_step::close;
+                }
+
+                return pf_step::skip;
+            }
+        } else if( rating > 1 ) {
+            // Expected number of turns to bash it down, 1 turn to move there
+            // and 5 turns of penalty not to trash everything just because we can
+            step_cost += ( 20 / rating ) + 2 + 10;
+        } else if( rating == 1 ) {
+            // Desperate measures, avoid whenever possible
+            step_cost += 500;
+        } else {
+            // Unbashable and unopenable from here
+            if( !doors || !terrain.open || !furniture.open ) {
+                // Or anywhere else for that matter
+                return pf_step::close;
+            }
+
+            return pf_step::skip;
+        }
+    }
+
+    if( trapavoid && p_special & PF_TRAP ) {
+        const auto &ter_trp = terrain.trap.obj();
+        const auto &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
+        if( !trp.is_benign() ) {
+            // For now make them detect all traps
+            if( has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR ) ) {
+                // Special case - ledge in z-levels
+                // Warning: really expensive, needs a cache
+                if( valid_move( p, tripoint( p.xy(), p.z - 1 ), false, true ) ) {
+                    return pf_step::ledge;
+                }
+            } else {
+                // Otherwise it's walkable
+                step_cost += 500;
+            }
+        }
+    }
+
+    if( settings.avoid_sharp && p_special & PF_SHARP ) {
+        // Avoid sharp things
+        return pf_step::close;
+    }
+
+    return pf_step::walk;
+}
+
 std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                                   const pathfinding_settings &settings,
                                   const std::set<tripoint> &pre_closed ) const
@@ -238,8 +555,14 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     int climb_cost = settings.climb_cost;
     bool doors = settings.allow_open_doors;
     bool trapavoid = settings.avoid_traps;
-    bool roughavoid = settings.avoid_rough_terrain;
-    bool sharpavoid = settings.avoid_sharp;
+
+    // When walls can't be bashed, opened or climbed, a target walled off from the
+    // start can't be reached, but the search below would only find that out after
+    // exhausting the whole search area. The submap graph answers it up front.
+    if( f.z == t.z && bash == 0 && !doors && climb_cost <= 0 &&
+        !get_pathfinding_graph_ref( f.z ).may_reach( f.xy(), t.xy(), trapavoid && has_zlevels() ) ) {
+        return ret;
+    }
 
     const int pad = 16;  // Should be much bigger - low value makes pathfinders dumb!
     int minx = std::min( f.x, t.x ) - pad;
@@ -253,7 +576,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     clip_to_bounds( minx, miny, minz );
     clip_to_bounds( maxx, maxy, maxz );
 
-    pathfinder pf( point( minx, miny ), point( maxx, maxy ) );
+    pathfinder &pf = pathfinder::get_thread_instance();
+    pf.reset();
     // Make NPCs not want to path through player
     // But don't make player pathing stop working
     for( const auto &p : pre_closed ) {
@@ -274,7 +598,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
         const int parent_index = flat_index( cur );
         auto &layer = pf.get_layer( cur.z );
-        auto &cur_state = layer.state[parent_index];
+        auto &cur_state = layer.state_at( parent_index );
         if( cur_state == ASL_CLOSED ) {
             continue;
         }
@@ -311,148 +635,39 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                 continue;
             }
 
-            if( layer.state[index] == ASL_CLOSED ) {
-                continue;
-            }
-
-            int part = -1;
-            const vehicle *veh = veh_at_internal( p, part );
-            if( cur_veh &&
-                !cur_veh->allowed_move( cur_veh->tripoint_to_mount( cur ), cur_veh->tripoint_to_mount( p ) ) ) {
-                //Trying to squeeze through a vehicle hole, skip this movement but don't close the tile as other paths may lead to it
-                continue;
-            }
-
-            if( veh && veh != cur_veh &&
-                !veh->allowed_move( veh->tripoint_to_mount( cur ), veh->tripoint_to_mount( p ) ) ) {
-                //Same as above but moving into rather than out of a vehicle
+            if( layer.state_at( index ) == ASL_CLOSED ) {
                 continue;
             }
 
             // Penalize for diagonals or the path will look "unnatural"
             int newg = layer.gscore[parent_index] + ( ( cur.x != p.x && cur.y != p.y ) ? 1 : 0 );
 
-            const auto p_special = pf_cache.special[p.x][p.y];
-            // TODO: De-uglify, de-huge-n
-            if( !( p_special & non_normal ) ) {
-                // Boring flat dirt - the most common case above the ground
-                newg += 2;
-            } else {
-                if( roughavoid ) {
-                    layer.state[index] = ASL_CLOSED; // Close all rough terrain tiles
+            int step_cost = 0;
+            switch( pathfinding_step( cur, cur_veh, p, pf_cache.special[p.x][p.y], settings, step_cost ) ) {
+                case pf_step::walk:
+                    break;
+                case pf_step::skip:
                     continue;
-                }
-
-                const maptile &tile = maptile_at_internal( p );
-                const auto &terrain = tile.get_ter_t();
-                const auto &furniture = tile.get_furn_t();
-
-                const int cost = move_cost_internal( furniture, terrain, veh, part );
-                // Don't calculate bash rating unless we intend to actually use it
-                const int rating = ( bash == 0 || cost != 0 ) ? -1 :
-                                   bash_rating_internal( bash, furniture, terrain, false, veh, part );
-
-                if( cost == 0 && rating <= 0 && ( !doors || !terrain.open || !furniture.open ) && veh == nullptr &&
-                    climb_cost <= 0 ) {
-                    layer.state[index] = ASL_CLOSED; // Close it so that next time we won't try to calculate costs
+                case pf_step::close:
+                    layer.state[index] = ASL_CLOSED;
                     continue;
-                }
-
-                newg += cost;
-                if( cost == 0 ) {
-                    if( climb_cost > 0 && p_special & PF_CLIMBABLE ) {
-                        // Climbing fences
-                        newg += climb_cost;
-                    } else if( doors && ( terrain.open || furniture.open ) &&
-                               ( !terrain.has_flag( "OPENCLOSE_INSIDE" ) || !furniture.has_flag( "OPENCLOSE_INSIDE" ) ||
-                                 !is_outside( cur ) ) ) {
-                        // Only try to open INSIDE doors from the inside
-                        // To open and then move onto the tile
-                        newg += 4;
-                    } else if( veh != nullptr ) {
-                        const auto vpobst = vpart_position( const_cast<vehicle &>( *veh ), part ).obstacle_at_part();
-                        part = vpobst ? vpobst->part_index() : -1;
-                        int dummy = -1;
-                        if( doors && veh->part_flag( part, VPFLAG_OPENABLE ) &&
-                            ( !veh->part_flag( part, "OPENCLOSE_INSIDE" ) ||
-                              veh_at_internal( cur, dummy ) == veh ) ) {
-                            // Handle car doors, but don't try to path through curtains
-                            newg += 10; // One turn to open, 4 to move there
-                        } else if( part >= 0 && bash > 0 ) {
-                            // Car obstacle that isn't a door
-                            // TODO: Account for armor
-                            int hp = veh->cpart( part ).hp();
-                            if( hp / 20 > bash ) {
-                                // Threshold damage thing means we just can't bash this down
-                                layer.state[index] = ASL_CLOSED;
-                                continue;
-                            } else if( hp / 10 > bash ) {
-                                // Threshold damage thing means we will fail to deal damage pretty often
-                                hp *= 2;
-                            }
-
-                            newg += 2 * hp / bash + 8 + 4;
-                        } else if( part >= 0 ) {
-                            if( !doors || !veh->part_flag( part, VPFLAG_OPENABLE ) ) {
-                                // Won't be openable, don't try from other sides
-                                layer.state[index] = ASL_CLOSED;
-                            }
-
-                            continue;
-                        }
-                    } else if( rating > 1 ) {
-                        // Expected number of turns to bash it down, 1 turn to move there
-                        // and 5 turns of penalty not to trash everything just because we can
-                        newg += ( 20 / rating ) + 2 + 10;
-                    } else if( rating == 1 ) {
-                        // Desperate measures, avoid whenever possible
-                        newg += 500;
-                    } else {
-                        // Unbashable and unopenable from here
-                        if( !doors || !terrain.open || !furniture.open ) {
-                            // Or anywhere else for that matter
-                            layer.state[index] = ASL_CLOSED;
-                        }
-
-                        continue;
-                    }
-                }
-
-                if( trapavoid && p_special & PF_TRAP ) {
-                    const auto &ter_trp = terrain.trap.obj();
-                    const auto &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
-                    if( !trp.is_benign() ) {
-                        // For now make them detect all traps
-                        if( has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR ) ) {
-                            // Special case - ledge in z-levels
-                            // Warning: really expensive, needs a cache
-                            if( valid_move( p, tripoint( p.xy(), p.z - 1 ), false, true ) ) {
-                                tripoint below( p.xy(), p.z - 1 );
-                                if( !has_flag( TFLAG_NO_FLOOR, below ) ) {
-                                    // Otherwise this would have been a huge fall
-                                    auto &layer = pf.get_layer( p.z - 1 );
-                                    // From cur, not p, because we won't be walking on air
-                                    pf.add_point( layer.gscore[parent_index] + 10,
-                                                  layer.score[parent_index] + 10 + 2 * rl_dist( below, t ),
-                                                  cur, below );
-                                }
-
-                                // Close p, because we won't be walking on it
-                                layer.state[index] = ASL_CLOSED;
-                                continue;
-                            }
-                        } else if( trapavoid ) {
-                            // Otherwise it's walkable
-                            newg += 500;
-                        }
+                case pf_step::ledge: {
+                    tripoint below( p.xy(), p.z - 1 );
+                    if( !has_flag( TFLAG_NO_FLOOR, below ) ) {
+                        // Otherwise this would have been a huge fall
+                        auto &layer = pf.get_layer( p.z - 1 );
+                        // From cur, not p, because we won't be walking on air
+                        pf.add_point( layer.gscore_at( parent_index ) + 10,
+                                      layer.score_at( parent_index ) + 10 + 2 * rl_dist( below, t ),
+                                      cur, below );
                     }
-                }
 
-                if( sharpavoid && p_special & PF_SHARP ) {
-                    layer.state[index] = ASL_CLOSED; // Avoid sharp things
+                    // Close p, because we won't be walking on it
+                    layer.state[index] = ASL_CLOSED;
+                    continue;
                 }
-
             }
+            newg += step_cost;
 
             // If not visited, add as open
             // If visited, add it only if we can do so with better score
@@ -472,8 +687,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             tripoint dest( cur.xy(), cur.z - 1 );
             if( vertical_move_destination<TFLAG_GOES_UP>( *this, dest ) ) {
                 auto &layer = pf.get_layer( dest.z );
-                pf.add_point( layer.gscore[parent_index] + 2,
-                              layer.score[parent_index] + 2 * rl_dist( dest, t ),
+                pf.add_point( layer.gscore_at( parent_index ) + 2,
+                              layer.score_at( parent_index ) + 2 * rl_dist( dest, t ),
                               cur, dest );
             }
         }
@@ -481,8 +696,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             tripoint dest( cur.xy(), cur.z + 1 );
             if( vertical_move_destination<TFLAG_GOES_DOWN>( *this, dest ) ) {
                 auto &layer = pf.get_layer( dest.z );
-                pf.add_point( layer.gscore[parent_index] + 2,
-                              layer.score[parent_index] + 2 * rl_dist( dest, t ),
+                pf.add_point( layer.gscore_at( parent_index ) + 2,
+                              layer.score_at( parent_index ) + 2 * rl_dist( dest, t ),
                               cur, dest );
             }
         }
@@ -491,8 +706,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             auto &layer = pf.get_layer( cur.z + 1 );
             for( size_t it = 0; it < 8; it++ ) {
                 const tripoint above( cur.x + x_offset[it], cur.y + y_offset[it], cur.z + 1 );
-                pf.add_point( layer.gscore[parent_index] + 4,
-                              layer.score[parent_index] + 4 + 2 * rl_dist( above, t ),
+                pf.add_point( layer.gscore_at( parent_index ) + 4,
+                              layer.score_at( parent_index ) + 4 + 2 * rl_dist( above, t ),
                               cur, above );
             }
         }
@@ -501,8 +716,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             auto &layer = pf.get_layer( cur.z + 1 );
             for( size_t it = 0; it < 8; it++ ) {
                 const tripoint above( cur.x + x_offset[it], cur.y + y_offset[it], cur.z + 1 );
-                pf.add_point( layer.gscore[parent_index] + 4,
-                              layer.score[parent_index] + 4 + 2 * rl_dist( above, t ),
+                pf.add_point( layer.gscore_at( parent_index ) + 4,
+                              layer.score_at( parent_index ) + 4 + 2 * rl_dist( above, t ),
                               cur, above );
             }
         }
@@ -511,8 +726,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             auto &layer = pf.get_layer( cur.z - 1 );
             for( size_t it = 0; it < 8; it++ ) {
                 const tripoint below( cur.x + x_offset[it], cur.y + y_offset[it], cur.z - 1 );
-                pf.add_point( layer.gscore[parent_index] + 4,
-                              layer.score[parent_index] + 4 + 2 * rl_dist( below, t ),
+                pf.add_point( layer.gscore_at( parent_index ) + 4,
+                              layer.score_at( parent_index ) + 4 + 2 * rl_dist( below, t ),
                               cur, below );
             }
         }
@@ -548,3 +763,156 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
     return ret;
 }
+
+std::vector<tripoint> pathfinding_flow_field::route_from( const tripoint &from ) const
+{
+    std::vector<tripoint> ret;
+    if( !covers( from ) || cost[index( from )] < 0 ) {
+        return ret;
+    }
+
+    // Every step leads to a tile that was finished earlier by the search, so this ends at target
+    tripoint cur = from;
+    while( cur != target ) {
+        cur += eight_adjacent_offsets[next[index( cur )]];
+        ret.push_back( cur );
+    }
+
+    return ret;
+}
+
+void pathfinding_flow_field_cache::invalidate( const int zlev )
+{
+    for( entry &e : entries ) {
+        if( e.target.z == zlev ) {
+            e.field.reset();
+        }
+    }
+}
+
+void map::build_flow_field( pathfinding_flow_field &field ) const
+{
+    const tripoint &t = field.target;
+    const pathfinding_settings &settings = field.settings;
+    // Same padding as the search area of map::route
+    const int radius = settings.max_dist + 16;
+    field.min = point( std::max( t.x - radius, 0 ), std::max( t.y - radius, 0 ) );
+    field.max = point( std::min( t.x + radius, MAPSIZE_X - 1 ), std::min( t.y + radius, MAPSIZE_Y - 1 ) );
+    const size_t area = static_cast<size_t>( field.max.x - field.min.x + 1 ) *
+                        ( field.max.y - field.min.y + 1 );
+    field.cost.assign( area, -1 );
+    field.next.assign( area, -1 );
+
+    std::vector<bool> closed( area, false );
+    std::vector< std::pair<int, tripoint> > open;
+    field.cost[field.index( t )] = 0;
+    open.emplace_back( 0, t );
+
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( t.z );
+    while( !open.empty() ) {
+        std::pop_heap( open.begin(), open.end(), pair_greater_cmp_first() );
+        const tripoint p = open.back().second;
+        open.pop_back();
+
+        const int p_index = field.index( p );
+        if( closed[p_index] ) {
+            continue;
+        }
+        closed[p_index] = true;
+
+        const pf_special p_special = pf_cache.special[p.x][p.y];
+        // Search backwards: find the tiles that could step onto p
+        for( size_t i = 0; i < eight_adjacent_offsets.size(); i++ ) {
+            const tripoint q = p - eight_adjacent_offsets[i];
+            if( !field.covers( q ) ) {
+                continue;
+            }
+            const int q_index = field.index( q );
+            if( closed[q_index] ) {
+                continue;
+            }
+
+            int q_part = -1;
+            const vehicle *q_veh = veh_at_internal( q, q_part );
+            int step_cost = 0;
+            // Ledges are left to map::route, the field stays on one z-level
+            if( pathfinding_step( q, q_veh, p, p_special, settings, step_cost ) != pf_step::walk ) {
+                continue;
+            }
+
+            // Penalize for diagonals, same as map::route
+            const int newg = field.cost[p_index] + ( ( q.x != p.x && q.y != p.y ) ? 1 : 0 ) + step_cost;
+            if( newg > settings.max_length ) {
+                continue;
+            }
+            if( field.cost[q_index] < 0 || newg < field.cost[q_index] ) {
+                field.cost[q_index] = newg;
+                field.next[q_index] = static_cast<int8_t>( i );
+                open.emplace_back( newg, q );
+                std::push_heap( open.begin(), open.end(), pair_greater_cmp_first() );
+            }
+        }
+    }
+}
+
+std::vector<tripoint> map::route_shared( const tripoint &f, const tripoint &t,
+        const pathfinding_settings &settings,
+        const std::set<tripoint> &pre_closed ) const
+{
+    pathfinding_flow_field_cache &cache = *flow_field_cache;
+    // Fields only cover one z-level and can't account for tiles closed by one caller
+    if( !pre_closed.empty() || f.z != t.z || f == t || !inbounds( f ) || !inbounds( t ) ||
+        rl_dist( f, t ) > settings.max_dist ) {
+        cache.stats.route_calls++;
+        return route( f, t, settings, pre_closed );
+    }
+
+    if( cache.turn != calendar::turn ) {
+        cache.entries.clear();
+        cache.turn = calendar::turn;
+    }
+
+    auto iter = std::find_if( cache.entries.begin(), cache.entries.end(),
+    [&]( const pathfinding_flow_field_cache::entry & e ) {
+        return e.target == t && e.settings == settings;
+    } );
+    if( iter == cache.entries.end() ) {
+        // Plenty for the number of distinct targets in a single turn
+        static constexpr size_t max_entries = 64;
+        if( cache.entries.size() >= max_entries ) {
+            cache.stats.route_calls++;
+            return route( f, t, settings, pre_closed );
+        }
+        cache.entries.emplace_back();
+        iter = std::prev( cache.entries.end() );
+        iter->target = t;
+        iter->settings = settings;
+    }
+
+    pathfinding_flow_field_cache::entry &e = *iter;
+    e.requests++;
+    if( e.field == nullptr ) {
+        if( e.requests < 2 ) {
+            cache.stats.route_calls++;
+            return route( f, t, settings, pre_closed );
+        }
+        e.field = std::make_unique<pathfinding_flow_field>();
+        e.field->target = t;
+        e.field->settings = settings;
+        build_flow_field( *e.field );
+        cache.stats.fields_built++;
+    }
+
+    cache.stats.field_hits++;
+    return e.field->route_from( f );
+}
+
+const pathfinding_flow_field_stats &map::get_flow_field_stats() const
+{
+    return flow_field_cache->stats;
+}
+
+void map::reset_flow_field_stats()
+{
+    flow_field_cache->stats = pathfinding_flow_field_stats();
+}
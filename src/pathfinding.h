@@ -2,7 +2,13 @@
 #ifndef CATA_SRC_PATHFINDING_H
 #define CATA_SRC_PATHFINDING_H
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "calendar.h"
 #include "game_constants.h"
+#include "point.h"
 
 enum pf_special : int {
     PF_NORMAL = 0x00,    // Plain boring tile (grass, dirt, floor etc.)
@@ -38,6 +44,46 @@ inline pf_special &operator &= ( pf_special &lhs, pf_special rhs )
     return lhs;
 }
 
+/** Outcome of trying to step onto a tile while pathfinding */
+enum class pf_step : int {
+    walk,  // Can step there, at the calculated cost
+    skip,  // Can't step there from here, but maybe from another tile
+    close, // Can't step there from anywhere
+    ledge, // Stepping there means dropping down to the z-level below
+};
+
+/**
+ * Submap-level abstraction of a single z-level of @ref pathfinding_cache.
+ *
+ * Each submap is split into regions of tiles that are connected (including
+ * diagonally) without passing through walls.  Regions that touch across a
+ * submap border form a portal and are merged into one component, so two
+ * tiles in different components can't reach each other without bashing,
+ * opening or climbing something.
+ */
+struct pathfinding_graph {
+    pathfinding_graph();
+
+    bool dirty;
+
+    // Region of each tile, or -1 for tiles that block movement
+    int16_t region[MAPSIZE_X][MAPSIZE_Y];
+    // Component of each region, indexed by region
+    std::vector<int> component;
+    // Whether a component contains a dangerous trap (possibly a ledge)
+    std::vector<bool> component_has_trap;
+
+    void build( const pf_special ( &special )[MAPSIZE_X][MAPSIZE_Y] );
+
+    /**
+     * Returns false only if no walk from @p from can possibly end on @p to
+     * while staying on this z-level and treating walls as impassable.
+     * @param leave_by_ledge Whether the walk may drop down a ledge, which
+     * makes any component containing a trap a possible exit.
+     */
+    bool may_reach( point from, point to, bool leave_by_ledge ) const;
+};
+
 struct pathfinding_cache {
     pathfinding_cache();
     ~pathfinding_cache();
@@ -45,6 +91,8 @@ struct pathfinding_cache {
     bool dirty;
 
     pf_special special[MAPSIZE_X][MAPSIZE_Y];
+
+    pathfinding_graph graph;
 };
 
 struct pathfinding_settings {
@@ -71,6 +119,72 @@ struct pathfinding_settings {
           allow_open_doors( aod ), avoid_traps( at ), allow_climb_stairs( acs ), avoid_rough_terrain( art ),
           avoid_sharp( as ) {}
     pathfinding_settings &operator = ( const pathfinding_settings & ) = default;
+
+    bool operator==( const pathfinding_settings &rhs ) const {
+        return bash_strength == rhs.bash_strength && max_dist == rhs.max_dist &&
+               max_length == rhs.max_length && climb_cost == rhs.climb_cost &&
+               allow_open_doors == rhs.allow_open_doors && avoid_traps == rhs.avoid_traps &&
+               allow_climb_stairs == rhs.allow_climb_stairs &&
+               avoid_rough_terrain == rhs.avoid_rough_terrain && avoid_sharp == rhs.avoid_sharp;
+    }
+};
+
+/**
+ * Cost of the cheapest walk to a single target from every tile around it, for
+ * one set of pathfinding settings.  Built with one backwards search from the
+ * target, after which the next step towards the target can be read directly.
+ * Only covers the target's z-level.
+ */
+struct pathfinding_flow_field {
+    tripoint target;
+    pathfinding_settings settings;
+
+    // Covered area, inclusive
+    point min;
+    point max;
+    // Cost of the cheapest walk from each covered tile to the target, or -1 if there is none
+    std::vector<int> cost;
+    // First step of that walk, as an index into eight_adjacent_offsets
+    std::vector<int8_t> next;
+
+    bool covers( const tripoint &p ) const {
+        return p.z == target.z && p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y;
+    }
+
+    int index( const tripoint &p ) const {
+        return ( p.x - min.x ) * ( max.y - min.y + 1 ) + ( p.y - min.y );
+    }
+
+    /** Walk from @p from to the target, not including @p from. Empty if there is none. */
+    std::vector<tripoint> route_from( const tripoint &from ) const;
+};
+
+/** How routes requested through map::route_shared were answered */
+struct pathfinding_flow_field_stats {
+    int field_hits = 0;
+    int fields_built = 0;
+    int route_calls = 0;
+};
+
+/**
+ * Flow fields of the current turn.  A field is built only once the same target
+ * was requested more than once with the same settings, so that lone requests
+ * still get the cheaper targeted search.
+ */
+struct pathfinding_flow_field_cache {
+    struct entry {
+        tripoint target;
+        pathfinding_settings settings;
+        int requests = 0;
+        std::unique_ptr<pathfinding_flow_field> field;
+    };
+
+    time_point turn = calendar::before_time_starts;
+    std::vector<entry> entries;
+    pathfinding_flow_field_stats stats;
+
+    /** Forgets all fields on z-level @p zlev, but not how popular their targets are */
+    void invalidate( int zlev );
 };
 
 #endif // CATA_SRC_PATHFINDING_H
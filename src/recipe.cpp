@@ -638,8 +638,14 @@ bool recipe::will_be_blacklisted() const
 
 std::function<bool( const item & )> recipe::get_component_filter(
     const recipe_filter_flags flags ) const
+{
+    return component_filter( get_component_rules( flags ) );
+}
+
+component_rules recipe::get_component_rules( const recipe_filter_flags flags ) const
 {
     const item result = create_result();
+    component_rules rules = component_rules::none;
 
     // Disallow crafting of non-perishables with rotten components
     // Make an exception for items with the ALLOW_ROTTEN flag such as seeds
@@ -647,36 +653,35 @@ std::function<bool( const item & )> recipe::get_component_filter(
         result.is_food() && !result.goes_bad() && !has_flag( "ALLOW_ROTTEN" );
     const bool flags_forbid_rotten =
         static_cast<bool>( flags & recipe_filter_flags::no_rotten ) && result.goes_bad_after_opening();
-    std::function<bool( const item & )> rotten_filter = return_true<item>;
     if( recipe_forbids_rotten || flags_forbid_rotten ) {
-        rotten_filter = []( const item & component ) {
-            return !component.rotten();
-        };
+        rules = rules | component_rules::no_rotten;
     }
 
     // Disallow usage of non-full magazines as components
     // This is primarily used to require a fully charged battery, but works for any magazine.
-    std::function<bool( const item & )> magazine_filter = return_true<item>;
     if( has_flag( "FULL_MAGAZINE" ) ) {
-        magazine_filter = []( const item & component ) {
-            return !component.is_magazine() || ( component.ammo_remaining() >= component.ammo_capacity() );
-        };
+        rules = rules | component_rules::full_magazines;
     }
 
     // Filter out filthy components here instead of with is_crafting_component
     // Make an exception for recipes with the ALLOW_FILTHY flag
-    std::function<bool( const item & )> filthy_filter = return_true<item>;
     if( !has_flag( flag_ALLOW_FILTHY ) ) {
-        filthy_filter = []( const item & component ) {
-            return !component.is_filthy();
-        };
+        rules = rules | component_rules::no_filthy;
     }
+    return rules;
+}
 
-    return [ rotten_filter, magazine_filter, filthy_filter ]( const item & component ) {
+std::function<bool( const item & )> recipe::component_filter( const component_rules rules )
+{
+    const bool no_rotten = static_cast<bool>( rules & component_rules::no_rotten );
+    const bool full_magazines = static_cast<bool>( rules & component_rules::full_magazines );
+    const bool no_filthy = static_cast<bool>( rules & component_rules::no_filthy );
+    return [no_rotten, full_magazines, no_filthy]( const item & component ) {
         return is_crafting_component_allow_filthy( component ) &&
-               rotten_filter( component ) &&
-               magazine_filter( component ) &&
-               filthy_filter( component );
+               ( !no_rotten || !component.rotten() ) &&
+               ( !full_magazines || !component.is_magazine() ||
+                 component.ammo_remaining() >= component.ammo_capacity() ) &&
+               ( !no_filthy || !component.is_filthy() );
     };
 }
 
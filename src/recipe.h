@@ -31,6 +31,26 @@ inline constexpr recipe_filter_flags operator&( recipe_filter_flags l, recipe_fi
                static_cast<unsigned>( l ) & static_cast<unsigned>( r ) );
 }
 
+/** Kinds of items the component filter of a recipe turns down. */
+enum class component_rules : int {
+    none = 0,
+    no_rotten = 1,
+    full_magazines = 2,
+    no_filthy = 4,
+};
+
+inline constexpr component_rules operator|( component_rules l, component_rules r )
+{
+    return static_cast<component_rules>(
+               static_cast<unsigned>( l ) | static_cast<unsigned>( r ) );
+}
+
+inline constexpr component_rules operator&( component_rules l, component_rules r )
+{
+    return static_cast<component_rules>(
+               static_cast<unsigned>( l ) & static_cast<unsigned>( r ) );
+}
+
 class recipe
 {
         friend class recipe_dictionary;
@@ -88,6 +108,10 @@ class recipe
 
         std::function<bool( const item & )> get_component_filter(
             recipe_filter_flags = recipe_filter_flags::none ) const;
+        /** The rules get_component_filter() is made from. */
+        component_rules get_component_rules( recipe_filter_flags = recipe_filter_flags::none ) const;
+        /** Filter accepting the components allowed by the given rules. */
+        static std::function<bool( const item & )> component_filter( component_rules rules );
 
         /** Prevent this recipe from ever being added to the player's learned recipies ( used for special NPC crafting ) */
         bool never_learn = false;
@@ -0,0 +1,204 @@
+#include "recipe_availability.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "avatar.h"
+#include "cata_utility.h"
+#include "inventory.h"
+#include "item.h"
+#include "itype.h"
+
+static const itype_id itype_UPS( "UPS" );
+
+static const trait_id trait_DEBUG_HS( "DEBUG_HS" );
+
+template<typename T, typename ID>
+static const T *find_first_of_type( const std::vector<std::vector<T>> &alternatives,
+                                    const ID &type )
+{
+    for( const std::vector<T> &alts : alternatives ) {
+        for( const T &alt : alts ) {
+            if( alt.type == type ) {
+                return &alt;
+            }
+        }
+    }
+    return nullptr;
+}
+
+recipe_availability_checker::recipe_availability_checker( const inventory &crafting_inv )
+    : crafting_inv( crafting_inv )
+{
+    debug_hs = get_avatar().has_trait( trait_DEBUG_HS );
+    for( int i = 0; i < any_item; i++ ) {
+        filters[i] = recipe::component_filter( static_cast<component_rules>( i ) );
+    }
+    filters[any_item] = return_true<item>;
+}
+
+int recipe_availability_checker::amount_of( const itype_id &type, int filter_index, bool pseudo )
+{
+    const auto key = std::make_tuple( type, filter_index, pseudo ? 1 : 0 );
+    const auto iter = counts.find( key );
+    if( iter != counts.end() ) {
+        return iter->second;
+    }
+    const int amount = crafting_inv.amount_of( type, pseudo, INT_MAX, filters[filter_index] );
+    counts.emplace( key, amount );
+    return amount;
+}
+
+int recipe_availability_checker::charges_of( const itype_id &type, int filter_index )
+{
+    const auto key = std::make_tuple( type, filter_index, -1 );
+    const auto iter = counts.find( key );
+    if( iter != counts.end() ) {
+        return iter->second;
+    }
+    const int charges = crafting_inv.charges_of( type, INT_MAX, filters[filter_index] );
+    counts.emplace( key, charges );
+    return charges;
+}
+
+bool recipe_availability_checker::has_quality( const quality_requirement &qual ) const
+{
+    return crafting_inv.has_quality( qual.type, qual.level, qual.count );
+}
+
+bool recipe_availability_checker::has_tool( const tool_comp &tool, int batch,
+        cost_adjustment flags, const std::function<void( int )> &visitor )
+{
+    if( tool.by_charges() ) {
+        // Charges depend on the batch and may draw on a UPS, so they are not shared
+        return tool.has( crafting_inv, return_true<item>, batch, flags, visitor );
+    }
+    const int count = std::abs( tool.count );
+    return amount_of( tool.type, any_item, true ) >= count;
+}
+
+bool recipe_availability_checker::has_component( const item_comp &comp, int filter_index,
+        int batch )
+{
+    const int count = std::abs( comp.count ) * batch;
+    if( item::count_by_charges( comp.type ) ) {
+        return charges_of( comp.type, filter_index ) >= count;
+    }
+    return amount_of( comp.type, filter_index, false ) >= count;
+}
+
+bool recipe_availability_checker::has_enough_material( const requirement_data &req,
+        const item_comp &comp, int filter_index, int batch, cost_adjustment flags )
+{
+    if( !has_component( comp, filter_index, batch ) ) {
+        return false;
+    }
+    // Same as requirement_data::check_enough_materials: an item type needed both as
+    // a tool and as a component has to be there often enough for both uses
+    const tool_comp *tool = find_first_of_type( req.get_tools(), comp.type );
+    if( tool != nullptr && has_tool( *tool, batch, flags, {} ) ) {
+        const int count = std::abs( comp.count ) * batch +
+                          ( tool->by_charges() ? 1 : std::abs( tool->count ) );
+        if( !has_component( item_comp( comp.type, count ), filter_index, 1 ) &&
+            amount_of( comp.type, filter_index, true ) < count ) {
+            return false;
+        }
+    }
+    // The same goes for a component that also provides a required quality
+    for( const std::pair<const quality_id, int> &provided : comp.type->qualities ) {
+        const quality_requirement *qual = find_first_of_type( req.get_qualities(), provided.first );
+        if( qual != nullptr && qual->level <= provided.second &&
+            !crafting_inv.has_quality( qual->type, qual->level, qual->count + std::abs( comp.count ) ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool recipe_availability_checker::can_make( const requirement_data &req, component_rules rules,
+        int batch, cost_adjustment flags )
+{
+    if( debug_hs ) {
+        return true;
+    }
+    for( const std::vector<quality_requirement> &quals : req.get_qualities() ) {
+        if( std::none_of( quals.begin(), quals.end(), [this]( const quality_requirement & qual ) {
+        return has_quality( qual );
+        } ) ) {
+            return false;
+        }
+    }
+
+    int total_UPS_charges_used = 0;
+    for( const std::vector<tool_comp> &tools : req.get_tools() ) {
+        bool has_tool_in_set = false;
+        int UPS_charges_used = std::numeric_limits<int>::max();
+        const auto visitor = [&UPS_charges_used]( int charges ) {
+            UPS_charges_used = std::min( UPS_charges_used, charges );
+        };
+        for( const tool_comp &tool : tools ) {
+            if( has_tool( tool, batch, flags, visitor ) ) {
+                has_tool_in_set = true;
+            }
+        }
+        if( !has_tool_in_set ) {
+            return false;
+        }
+        if( UPS_charges_used != std::numeric_limits<int>::max() ) {
+            total_UPS_charges_used += UPS_charges_used;
+        }
+    }
+    if( total_UPS_charges_used > 0 &&
+        total_UPS_charges_used > crafting_inv.charges_of( itype_UPS ) ) {
+        return false;
+    }
+
+    const int filter_index = static_cast<int>( rules );
+    for( const std::vector<item_comp> &comps : req.get_components() ) {
+        if( std::none_of( comps.begin(), comps.end(), [&]( const item_comp & comp ) {
+        return has_enough_material( req, comp, filter_index, batch, flags );
+        } ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool recipe_availability_checker::can_make( const deduped_requirement_data &req,
+        component_rules rules, int batch, cost_adjustment flags )
+{
+    return std::any_of( req.alternatives().begin(), req.alternatives().end(),
+    [&]( const requirement_data & alt ) {
+        return can_make( alt, rules, batch, flags );
+    } );
+}
+
+recipe_availability recipe_availability_checker::check( const recipe &r, int batch )
+{
+    const component_rules all_items = r.get_component_rules( recipe_filter_flags::none );
+    const component_rules no_rotten = r.get_component_rules( recipe_filter_flags::no_rotten );
+    recipe_availability result;
+    result.could_craft_if_knew = can_make( r.deduped_requirements(), all_items, batch,
+                                           cost_adjustment::start_only );
+    result.can_craft_non_rotten = no_rotten == all_items ? result.could_craft_if_knew :
+                                  can_make( r.deduped_requirements(), no_rotten, batch,
+                                            cost_adjustment::start_only );
+    result.apparently_craftable = can_make( r.simple_requirements(), all_items, batch,
+                                            cost_adjustment::start_only );
+    return result;
+}
+
+std::vector<recipe_availability> recipe_availability_checker::check(
+    const std::vector<const recipe *> &recipes, int batch )
+{
+    std::vector<recipe_availability> result;
+    result.reserve( recipes.size() );
+    for( const recipe *r : recipes ) {
+        result.push_back( check( *r, batch ) );
+    }
+    return result;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#ifndef CATA_SRC_RECIPE_AVAILABILITY_H
+#define CATA_SRC_RECIPE_AVAILABILITY_H
+
+#include <array>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "recipe.h"
+#include "requirements.h"
+#include "type_id.h"
+
+class inventory;
+class item;
+
+struct recipe_availability {
+    // Whether the requirements are met, ignoring whether the recipe is known
+    bool could_craft_if_knew = false;
+    // Same, but without rotten components
+    bool can_craft_non_rotten = false;
+    // Whether the requirements as listed in the recipe (not deduped) are met
+    bool apparently_craftable = false;
+};
+
+/**
+ * Checks the requirements of many recipes against one crafting inventory.
+ *
+ * Every recipe needing an item type shares one lookup of it per component filter,
+ * so checking a whole list of recipes costs little more than checking the item types
+ * they use. Gives the same answers as requirement_data::can_make_with_inventory,
+ * but does not mark the components of the requirements as available or not.
+ *
+ * The inventory must not change while the checker is in use.
+ */
+class recipe_availability_checker
+{
+    public:
+        explicit recipe_availability_checker( const inventory &crafting_inv );
+
+        /** Availability of the recipe for starting a craft of the given batch size. */
+        recipe_availability check( const recipe &r, int batch = 1 );
+        std::vector<recipe_availability> check( const std::vector<const recipe *> &recipes,
+                                                int batch = 1 );
+
+        bool can_make( const requirement_data &req, component_rules rules, int batch = 1,
+                       cost_adjustment flags = cost_adjustment::none );
+        bool can_make( const deduped_requirement_data &req, component_rules rules, int batch = 1,
+                       cost_adjustment flags = cost_adjustment::none );
+
+    private:
+        // Index of the filter accepting any item, after those made from component rules
+        static constexpr int any_item = 8;
+
+        int amount_of( const itype_id &type, int filter_index, bool pseudo );
+        int charges_of( const itype_id &type, int filter_index );
+
+        bool has_quality( const quality_requirement &qual ) const;
+        bool has_tool( const tool_comp &tool, int batch, cost_adjustment flags,
+                       const std::function<void( int )> &visitor );
+        bool has_component( const item_comp &comp, int filter_index, int batch );
+        bool has_enough_material( const requirement_data &req, const item_comp &comp,
+                                  int filter_index, int batch, cost_adjustment flags );
+
+        const inventory &crafting_inv;
+        bool debug_hs = false;
+        std::array<std::function<bool( const item & )>, any_item + 1> filters;
+        // Keyed by item type, filter index and whether pseudo items count (-1 for charges)
+        std::map<std::tuple<itype_id, int, int>, int> counts;
+};
+
+#endif // CATA_SRC_RECIPE_AVAILABILITY_H
@@ -438,6 +438,7 @@ void overmap::unserialize( std::istream &fin, const std::string &file_path )
         const std::string name = jsin.get_member_name();
         if( name == "layers" ) {
             std::unordered_map<tripoint_om_omt, std::string> needs_conversion;
+            terrain_index_built = false;
             jsin.start_array();
             for( int z = 0; z < OVERMAP_LAYERS; ++z ) {
                 jsin.start_array();
@@ -1315,7 +1316,7 @@ void faction_manager::deserialize( JsonIn &jsin )
 void Creature_tracker::deserialize( JsonIn &jsin )
 {
     monsters_list.clear();
-    monsters_by_location.clear();
+    clear_locations();
     jsin.start_array();
     while( !jsin.end_array() ) {
         // TODO: would be nice if monster had a constructor using JsonIn or similar, so this could be one statement.
@@ -82,6 +82,7 @@
 #include "morale.h"
 #include "morale_types.h"
 #include "mtype.h"
+#include "mutation.h"
 #include "npc.h"
 #include "npc_class.h"
 #include "options.h"
@@ -525,6 +526,7 @@ void Character::load( const JsonObject &data )
         if( mid.is_valid() ) {
             on_mutation_gain( mid );
             cached_mutations.push_back( &mid.obj() );
+            cached_mutation_flags |= mid->flag_bits;
             ++it;
         } else {
             debugmsg( "character %s has invalid mutation %s, it will be ignored", name, mid.c_str() );
@@ -1771,7 +1773,7 @@ void inventory::json_save_items( JsonOut &json ) const
 {
     json.start_array();
     for( const auto &elem : items ) {
-        for( const auto &elem_stack_iter : elem ) {
+        for( const auto &elem_stack_iter : *elem ) {
             elem_stack_iter.serialize( json );
         }
     }
@@ -3103,6 +3105,7 @@ void Creature::load( const JsonObject &jsin )
                 effect &e = i.second;
 
                 ( *effects )[id][bp] = e;
+                effect_filter |= effect_filter_bit( id );
                 on_effect_int_change( id, e.get_intensity(), bp );
             }
         }
@@ -3743,9 +3746,12 @@ void stats_tracker::deserialize( JsonIn &jsin )
 
 void submap::store( JsonOut &jsout ) const
 {
-    jsout.member( "turn_last_touched", last_touched );
-    jsout.member( "temperature", temperature );
+    store_layers( jsout );
+    store_contents( jsout );
+}
 
+void submap::store_layers( JsonOut &jsout ) const
+{
     // Terrain is saved using a simple RLE scheme.  Legacy saves don't have
     // this feature but the algorithm is backward compatible.
     jsout.member( "terrain" );
@@ -3831,20 +3837,6 @@ void submap::store( JsonOut &jsout ) const
     }
     jsout.end_array();
 
-    jsout.member( "items" );
-    jsout.start_array();
-    for( int j = 0; j < SEEY; j++ ) {
-        for( int i = 0; i < SEEX; i++ ) {
-            if( itm[i][j].empty() ) {
-                continue;
-            }
-            jsout.write( i );
-            jsout.write( j );
-            jsout.write( itm[i][j] );
-        }
-    }
-    jsout.end_array();
-
     jsout.member( "traps" );
     jsout.start_array();
     for( int j = 0; j < SEEY; j++ ) {
@@ -3862,6 +3854,26 @@ void submap::store( JsonOut &jsout ) const
         }
     }
     jsout.end_array();
+}
+
+void submap::store_contents( JsonOut &jsout ) const
+{
+    jsout.member( "turn_last_touched", last_touched );
+    jsout.member( "temperature", temperature );
+
+    jsout.member( "items" );
+    jsout.start_array();
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            if( itm[i][j].empty() ) {
+                continue;
+            }
+            jsout.write( i );
+            jsout.write( j );
+            jsout.write( itm[i][j] );
+        }
+    }
+    jsout.end_array();
 
     jsout.member( "fields" );
     jsout.start_array();
@@ -4095,6 +4107,7 @@ void submap::load( JsonIn &jsin, const std::string &member_name, int version )
                     field_count++;
                 }
                 fld[i][j].add_field( ft, intensity, time_duration::from_turns( age ) );
+                field_tiles.insert( point( i, j ) );
             }
         }
     } else if( member_name == "graffiti" ) {
@@ -17,6 +17,8 @@
 #include "string_id.h"
 
 static constexpr int SCENT_RADIUS = 40;
+// Width of the square of cells updated around the player
+static constexpr int SCENT_SPAN = SCENT_RADIUS * 2 + 1;
 
 static nc_color sev( const size_t level )
 {
@@ -162,9 +164,15 @@ void scent_map::update( const tripoint &center, map &m )
     //block=0 reduce=1 normal=5
     scent_array<char> scent_transfer;
 
-    std::array < std::array < int, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > new_scent;
-    std::array < std::array < int, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > sum_3_scent_y;
-    std::array < std::array < char, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > squares_used_y;
+    // The diffusion is a 3x3 box blur weighted by scent_transfer, done as two 1D passes.
+    // All buffers are column major like grscent, so the inner loops run over contiguous
+    // memory without branches and can be vectorized.
+    // Columns of the vertical sums, with one extra column on each side
+    std::array < std::array < int, SCENT_SPAN >, SCENT_SPAN + 2 > sum_3_scent_y;
+    std::array < std::array < int, SCENT_SPAN >, SCENT_SPAN + 2 > squares_used_y;
+    // Full 3x3 sums of every cell of the scent area
+    std::array < std::array < int, SCENT_SPAN >, SCENT_SPAN > sum_9_scent;
+    std::array < std::array < int, SCENT_SPAN >, SCENT_SPAN > squares_used;
 
     diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = m.access_cache(
                 center.z ).vehicle_obstructed_cache;
@@ -179,66 +187,64 @@ void scent_map::update( const tripoint &center, map &m )
     m.scent_blockers( scent_transfer, point( scentmap_minx - 1, scentmap_miny - 1 ),
                       point( scentmap_maxx + 1, scentmap_maxy + 1 ) );
 
-    for( int x = 0; x < SCENT_RADIUS * 2 + 3; ++x ) {
-        sum_3_scent_y[0][x] = 0;
-        squares_used_y[0][x] = 0;
-        sum_3_scent_y[SCENT_RADIUS * 2][x] = 0;
-        squares_used_y[SCENT_RADIUS * 2][x] = 0;
+    // remember the sum of the scent val for the 3 neighboring squares that can defuse into
+    for( int x = 0; x < SCENT_SPAN + 2; ++x ) {
+        const char *transfer = &scent_transfer[scentmap_minx - 1 + x][scentmap_miny - 1];
+        const int *scent = &grscent[scentmap_minx - 1 + x][scentmap_miny - 1];
+        std::array < int, SCENT_SPAN + 2 > weighted;
+        for( int y = 0; y < SCENT_SPAN + 2; ++y ) {
+            weighted[y] = transfer[y] * scent[y];
+        }
+        for( int y = 0; y < SCENT_SPAN; ++y ) {
+            sum_3_scent_y[x][y] = weighted[y] + weighted[y + 1] + weighted[y + 2];
+            squares_used_y[x][y] = transfer[y] + transfer[y + 1] + transfer[y + 2];
+        }
     }
 
-    for( int x = 0; x < SCENT_RADIUS * 2 + 3; ++x ) {
-        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
-
-            point abs( x + scentmap_minx - 1, y + scentmap_miny );
-
-            // remember the sum of the scent val for the 3 neighboring squares that can defuse into
-            sum_3_scent_y[y][x] = 0;
-            squares_used_y[y][x] = 0;
-            for( int i = abs.y - 1; i <= abs.y + 1; ++i ) {
-                sum_3_scent_y[y][x] += scent_transfer[abs.x][i] * grscent[abs.x][i];
-                squares_used_y[y][x] += scent_transfer[abs.x][i];
-            }
+    for( int x = 0; x < SCENT_SPAN; ++x ) {
+        for( int y = 0; y < SCENT_SPAN; ++y ) {
+            sum_9_scent[x][y] = sum_3_scent_y[x][y] + sum_3_scent_y[x + 1][y] + sum_3_scent_y[x + 2][y];
+            squares_used[x][y] = squares_used_y[x][y] + squares_used_y[x + 1][y] +
+                                 squares_used_y[x + 2][y];
         }
     }
 
-    for( int x = 1; x < SCENT_RADIUS * 2 + 2; ++x ) {
-        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
-            const point abs( x + scentmap_minx - 1, y + scentmap_miny );
-
-            int squares_used = squares_used_y[y][x - 1] + squares_used_y[y][x] + squares_used_y[y][x + 1];
-            int total = sum_3_scent_y[y][x - 1] + sum_3_scent_y[y][x] + sum_3_scent_y[y][x + 1];
-
-            //handle vehicle holes
-            if( blocked_cache[abs.x][abs.y].nw && scent_transfer[abs.x + 1][abs.y + 1] == 5 ) {
-                squares_used -= 4;
-                total -= 4 * grscent[abs.x + 1][abs.y + 1];
-            }
-            if( blocked_cache[abs.x][abs.y].ne && scent_transfer[abs.x - 1][abs.y + 1] == 5 ) {
-                squares_used -= 4;
-                total -= 4 * grscent[abs.x - 1][abs.y + 1];
-            }
-            if( blocked_cache[abs.x - 1][abs.y - 1].nw && scent_transfer[abs.x - 1][abs.y - 1] == 5 ) {
-                squares_used -= 4;
-                total -= 4 * grscent[abs.x - 1][abs.y - 1];
+    //handle vehicle holes
+    // A vehicle wall blocking the diagonal between two cells takes each of them out of the
+    // sums of the other one, as long as it would otherwise count as a normal cell.
+    const half_open_rectangle<point> scent_area( point( scentmap_minx, scentmap_miny ),
+            point( scentmap_maxx + 1, scentmap_maxy + 1 ) );
+    const auto remove_diagonal = [&]( point a, point b ) {
+        if( scent_area.contains( a ) && scent_transfer[b.x][b.y] == 5 ) {
+            squares_used[a.x - scentmap_minx][a.y - scentmap_miny] -= 4;
+            sum_9_scent[a.x - scentmap_minx][a.y - scentmap_miny] -= 4 * grscent[b.x][b.y];
+        }
+    };
+    for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
+        for( int y = scentmap_miny - 1; y <= scentmap_maxy; ++y ) {
+            const diagonal_blocks &blocks = blocked_cache[x][y];
+            if( blocks.nw ) {
+                remove_diagonal( point( x, y ), point( x + 1, y + 1 ) );
+                remove_diagonal( point( x + 1, y + 1 ), point( x, y ) );
             }
-            if( blocked_cache[abs.x + 1][abs.y - 1].ne && scent_transfer[abs.x + 1][abs.y - 1] == 5 ) {
-                squares_used -= 4;
-                total -= 4 * grscent[abs.x + 1][abs.y - 1];
+            if( blocks.ne ) {
+                remove_diagonal( point( x, y ), point( x - 1, y + 1 ) );
+                remove_diagonal( point( x - 1, y + 1 ), point( x, y ) );
             }
+        }
+    }
 
+    for( int x = 0; x < SCENT_SPAN; ++x ) {
+        const char *transfer = &scent_transfer[scentmap_minx + x][scentmap_miny];
+        int *scent = &grscent[scentmap_minx + x][scentmap_miny];
+        const int *total = sum_9_scent[x].data();
+        const int *used = squares_used[x].data();
+        for( int y = 0; y < SCENT_SPAN; ++y ) {
             //Lingering scent
-            int temp_scent =  grscent[abs.x][abs.y] * ( 250 - squares_used  *
-                              scent_transfer[abs.x][abs.y] ) ;
-            temp_scent -=  grscent[abs.x][abs.y] * scent_transfer[abs.x][abs.y] *
-                           ( 45 - squares_used ) / 5;
-
-            new_scent[y][x] = ( temp_scent + total * scent_transfer[abs.x][abs.y] ) / 250;
+            int temp_scent = scent[y] * ( 250 - used[y] * transfer[y] );
+            temp_scent -= scent[y] * transfer[y] * ( 45 - used[y] ) / 5;
 
-        }
-    }
-    for( int x = 1; x < SCENT_RADIUS * 2 + 2; ++x ) {
-        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
-            grscent[x + scentmap_minx - 1 ][y + scentmap_miny] = new_scent[y][x];
+            scent[y] = ( temp_scent + total[y] * transfer[y] ) / 250;
         }
     }
 }
@@ -0,0 +1,155 @@
+#pragma once
+#ifndef CATA_SRC_SET_ASSOC_CACHE_H
+#define CATA_SRC_SET_ASSOC_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * Fixed capacity cache with the same lookups as @ref lru_cache, but without
+ * allocating per entry. Entries live in one array of sets of two slots; a key
+ * can only be stored in the set its hash picks. When both slots of a set are
+ * taken, the one that was used less recently is evicted.
+ *
+ * The array is allocated on the first insertion, so unused caches cost nothing.
+ * @ref clear only bumps a generation counter and does not touch the array.
+ * Lookups update the recency and the statistics, so the cache must not be used
+ * from several threads at once without a lock.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class set_assoc_cache
+{
+    public:
+        struct statistics {
+            std::uint64_t hits = 0;
+            std::uint64_t misses = 0;
+            std::uint64_t evictions = 0;
+
+            double hit_rate() const {
+                const std::uint64_t lookups = hits + misses;
+                return lookups == 0 ? 0.0 : static_cast<double>( hits ) / lookups;
+            }
+        };
+
+        /** Makes a cache holding at least @p capacity entries. */
+        explicit set_assoc_cache( size_t capacity ) {
+            while( ( size_t( 1 ) << set_bits ) * ways < capacity ) {
+                set_bits++;
+            }
+        }
+
+        /** Number of entries the cache can hold at most. */
+        size_t capacity() const {
+            return ( size_t( 1 ) << set_bits ) * ways;
+        }
+
+        Value get( const Key &key, const Value &default_ ) const {
+            if( slots.empty() ) {
+                stats.misses++;
+                return default_;
+            }
+            const size_t set = set_of( key );
+            for( size_t way = 0; way < ways; way++ ) {
+                const slot &s = slots[set * ways + way];
+                if( s.generation == generation && s.key == key ) {
+                    recent[set] = static_cast<std::uint8_t>( way );
+                    stats.hits++;
+                    return s.value;
+                }
+            }
+            stats.misses++;
+            return default_;
+        }
+
+        void insert( const Key &key, const Value &value ) {
+            if( slots.empty() ) {
+                slots.resize( capacity() );
+                recent.resize( size_t( 1 ) << set_bits );
+            }
+            const size_t set = set_of( key );
+            size_t target = ways;
+            for( size_t way = 0; way < ways; way++ ) {
+                const slot &s = slots[set * ways + way];
+                if( s.generation != generation ) {
+                    if( target == ways ) {
+                        target = way;
+                    }
+                } else if( s.key == key ) {
+                    target = way;
+                    break;
+                }
+            }
+            if( target == ways ) {
+                // Both slots are taken by other keys: evict the one not used last
+                target = 1 - recent[set];
+                stats.evictions++;
+            }
+            slot &s = slots[set * ways + target];
+            s.key = key;
+            s.value = value;
+            s.generation = generation;
+            recent[set] = static_cast<std::uint8_t>( target );
+        }
+
+        void remove( const Key &key ) {
+            if( slots.empty() ) {
+                return;
+            }
+            const size_t set = set_of( key );
+            for( size_t way = 0; way < ways; way++ ) {
+                slot &s = slots[set * ways + way];
+                if( s.generation == generation && s.key == key ) {
+                    s.generation = 0;
+                }
+            }
+        }
+
+        /** Forgets all entries, the statistics are kept. */
+        void clear() {
+            generation++;
+            if( generation == 0 ) {
+                // Wrapped around, old entries could look valid again
+                for( slot &s : slots ) {
+                    s.generation = 0;
+                }
+                generation = 1;
+            }
+        }
+
+        const statistics &get_statistics() const {
+            return stats;
+        }
+        void reset_statistics() {
+            stats = statistics();
+        }
+
+    private:
+        static constexpr size_t ways = 2;
+
+        struct slot {
+            Key key = Key();
+            Value value = Value();
+            /** The slot holds an entry if this equals the cache's generation */
+            std::uint32_t generation = 0;
+        };
+
+        size_t set_of( const Key &key ) const {
+            if( set_bits == 0 ) {
+                return 0;
+            }
+            // Fibonacci hashing, so that weak hashes still spread over the sets
+            const std::uint64_t h = static_cast<std::uint64_t>( Hash()( key ) ) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<size_t>( h >> ( 64 - set_bits ) );
+        }
+
+        int set_bits = 0;
+        std::uint32_t generation = 1;
+        std::vector<slot> slots;
+        /** Per set, the slot that was used last */
+        mutable std::vector<std::uint8_t> recent;
+        mutable statistics stats;
+};
+
+#endif // CATA_SRC_SET_ASSOC_CACHE_H
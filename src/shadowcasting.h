@@ -77,6 +77,17 @@ struct four_quadrants {
     }
 };
 
+/**
+ * Inner loop used by the shadowcasting functions below. Both give identical output.
+ * row_span clips each row to the map once and looks tile distances up in tables.
+ * per_tile checks and measures every tile on its own, and is kept for comparison.
+ */
+enum class shadowcasting_kernel : int {
+    per_tile,
+    row_span,
+};
+extern shadowcasting_kernel shadowcasting_kernel_in_use;
+
 // Hoisted to header and inlined so the test in tests/shadowcasting_test.cpp can use it.
 // Beer-Lambert law says attenuation is going to be equal to
 // 1 / (e^al) where a = coefficient of absorption and l = length.
@@ -305,6 +305,15 @@ void submap::rotate( int turns )
         }
     }
 
+    field_tiles.clear();
+    for( int i = 0; i < SEEX; i++ ) {
+        for( int j = 0; j < SEEY; j++ ) {
+            if( fld[i][j].field_count() > 0 ) {
+                field_tiles.insert( { i, j } );
+            }
+        }
+    }
+
     active_items.rotate_locations( turns, { SEEX, SEEY } );
 
     for( auto &elem : cosmetics ) {
@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_SUBMAP_H
 #define CATA_SRC_SUBMAP_H
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -47,6 +48,56 @@ struct spawn_point {
         mission_id( MIS ), friendly( F ), name( N ) {}
 };
 
+/**
+ * Tiles of a submap that may hold fields. A tile is added when a field is added to it
+ * and dropped by field processing once its fields are gone, so this is a superset of
+ * the tiles with fields. Tiles are numbered x major, the order of the field loops.
+ */
+class submap_field_tiles
+{
+    public:
+        static int tile_index( point p ) {
+            return p.x * SEEY + p.y;
+        }
+        static point tile_point( int index ) {
+            return point( index / SEEY, index % SEEY );
+        }
+
+        void insert( point p ) {
+            const int index = tile_index( p );
+            words[index / word_bits] |= std::uint64_t( 1 ) << ( index % word_bits );
+        }
+        void erase( point p ) {
+            const int index = tile_index( p );
+            words[index / word_bits] &= ~( std::uint64_t( 1 ) << ( index % word_bits ) );
+        }
+        void clear() {
+            words.fill( 0 );
+        }
+        /** Index of the first tile in the set at or after the given index, -1 if there is none. */
+        int next( int from ) const {
+            for( int w = from / word_bits; w < static_cast<int>( words.size() ); w++ ) {
+                std::uint64_t bits = words[w];
+                if( w == from / word_bits ) {
+                    bits &= ~std::uint64_t( 0 ) << ( from % word_bits );
+                }
+                if( bits != 0 ) {
+                    int bit = 0;
+                    while( !( bits & 1 ) ) {
+                        bits >>= 1;
+                        bit++;
+                    }
+                    return w * word_bits + bit;
+                }
+            }
+            return -1;
+        }
+
+    private:
+        static constexpr int word_bits = 64;
+        std::array < std::uint64_t, ( SEEX * SEEY + word_bits - 1 ) / word_bits > words = {};
+};
+
 template<int sx, int sy>
 struct maptile_soa {
     ter_id             ter[sx][sy];  // Terrain on each square
@@ -197,6 +248,10 @@ class submap : maptile_soa<SEEX, SEEY>
         void rotate( int turns );
 
         void store( JsonOut &jsout ) const;
+        // Terrain, furniture, traps and radiation
+        void store_layers( JsonOut &jsout ) const;
+        // Everything store() writes except the layers
+        void store_contents( JsonOut &jsout ) const;
         void load( JsonIn &jsin, const std::string &member_name, int version );
 
         // If is_uniform is true, this submap is a solid block of terrain
@@ -208,6 +263,7 @@ class submap : maptile_soa<SEEX, SEEY>
         active_item_cache active_items;
 
         int field_count = 0;
+        submap_field_tiles field_tiles;
         time_point last_touched = calendar::turn_zero;
         std::vector<spawn_point> spawns;
         /**
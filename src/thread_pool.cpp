@@ -0,0 +1,156 @@
+#include "thread_pool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cata_utility.h"
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
+namespace
+{
+
+// Beyond this the planning passes stop scaling and the threads only take up memory
+constexpr int max_pool_workers = 15;
+
+// Set on pool threads and on the thread running a parallel_for, so that nested calls run serially
+thread_local bool inside_parallel_for = false;
+
+class thread_pool
+{
+    public:
+        explicit thread_pool( int workers ) {
+            for( int i = 0; i < workers; i++ ) {
+                threads.emplace_back( [this]() {
+                    worker_loop();
+                } );
+            }
+        }
+
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                stopping = true;
+            }
+            wake.notify_all();
+            for( std::thread &t : threads ) {
+                t.join();
+            }
+        }
+
+        int size() const {
+            return static_cast<int>( threads.size() );
+        }
+
+        void run( int count, const std::function<void( int )> &fn ) {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                job = &fn;
+                job_count = count;
+                next_index = 0;
+                busy = size();
+                generation++;
+            }
+            wake.notify_all();
+
+            work();
+
+            std::unique_lock<std::mutex> lock( mutex );
+            done.wait( lock, [this]() {
+                return busy == 0;
+            } );
+            job = nullptr;
+        }
+
+    private:
+        void worker_loop() {
+            inside_parallel_for = true;
+            unsigned int seen_generation = 0;
+            while( true ) {
+                {
+                    std::unique_lock<std::mutex> lock( mutex );
+                    wake.wait( lock, [this, seen_generation]() {
+                        return stopping || generation != seen_generation;
+                    } );
+                    if( stopping ) {
+                        return;
+                    }
+                    seen_generation = generation;
+                }
+
+                work();
+
+                std::lock_guard<std::mutex> lock( mutex );
+                if( --busy == 0 ) {
+                    done.notify_one();
+                }
+            }
+        }
+
+        void work() {
+            for( int i = next_index++; i < job_count; i = next_index++ ) {
+                ( *job )( i );
+            }
+        }
+
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        const std::function<void( int )> *job = nullptr;
+        int job_count = 0;
+        std::atomic<int> next_index{ 0 };
+        int busy = 0;
+        unsigned int generation = 0;
+        bool stopping = false;
+};
+
+thread_pool &get_pool()
+{
+    const int cores = static_cast<int>( std::thread::hardware_concurrency() );
+    static thread_pool pool( clamp( cores - 1, 0, max_pool_workers ) );
+    return pool;
+}
+
+} // namespace
+
+namespace cata
+{
+
+void parallel_for( int count, const std::function<void( int )> &fn )
+{
+    if( count <= 0 ) {
+        return;
+    }
+    if( count == 1 || inside_parallel_for || get_pool().size() == 0 ) {
+        for( int i = 0; i < count; i++ ) {
+            fn( i );
+        }
+        return;
+    }
+    inside_parallel_for = true;
+    get_pool().run( count, fn );
+    inside_parallel_for = false;
+}
+
+int parallel_for_threads()
+{
+    return get_pool().size() + 1;
+}
+
+parallel_for_serial_scope::parallel_for_serial_scope() : was_serial( inside_parallel_for )
+{
+    inside_parallel_for = true;
+}
+
+parallel_for_serial_scope::~parallel_for_serial_scope()
+{
+    inside_parallel_for = was_serial;
+}
+
+} // namespace cata
@@ -0,0 +1,41 @@
+#pragma once
+#ifndef CATA_SRC_THREAD_POOL_H
+#define CATA_SRC_THREAD_POOL_H
+
+#include <functional>
+
+namespace cata
+{
+
+/**
+ * Calls fn( i ) for every i in [0, count), spreading the calls over a shared pool
+ * of worker threads and the calling thread. Returns once all calls have finished.
+ *
+ * Calls may run in any order and at the same time, so fn must only read shared
+ * game state and write to state owned by index i. It must not touch the UI,
+ * the message log or the global random number generator.
+ * Nested calls run serially on the calling thread.
+ */
+void parallel_for( int count, const std::function<void( int )> &fn );
+
+/** Number of threads parallel_for may use, including the calling thread. */
+int parallel_for_threads();
+
+/**
+ * While one of these exists, parallel_for calls on the thread that made it run serially.
+ * Used to compare parallel code with its serial result.
+ */
+class parallel_for_serial_scope
+{
+    public:
+        parallel_for_serial_scope();
+        ~parallel_for_serial_scope();
+        parallel_for_serial_scope( const parallel_for_serial_scope & ) = delete;
+        parallel_for_serial_scope &operator=( const parallel_for_serial_scope & ) = delete;
+    private:
+        bool was_serial;
+};
+
+} // namespace cata
+
+#endif // CATA_SRC_THREAD_POOL_H
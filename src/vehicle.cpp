@@ -1570,6 +1570,7 @@ int vehicle::install_part( point dp, const vpart_id &id, item &&obj, bool force
 
 int vehicle::install_part( point dp, const vehicle_part &new_part )
 {
+    map::invalidate_inventory_caches();
     // Should be checked before installing the part
     bool enable = false;
     if( new_part.is_engine() ) {
@@ -1837,6 +1838,7 @@ bool vehicle::remove_part( const int p, RemovePartHandler &handler )
         return false;
     }
 
+    map::invalidate_inventory_caches();
     const tripoint part_loc = global_part_pos3( p );
 
     // Unboard any entities standing on removed boardable parts
@@ -5390,6 +5392,7 @@ std::optional<vehicle_stack::iterator> vehicle::add_item( vehicle_part &pt, cons
 
 std::optional<vehicle_stack::iterator> vehicle::add_item( int part, const item &itm )
 {
+    map::invalidate_inventory_caches();
     if( part < 0 || part >= static_cast<int>( parts.size() ) ) {
         debugmsg( "int part (%d) is out of range", part );
         return std::nullopt;
@@ -5452,6 +5455,7 @@ bool vehicle::remove_item( int part, item *it )
 
 vehicle_stack::iterator vehicle::remove_item( int part, vehicle_stack::const_iterator it )
 {
+    map::invalidate_inventory_caches();
     cata::colony<item> &veh_items = parts[part].items;
 
     // remove from the active items cache (if it isn't there does nothing)
@@ -254,6 +254,7 @@ int vehicle_part::ammo_remaining() const
 
 int vehicle_part::ammo_set( const itype_id &ammo, int qty )
 {
+    map::invalidate_inventory_caches();
     const itype *liquid = &*ammo;
 
     // We often check if ammo is set to see if tank is empty, if qty == 0 don't set ammo
@@ -279,6 +280,7 @@ int vehicle_part::ammo_set( const itype_id &ammo, int qty )
 
 void vehicle_part::ammo_unset()
 {
+    map::invalidate_inventory_caches();
     if( is_tank() ) {
         base.contents.clear_items();
     } else if( is_fuel_store() ) {
@@ -288,6 +290,7 @@ void vehicle_part::ammo_unset()
 
 int vehicle_part::ammo_consume( int qty, const tripoint &pos )
 {
+    map::invalidate_inventory_caches();
     if( is_tank() && !base.contents.empty() ) {
         const int res = std::min( ammo_remaining(), qty );
         item &liquid = base.contents.back();
@@ -178,7 +178,7 @@ bool visitable<inventory>::has_quality( const quality_id &qual, int level, int q
     const inventory *inv = static_cast<const inventory *>( this );
     const std::map<quality_id, std::map<int, int>> &inv_qual_cache = inv->get_quality_cache();
     int res = 0;
-    if( !inv_qual_cache.empty() ) {
+    if( inv->quality_cached ) {
         auto iter = inv_qual_cache.find( qual );
         if( iter != inv_qual_cache.end() ) {
             for( const auto &q : iter->second ) {
@@ -190,7 +190,7 @@ bool visitable<inventory>::has_quality( const quality_id &qual, int level, int q
         return res >= qty;
     }
     for( const auto &stack : inv->items ) {
-        res += stack.size() * has_quality_internal( stack.front(), qual, level, qty );
+        res += stack->size() * has_quality_internal( stack->front(), qual, level, qty );
         if( res >= qty ) {
             return true;
         }
@@ -432,8 +432,10 @@ VisitResponse visitable<inventory>::visit_items(
     const std::function<VisitResponse( item *, item * )> &func )
 {
     auto inv = static_cast<inventory *>( this );
+    // The visited items may change type
+    inv->items_type_cached = false;
     for( auto &stack : inv->items ) {
-        for( auto &it : stack ) {
+        for( auto &it : *stack ) {
             if( visit_internal( func, &it ) == VisitResponse::ABORT ) {
                 return VisitResponse::ABORT;
             }
@@ -623,7 +625,7 @@ std::list<item> visitable<inventory>::remove_items_with( const
     }
 
     for( auto stack = inv->items.begin(); stack != inv->items.end() && count > 0; ) {
-        std::list<item> &istack = *stack;
+        std::list<item> &istack = **stack;
         const auto original_invlet = istack.front().invlet;
 
         for( auto istack_iter = istack.begin(); istack_iter != istack.end() && count > 0; ) {
@@ -652,8 +654,7 @@ std::list<item> visitable<inventory>::remove_items_with( const
     }
 
     // Invalidate binning cache
-    inv->binned = false;
-    inv->items_type_cached = false;
+    inv->invalidate_caches();
 
     return res;
 }
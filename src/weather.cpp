@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -1147,6 +1148,46 @@ void weather_manager::clear_temp_cache()
     temperature_cache.clear();
 }
 
+// A year of hours of one place, a stack of items catching up a shorter absence all hit the cache
+static constexpr int hourly_temperature_cache_size = 24 * 365;
+
+units::temperature weather_manager::hour_temperature( const point_abs_omt &omt, int hour ) const
+{
+    const tripoint key( omt.x(), omt.y(), hour );
+    const int missing = std::numeric_limits<int>::min();
+    const int cached = hourly_temperature_cache.get( key, missing );
+    if( cached != missing ) {
+        return units::from_millidegree_celsius( cached );
+    }
+    // Middle of the overmap terrain
+    const tripoint_abs_ms location( project_to<coords::ms>( omt ) + point( SEEX, SEEY ), 0 );
+    const units::temperature result = hourly_temperature_gen->get_weather_temperature( location,
+                                      calendar::turn_zero + time_duration::from_hours( hour ), calendar::config,
+                                      hourly_temperature_seed );
+    hourly_temperature_cache.insert( hourly_temperature_cache_size, key,
+                                     units::to_millidegree_celsius( result ) );
+    return result;
+}
+
+units::temperature weather_manager::get_hourly_weather_temperature(
+    const tripoint_abs_ms &location, const time_point &t ) const
+{
+    const weather_generator &wgen = get_cur_weather_gen();
+    const unsigned seed = g->get_seed();
+    if( hourly_temperature_gen != &wgen || hourly_temperature_seed != seed ) {
+        hourly_temperature_cache.clear();
+        hourly_temperature_gen = &wgen;
+        hourly_temperature_seed = seed;
+    }
+
+    const point_abs_omt omt = project_to<coords::omt>( location.xy() );
+    const double hours = to_hours<double>( t - calendar::turn_zero );
+    const int hour = static_cast<int>( std::floor( hours ) );
+    const units::temperature before = hour_temperature( omt, hour );
+    const units::temperature after = hour_temperature( omt, hour + 1 );
+    return before + units::multiply_any_unit( after - before, hours - hour );
+}
+
 namespace weather
 {
 
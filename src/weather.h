@@ -5,6 +5,7 @@
 #include "calendar.h"
 #include "color.h"
 #include "coordinates.h"
+#include "lru_cache.h"
 #include "pimpl.h"
 #include "point.h"
 #include "type_id.h"
@@ -214,6 +215,15 @@ class weather_manager
         int get_water_temperature( const tripoint &location ) const;
         void clear_temp_cache();
 
+        /**
+         * Weather temperature at the given place and time, for catching up the rot of items
+         * that were outside the reality bubble. The weather is generated once per overmap
+         * terrain and hour and interpolated in between, so a stack of items does not
+         * generate the same hours again for every item.
+         */
+        units::temperature get_hourly_weather_temperature( const tripoint_abs_ms &location,
+                const time_point &t ) const;
+
         // Get precise weather data
         const w_point &get_precise() const {
             return weather_precise;
@@ -227,6 +237,13 @@ class weather_manager
     private:
         // Cached weather data
         w_point weather_precise;
+
+        units::temperature hour_temperature( const point_abs_omt &omt, int hour ) const;
+        // Millidegrees Celsius by overmap terrain x, y and hour since turn zero as z
+        mutable lru_cache<tripoint, int> hourly_temperature_cache;
+        // What the cached temperatures were generated with
+        mutable const weather_generator *hourly_temperature_gen = nullptr;
+        mutable unsigned hourly_temperature_seed = 0;
 };
 
 weather_manager &get_weather();
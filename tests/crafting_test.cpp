@@ -1,6 +1,7 @@
 #include "catch/catch.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <climits>
 #include <map>
 #include <memory>
@@ -24,6 +25,7 @@
 #include "itype.h"
 #include "map.h"
 #include "map_helpers.h"
+#include "map_iterator.h"
 #include "npc.h"
 #include "overmap.h"
 #include "overmapbuffer.h"
@@ -31,15 +33,21 @@
 #include "player_helpers.h"
 #include "point.h"
 #include "recipe.h"
+#include "recipe_availability.h"
 #include "recipe_dictionary.h"
 #include "requirements.h"
 #include "state_helpers.h"
+#include "string_formatter.h"
 #include "string_id.h"
 #include "type_id.h"
 #include "value_ptr.h"
 
 class inventory;
 
+static const itype_id itype_hammer( "hammer" );
+
+static const quality_id qual_HAMMER( "HAMMER" );
+
 static const trait_id trait_DEBUG_HS( "DEBUG_HS" );
 static const trait_id trait_DEBUG_STORAGE( "DEBUG_STORAGE" );
 
@@ -763,3 +771,169 @@ TEST_CASE( "tool selection ui", "[crafting][ui]" )
         }
     }
 }
+
+TEST_CASE( "crafting_inventory_follows_map_changes", "[crafting]" )
+{
+    clear_all_state();
+    map &m = get_map();
+    avatar &u = get_avatar();
+    const tripoint start_pos( 60, 60, 0 );
+    u.setpos( start_pos );
+    clear_avatar();
+    const itype_id rock( "rock" );
+    REQUIRE_FALSE( u.crafting_inventory().has_amount( rock, 1 ) );
+
+    // Nothing but the map changes between the checks
+    m.add_item( start_pos + point_east, item( rock ) );
+    calendar::turn += 1_turns;
+    CHECK( u.crafting_inventory().has_amount( rock, 1 ) );
+
+    const int revision = map::inventory_revision();
+    calendar::turn += 1_turns;
+    CHECK( u.crafting_inventory().has_amount( rock, 1 ) );
+    CHECK( map::inventory_revision() == revision );
+
+    m.i_clear( start_pos + point_east );
+    calendar::turn += 1_turns;
+    CHECK_FALSE( u.crafting_inventory().has_amount( rock, 1 ) );
+
+    m.furn_set( start_pos + point_west, furn_str_id( "f_anvil" ) );
+    calendar::turn += 1_turns;
+    CHECK( u.crafting_inventory().has_tools( itype_id( "anvil" ), 1 ) );
+}
+
+TEST_CASE( "crafting_inventory_in_a_stocked_workshop", "[.]" )
+{
+    clear_all_state();
+    map &m = get_map();
+    avatar &u = get_avatar();
+    const tripoint start_pos( 60, 60, 0 );
+    u.setpos( start_pos );
+    clear_avatar();
+    int items = 0;
+    for( const tripoint &p : m.points_in_radius( start_pos, PICKUP_RANGE ) ) {
+        for( const char *id : { "rock", "pot", "hammer", "scrap", "2x4" } ) {
+            m.add_item( p, item( id ) );
+            items++;
+        }
+    }
+
+    const int turns = 1000;
+    const auto start = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < turns; i++ ) {
+        calendar::turn += 1_turns;
+        u.crafting_inventory();
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    const long long us = std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count();
+    cata_printf( "%d items nearby, %lld us per crafting inventory\n", items, us / turns );
+}
+
+// Holds the first choice of every requirement of every third recipe
+static inventory stocked_crafting_inventory()
+{
+    inventory inv;
+    int n = 0;
+    for( const auto &pr : recipe_dict ) {
+        if( n++ % 3 != 0 ) {
+            continue;
+        }
+        const requirement_data &req = pr.second.simple_requirements();
+        for( const std::vector<tool_comp> &tools : req.get_tools() ) {
+            inv.add_item( item( tools.front().type ) );
+        }
+        for( const std::vector<item_comp> &comps : req.get_components() ) {
+            const itype_id &type = comps.front().type;
+            inv.add_item( item::count_by_charges( type ) ? item( type, calendar::turn, 20 ) : item( type ) );
+        }
+    }
+    inv.update_quality_cache();
+    return inv;
+}
+
+TEST_CASE( "recipe_availability_checker_agrees_with_requirements", "[crafting]" )
+{
+    clear_all_state();
+    const inventory inv = stocked_crafting_inventory();
+    recipe_availability_checker checker( inv );
+    int craftable = 0;
+    int uncraftable = 0;
+    for( const auto &pr : recipe_dict ) {
+        const recipe &r = pr.second;
+        // Obsolete recipes are never listed, their results may not exist anymore
+        if( r.obsolete ) {
+            continue;
+        }
+        CAPTURE( r.ident() );
+        const recipe_availability avail = checker.check( r );
+        const deduped_requirement_data &req = r.deduped_requirements();
+        CHECK( avail.could_craft_if_knew == req.can_make_with_inventory( inv,
+                r.get_component_filter(), 1, cost_adjustment::start_only ) );
+        CHECK( avail.can_craft_non_rotten == req.can_make_with_inventory( inv,
+                r.get_component_filter( recipe_filter_flags::no_rotten ), 1, cost_adjustment::start_only ) );
+        CHECK( avail.apparently_craftable == r.simple_requirements().can_make_with_inventory( inv,
+                r.get_component_filter(), 1, cost_adjustment::start_only ) );
+        ( avail.could_craft_if_knew ? craftable : uncraftable )++;
+    }
+    CHECK( craftable > 0 );
+    CHECK( uncraftable > 0 );
+}
+
+TEST_CASE( "recipe_availability_of_a_component_providing_a_quality", "[crafting]" )
+{
+    clear_all_state();
+    // The hammer used up as a component can't also provide the hammering quality
+    const requirement_data req( {}, { { quality_requirement( qual_HAMMER, 1, 1 ) } },
+    { { item_comp( itype_hammer, 1 ) } } );
+    const auto filter = recipe::component_filter( component_rules::none );
+    inventory inv;
+    inv.add_item( item( itype_hammer ) );
+    inv.update_quality_cache();
+    CHECK_FALSE( req.can_make_with_inventory( inv, filter ) );
+    CHECK_FALSE( recipe_availability_checker( inv ).can_make( req, component_rules::none ) );
+
+    inv.add_item( item( itype_hammer ) );
+    inv.update_quality_cache();
+    CHECK( req.can_make_with_inventory( inv, filter ) );
+    CHECK( recipe_availability_checker( inv ).can_make( req, component_rules::none ) );
+}
+
+TEST_CASE( "recipe_availability_of_every_recipe", "[.]" )
+{
+    clear_all_state();
+    const inventory inv = stocked_crafting_inventory();
+    std::vector<const recipe *> recipes;
+    for( const auto &pr : recipe_dict ) {
+        if( !pr.second.obsolete ) {
+            recipes.push_back( &pr.second );
+        }
+    }
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    int one_by_one = 0;
+    for( const recipe *r : recipes ) {
+        const deduped_requirement_data &req = r->deduped_requirements();
+        const auto all_items_filter = r->get_component_filter( recipe_filter_flags::none );
+        const auto no_rotten_filter = r->get_component_filter( recipe_filter_flags::no_rotten );
+        one_by_one += req.can_make_with_inventory( inv, all_items_filter, 1,
+                      cost_adjustment::start_only );
+        req.can_make_with_inventory( inv, no_rotten_filter, 1, cost_adjustment::start_only );
+        r->simple_requirements().can_make_with_inventory( inv, all_items_filter, 1,
+                cost_adjustment::start_only );
+    }
+    const auto middle = std::chrono::high_resolution_clock::now();
+    recipe_availability_checker checker( inv );
+    int batched = 0;
+    for( const recipe_availability &avail : checker.check( recipes ) ) {
+        batched += avail.could_craft_if_knew;
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    CHECK( batched == one_by_one );
+
+    const auto ms = []( auto duration ) {
+        return static_cast<long long>(
+                   std::chrono::duration_cast<std::chrono::milliseconds>( duration ).count() );
+    };
+    cata_printf( "%d recipes, %d craftable: %lld ms one by one, %lld ms batched\n",
+                 static_cast<int>( recipes.size() ), batched, ms( middle - start ), ms( end - middle ) );
+}
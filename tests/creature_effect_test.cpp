@@ -0,0 +1,44 @@
+#include "catch/catch.hpp"
+
+#include <vector>
+
+#include "calendar.h"
+#include "effect.h"
+#include "map_helpers.h"
+#include "monster.h"
+#include "state_helpers.h"
+#include "type_id.h"
+
+static const efftype_id effect_dazed( "dazed" );
+static const efftype_id effect_downed( "downed" );
+static const efftype_id effect_stunned( "stunned" );
+
+TEST_CASE( "creature_effect_checks_follow_added_and_removed_effects", "[effect]" )
+{
+    clear_all_state();
+    put_player_underground();
+    monster &zombie = spawn_test_monster( "mon_zombie", tripoint( 60, 60, 0 ) );
+    // No effect type is reported before any was added
+    for( const efftype_id &id : find_all_effect_types() ) {
+        CAPTURE( id.str() );
+        CHECK_FALSE( zombie.has_effect( id ) );
+    }
+
+    zombie.add_effect( effect_downed, 5_turns, num_bp, 0, true, true );
+    zombie.add_effect( effect_stunned, 5_turns, num_bp, 0, true, true );
+    CHECK( zombie.has_effect( effect_downed ) );
+    CHECK( zombie.has_effect( effect_stunned ) );
+    CHECK_FALSE( zombie.has_effect( effect_dazed ) );
+    CHECK( zombie.get_effect_dur( effect_downed ) == 5_turns );
+    CHECK( zombie.get_all_effects_of_type( effect_stunned ).size() == 1 );
+    CHECK( zombie.get_all_effects_of_type( effect_dazed ).empty() );
+
+    zombie.remove_effect( effect_downed );
+    CHECK_FALSE( zombie.has_effect( effect_downed ) );
+    zombie.process_effects();
+    CHECK_FALSE( zombie.has_effect( effect_downed ) );
+    CHECK( zombie.has_effect( effect_stunned ) );
+
+    zombie.add_effect( effect_downed, 5_turns, num_bp, 0, true, true );
+    CHECK( zombie.has_effect( effect_downed ) );
+}
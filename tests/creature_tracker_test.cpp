@@ -0,0 +1,119 @@
+#include "catch/catch.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include "creature_tracker.h"
+#include "game.h"
+#include "json.h"
+#include "line.h"
+#include "map_helpers.h"
+#include "monster.h"
+#include "point.h"
+#include "state_helpers.h"
+
+static std::vector<monster *> brute_force_in_radius( const tripoint &center, int radius )
+{
+    std::vector<monster *> result;
+    for( monster &critter : g->all_monsters() ) {
+        if( square_dist( center, critter.pos() ) <= radius ) {
+            result.push_back( &critter );
+        }
+    }
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+static std::vector<monster *> sorted_in_radius( const tripoint &center, int radius )
+{
+    std::vector<monster *> result = g->critter_tracker->find_in_radius( center, radius );
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+static void check_queries()
+{
+    const std::vector<tripoint> centers = {
+        tripoint( 60, 60, 0 ), tripoint( 5, 5, 0 ), tripoint( 130, 70, 0 ), tripoint( 66, 66, 1 )
+    };
+    for( const tripoint &center : centers ) {
+        for( int radius : { 0, 1, 5, 13, 40, 200 } ) {
+            CAPTURE( center, radius );
+            CHECK( sorted_in_radius( center, radius ) == brute_force_in_radius( center, radius ) );
+        }
+    }
+}
+
+TEST_CASE( "creature_tracker_radius_queries", "[creature_tracker]" )
+{
+    clear_all_state();
+    for( int i = 0; i < 40; i++ ) {
+        spawn_test_monster( "mon_zombie", tripoint( 3 + ( i * 37 ) % 125, 3 + ( i * 53 ) % 125, 0 ) );
+    }
+    spawn_test_monster( "mon_zombie", tripoint( 66, 66, 0 ) );
+    check_queries();
+
+    SECTION( "after monsters move" ) {
+        int i = 0;
+        for( monster &critter : g->all_monsters() ) {
+            const tripoint dest = critter.pos() + point( i % 7 - 3, i % 5 - 2 );
+            if( g->is_empty( dest ) ) {
+                critter.setpos( dest );
+            }
+            i++;
+        }
+        check_queries();
+    }
+
+    SECTION( "after monsters are removed" ) {
+        int i = 0;
+        for( monster &critter : g->all_monsters() ) {
+            if( i++ % 3 == 0 ) {
+                g->remove_zombie( critter );
+            }
+        }
+        check_queries();
+    }
+
+    SECTION( "after monsters die" ) {
+        int i = 0;
+        for( monster &critter : g->all_monsters() ) {
+            if( i++ % 4 == 0 ) {
+                critter.die( nullptr );
+            }
+        }
+        g->cleanup_dead();
+        check_queries();
+    }
+
+    SECTION( "after the monsters are loaded again" ) {
+        std::ostringstream saved;
+        JsonOut jsout( saved );
+        g->critter_tracker->serialize( jsout );
+        std::istringstream loaded( saved.str() );
+        JsonIn jsin( loaded );
+        g->critter_tracker->deserialize( jsin );
+        check_queries();
+    }
+}
+
+TEST_CASE( "creature_tracker_faction_queries", "[creature_tracker]" )
+{
+    clear_all_state();
+    put_player_underground();
+    monster &zombie = spawn_test_monster( "mon_zombie", tripoint( 60, 60, 0 ) );
+    monster &dog = spawn_test_monster( "mon_dog", tripoint( 62, 60, 0 ) );
+    monster &pet = spawn_test_monster( "mon_dog", tripoint( 60, 62, 0 ) );
+    pet.friendly = -1;
+
+    const std::vector<monster *> zombies = g->critter_tracker->find_in_radius( tripoint( 60, 60, 0 ),
+                                           5, zombie.faction );
+    CHECK( zombies == std::vector<monster *> { &zombie } );
+    const std::vector<monster *> dogs = g->critter_tracker->find_in_radius( tripoint( 60, 60, 0 ), 5,
+                                        dog.faction );
+    CHECK( dogs == std::vector<monster *> { &dog } );
+    const std::vector<monster *> pets = g->critter_tracker->find_in_radius( tripoint( 60, 60, 0 ), 5,
+                                        mfaction_str_id( "player" ).id() );
+    CHECK( pets == std::vector<monster *> { &pet } );
+}
@@ -0,0 +1,73 @@
+#include "catch/catch.hpp"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "data_snapshot.h"
+#include "filesystem.h"
+#include "fstream_utils.h"
+#include "game.h"
+#include "init.h"
+
+static void write_test_file( const std::string &path, const std::string &contents )
+{
+    REQUIRE( write_to_file( path, [&contents]( std::ostream & fout ) {
+        fout << contents;
+    }, nullptr ) );
+}
+
+static data_snapshot make_test_snapshot( const std::string &pack_path )
+{
+    return data_snapshot( { { pack_path, DynamicDataLoader::get_data_files( pack_path ) } } );
+}
+
+TEST_CASE( "data_snapshot_keeps_pack_files_until_they_change", "[init]" )
+{
+    const std::string base = g->get_world_base_save_path() + "/data_snapshot_test_" +
+                             get_pid_string() + "/";
+    const std::string pack_path = base + "pack";
+    const std::string snapshot_path = base + "snapshot.bin";
+    REQUIRE( assure_dir_exist( base ) );
+    REQUIRE( assure_dir_exist( pack_path ) );
+    write_test_file( pack_path + "/a.json", R"([ { "type": "a" } ])" );
+    write_test_file( pack_path + "/b.json", R"([ { "type": "b" } ])" );
+
+    data_snapshot first = make_test_snapshot( pack_path );
+    const std::vector<std::string> files = first.files( pack_path );
+    REQUIRE( files.size() == 2 );
+    CHECK( first.contents( pack_path ) == nullptr );
+    CHECK_FALSE( first.load( snapshot_path ) );
+    std::vector<std::string> contents;
+    for( const std::string &file : files ) {
+        contents.push_back( read_entire_file( file ) );
+    }
+    first.record_contents( pack_path, contents );
+    REQUIRE( first.save( snapshot_path ) );
+
+    SECTION( "unchanged files are read from the snapshot" ) {
+        data_snapshot second = make_test_snapshot( pack_path );
+        CHECK( second.get_fingerprint() == first.get_fingerprint() );
+        REQUIRE( second.load( snapshot_path ) );
+        REQUIRE( second.contents( pack_path ) != nullptr );
+        CHECK( *second.contents( pack_path ) == contents );
+    }
+    SECTION( "a changed file makes the snapshot stale" ) {
+        write_test_file( pack_path + "/b.json", R"([ { "type": "b", "changed": true } ])" );
+        data_snapshot second = make_test_snapshot( pack_path );
+        CHECK( second.get_fingerprint() != first.get_fingerprint() );
+        CHECK_FALSE( second.load( snapshot_path ) );
+        CHECK( second.contents( pack_path ) == nullptr );
+    }
+    SECTION( "a new file makes the snapshot stale" ) {
+        write_test_file( pack_path + "/c.json", "[]" );
+        data_snapshot second = make_test_snapshot( pack_path );
+        CHECK_FALSE( second.load( snapshot_path ) );
+    }
+
+    for( const std::string &file : get_files_from_path( "", base, true, true ) ) {
+        remove_file( file );
+    }
+    remove_directory( pack_path );
+    remove_directory( base );
+}
@@ -0,0 +1,114 @@
+#include "catch/catch.hpp"
+
+#include <chrono>
+
+#include "calendar.h"
+#include "field.h"
+#include "game_constants.h"
+#include "map.h"
+#include "map_iterator.h"
+#include "mapbuffer.h"
+#include "mapdata.h"
+#include "point.h"
+#include "state_helpers.h"
+#include "string_formatter.h"
+#include "submap.h"
+#include "type_id.h"
+
+static submap *submap_at( const tripoint &p, point &l )
+{
+    l = point( p.x % SEEX, p.y % SEEY );
+    const point grid( p.x / SEEX, p.y / SEEY );
+    return MAPBUFFER.lookup_submap( tripoint( get_map().get_abs_sub().xy() + grid, p.z ) );
+}
+
+static bool has_tile( const submap_field_tiles &tiles, point p )
+{
+    const int index = submap_field_tiles::tile_index( p );
+    return tiles.next( index ) == index;
+}
+
+// Every tile holding a field has to be in the tile set of its submap
+static void check_field_tiles_cover_fields()
+{
+    map &here = get_map();
+    int with_fields = 0;
+    for( const tripoint &p : here.points_on_zlevel() ) {
+        point l;
+        const submap *sm = submap_at( p, l );
+        if( sm->get_field( l ).field_count() > 0 ) {
+            with_fields++;
+            INFO( p );
+            CHECK( has_tile( sm->field_tiles, l ) );
+        }
+    }
+    CHECK( with_fields > 0 );
+}
+
+TEST_CASE( "submap_field_tiles_are_visited_in_scan_order", "[field]" )
+{
+    submap_field_tiles tiles;
+    CHECK( tiles.next( 0 ) == -1 );
+    tiles.insert( point( SEEX - 1, SEEY - 1 ) );
+    tiles.insert( point( 0, 5 ) );
+    tiles.insert( point( 5, 0 ) );
+
+    const int first = tiles.next( 0 );
+    CHECK( submap_field_tiles::tile_point( first ) == point( 0, 5 ) );
+    const int second = tiles.next( first + 1 );
+    CHECK( submap_field_tiles::tile_point( second ) == point( 5, 0 ) );
+    const int last = tiles.next( second + 1 );
+    CHECK( submap_field_tiles::tile_point( last ) == point( SEEX - 1, SEEY - 1 ) );
+    CHECK( tiles.next( last + 1 ) == -1 );
+
+    tiles.erase( point( 5, 0 ) );
+    CHECK( tiles.next( first + 1 ) == last );
+}
+
+TEST_CASE( "field_tiles_follow_added_and_removed_fields", "[field]" )
+{
+    clear_all_state();
+    map &here = get_map();
+    const tripoint origin( 60, 60, 0 );
+    point l;
+    submap *sm = submap_at( origin, l );
+
+    here.add_field( origin, fd_blood, 1 );
+    CHECK( has_tile( sm->field_tiles, l ) );
+    here.remove_field( origin, fd_blood );
+    CHECK_FALSE( has_tile( sm->field_tiles, l ) );
+
+    SECTION( "spreading fields are tracked" ) {
+        here.add_field( origin, fd_smoke, 3 );
+        for( int i = 0; i < 10; i++ ) {
+            here.process_fields();
+            calendar::turn += 1_turns;
+        }
+        check_field_tiles_cover_fields();
+    }
+}
+
+TEST_CASE( "process_fields_in_a_burning_city", "[.]" )
+{
+    clear_all_state();
+    map &here = get_map();
+    int burning = 0;
+    for( const tripoint &p : here.points_on_zlevel() ) {
+        if( p.x % 12 < 4 && p.y % 12 < 4 ) {
+            here.ter_set( p, t_floor );
+            here.furn_set( p, f_chair );
+            here.add_field( p, fd_fire, 3 );
+            burning++;
+        }
+    }
+
+    const int turns = 100;
+    const auto start = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < turns; i++ ) {
+        here.process_fields();
+        calendar::turn += 1_turns;
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    const long long us = std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count();
+    cata_printf( "%d tiles set on fire, %lld us per turn of field processing\n", burning, us / turns );
+}
@@ -0,0 +1,97 @@
+#include "catch/catch.hpp"
+
+#include <string>
+#include <vector>
+
+#include "avatar.h"
+#include "flag.h"
+#include "item.h"
+#include "item_factory.h"
+#include "itype.h"
+#include "mutation.h"
+#include "player_helpers.h"
+#include "state_helpers.h"
+#include "type_id.h"
+
+static const flag_str_id flag_FILTHY( "FILTHY" );
+static const flag_str_id flag_WATERPROOF( "WATERPROOF" );
+
+static const itype_id itype_gloves_leather( "gloves_leather" );
+
+static const trait_id trait_CANNIBAL( "CANNIBAL" );
+static const trait_id trait_PRED2( "PRED2" );
+
+TEST_CASE( "itype_flag_bits_match_flag_names", "[flag]" )
+{
+    // Types added at runtime skip finalization and look their flags up by name
+    REQUIRE( itype_gloves_leather->item_tag_bits_ready );
+    for( const itype *type : item_controller->all() ) {
+        for( const json_flag &f : json_flag::get_all() ) {
+            CAPTURE( type->get_id().str(), f.id.str() );
+            CHECK( type->has_flag( f.id ) == ( type->get_flags().count( f.id.str() ) > 0 ) );
+        }
+    }
+}
+
+TEST_CASE( "item_has_flag_checks_type_and_own_flags", "[flag]" )
+{
+    item gloves( itype_gloves_leather );
+    REQUIRE( gloves.type->has_flag( flag_WATERPROOF ) == gloves.has_flag( flag_WATERPROOF ) );
+    CHECK_FALSE( gloves.has_flag( flag_FILTHY ) );
+    CHECK_FALSE( gloves.has_flag( "FILTHY" ) );
+    gloves.set_flag( flag_FILTHY.str() );
+    CHECK( gloves.has_flag( flag_FILTHY ) );
+    CHECK( gloves.has_flag( "FILTHY" ) );
+    gloves.unset_flag( flag_FILTHY.str() );
+    CHECK_FALSE( gloves.has_flag( flag_FILTHY ) );
+}
+
+TEST_CASE( "has_trait_flag_follows_mutations", "[flag][mutations]" )
+{
+    clear_all_state();
+    avatar &you = get_avatar();
+    CHECK_FALSE( you.has_trait_flag( "CANNIBAL" ) );
+    CHECK_FALSE( you.has_trait_flag( "PRED2" ) );
+    CHECK_FALSE( you.has_trait_flag( "NOT_A_MUTATION_FLAG" ) );
+
+    you.set_mutation( trait_CANNIBAL );
+    CHECK( you.has_trait_flag( "CANNIBAL" ) );
+    CHECK_FALSE( you.has_trait_flag( "PRED2" ) );
+
+    you.set_mutation( trait_PRED2 );
+    CHECK( you.has_trait_flag( "PRED2" ) );
+
+    you.unset_mutation( trait_CANNIBAL );
+    CHECK_FALSE( you.has_trait_flag( "CANNIBAL" ) );
+    CHECK( you.has_trait_flag( "PRED2" ) );
+
+    clear_avatar();
+    CHECK_FALSE( you.has_trait_flag( "PRED2" ) );
+}
+
+TEST_CASE( "flag_lookup_benchmark", "[.][flag][benchmark]" )
+{
+    clear_all_state();
+    avatar &you = get_avatar();
+    you.set_mutation( trait_CANNIBAL );
+    you.set_mutation( trait_PRED2 );
+    item gloves( itype_gloves_leather );
+    gloves.set_flag( flag_FILTHY.str() );
+
+    BENCHMARK( "item::has_flag( flag_str_id )" ) {
+        return gloves.has_flag( flag_WATERPROOF );
+    };
+    BENCHMARK( "item::has_flag( std::string )" ) {
+        return gloves.has_flag( "WATERPROOF" );
+    };
+    BENCHMARK( "item::has_flag own flag" ) {
+        return gloves.has_flag( flag_FILTHY );
+    };
+    BENCHMARK( "Character::has_trait_flag" ) {
+        return you.has_trait_flag( "PRED2" );
+    };
+    BENCHMARK( "Character::has_trait_flag missing" ) {
+        return you.has_trait_flag( "NO_THIRST" );
+    };
+    clear_avatar();
+}
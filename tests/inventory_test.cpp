@@ -0,0 +1,102 @@
+#include "catch/catch.hpp"
+
+#include <list>
+
+#include "calendar.h"
+#include "inventory.h"
+#include "item.h"
+#include "state_helpers.h"
+#include "type_id.h"
+
+static const itype_id itype_2x4( "2x4" );
+static const itype_id itype_hammer( "hammer" );
+static const itype_id itype_nail( "nail" );
+
+static const quality_id qual_HAMMER( "HAMMER" );
+
+static item &add( inventory &inv, const item &it )
+{
+    return inv.add_item( it, false, false );
+}
+
+TEST_CASE( "inventory_stacks_items_of_the_same_type", "[inventory]" )
+{
+    clear_all_state();
+    inventory inv;
+    const item &first = add( inv, item( itype_2x4 ) );
+    add( inv, item( itype_hammer ) );
+    add( inv, item( itype_2x4 ) );
+    add( inv, item( itype_nail, calendar::turn, 10 ) );
+    add( inv, item( itype_nail, calendar::turn, 5 ) );
+
+    REQUIRE( inv.size() == 3 );
+    CHECK( inv.const_stack( 0 ).size() == 2 );
+    CHECK( &inv.const_stack( 0 ).front() == &first );
+    CHECK( inv.const_stack( 1 ).front().typeId() == itype_hammer );
+    CHECK( inv.const_stack( 2 ).size() == 1 );
+    CHECK( inv.const_stack( 2 ).front().charges == 15 );
+    CHECK( inv.position_by_type( itype_nail ) == 2 );
+
+    // Items keep their address while other stacks come and go
+    for( int i = 0; i < 100; i++ ) {
+        add( inv, item( itype_hammer ) );
+        add( inv, item( itype_2x4 ) );
+    }
+    inv.remove_item( 1 );
+    CHECK( &inv.find_item( 0 ) == &first );
+    CHECK( inv.count_item( itype_2x4 ) == 102 );
+    CHECK( inv.count_item( itype_hammer ) == 100 );
+}
+
+TEST_CASE( "inventory_stacks_items_that_changed_type", "[inventory]" )
+{
+    clear_all_state();
+    inventory inv;
+    add( inv, item( itype_2x4 ) );
+    add( inv, item( itype_nail, calendar::turn, 10 ) );
+
+    inv.visit_items( []( item * it ) {
+        if( it->typeId() == itype_2x4 ) {
+            it->convert( itype_hammer );
+        }
+        return VisitResponse::NEXT;
+    } );
+    add( inv, item( itype_hammer ) );
+    CHECK( inv.size() == 2 );
+    CHECK( inv.const_stack( 0 ).size() == 2 );
+    CHECK( inv.count_item( itype_hammer ) == 2 );
+}
+
+TEST_CASE( "inventory_copies_own_stacks", "[inventory]" )
+{
+    clear_all_state();
+    inventory inv;
+    add( inv, item( itype_2x4 ) );
+    CHECK( inv.count_item( itype_2x4 ) == 1 );
+
+    inventory copy = inv;
+    add( copy, item( itype_2x4 ) );
+    add( copy, item( itype_hammer ) );
+    CHECK( copy.size() == 2 );
+    CHECK( copy.count_item( itype_2x4 ) == 2 );
+    CHECK( inv.size() == 1 );
+    CHECK( inv.const_stack( 0 ).size() == 1 );
+    CHECK( inv.count_item( itype_2x4 ) == 1 );
+}
+
+TEST_CASE( "inventory_quality_cache_follows_items", "[inventory]" )
+{
+    clear_all_state();
+    inventory inv;
+    add( inv, item( itype_2x4 ) );
+    inv.update_quality_cache();
+    CHECK_FALSE( inv.has_quality( qual_HAMMER ) );
+
+    // Added items are counted without updating the cache again
+    item &hammer = add( inv, item( itype_hammer ) );
+    CHECK( inv.has_quality( qual_HAMMER ) );
+    CHECK( inv.get_quality_cache().count( qual_HAMMER ) == 1 );
+
+    inv.remove_item( &hammer );
+    CHECK_FALSE( inv.has_quality( qual_HAMMER ) );
+}
@@ -1,12 +1,17 @@
 #include "catch/catch.hpp"
 
+#include <chrono>
 #include <list>
 #include <sstream>
+#include <string_view>
 
 #include "bodypart.h"
 #include "json.h"
 #include "cached_options.h"
 #include "cata_utility.h"
+#include "filesystem.h"
+#include "item.h"
+#include "path_info.h"
 #include "string_formatter.h"
 #include "type_id.h"
 #include "colony.h"
@@ -253,6 +258,9 @@ static void test_get_string( const std::string &str, const std::string &json )
     std::istringstream iss( json );
     JsonIn jsin( iss );
     CHECK( jsin.get_string() == str );
+    const std::string_view data = json;
+    JsonIn jsin_memory( data );
+    CHECK( jsin_memory.get_string() == str );
 }
 
 template<typename Matcher>
@@ -262,6 +270,9 @@ static void test_get_string_throws_matches( Matcher &&matcher, const std::string
     std::istringstream iss( json );
     JsonIn jsin( iss );
     CHECK_THROWS_MATCHES( jsin.get_string(), JsonError, matcher );
+    const std::string_view data = json;
+    JsonIn jsin_memory( data );
+    CHECK_THROWS_MATCHES( jsin_memory.get_string(), JsonError, matcher );
 }
 
 template<typename Matcher>
@@ -462,3 +473,127 @@ TEST_CASE( "jsonin_get_string", "[json]" )
             R"(       ar")" "\n" ),
         R"("foo\nbar")", 5 );
 }
+
+// Copies the next value, so that what two readers see can be compared
+static void copy_json_value( JsonIn &jsin, JsonOut &jsout )
+{
+    if( jsin.test_object() ) {
+        jsin.start_object();
+        jsout.start_object();
+        while( !jsin.end_object() ) {
+            jsout.member( jsin.get_member_name() );
+            copy_json_value( jsin, jsout );
+        }
+        jsout.end_object();
+    } else if( jsin.test_array() ) {
+        jsin.start_array();
+        jsout.start_array();
+        while( !jsin.end_array() ) {
+            copy_json_value( jsin, jsout );
+        }
+        jsout.end_array();
+    } else if( jsin.test_string() ) {
+        jsout.write( jsin.get_string() );
+    } else if( jsin.test_bool() ) {
+        jsout.write( jsin.get_bool() );
+    } else if( jsin.test_null() ) {
+        jsin.skip_null();
+        jsout.write_null();
+    } else {
+        jsout.write( jsin.get_float() );
+    }
+}
+
+static std::string copy_json( JsonIn &jsin )
+{
+    try {
+        std::ostringstream os;
+        JsonOut jsout( os );
+        copy_json_value( jsin, jsout );
+        return os.str();
+    } catch( const JsonError &err ) {
+        return err.what();
+    }
+}
+
+TEST_CASE( "jsonin_reads_memory_like_a_stream", "[json]" )
+{
+    restore_on_out_of_scope<error_log_format_t> restore_error_log_format( error_log_format );
+    error_log_format = error_log_format_t::human_readable;
+
+    const std::string json = GENERATE( as<std::string>(),
+                                       R"({ "id": "a", "n": [ -1, 0.5, 2e3, 1E-2 ], "b": [ true, false, null ],)"
+                                       "\n"
+                                       R"(  "s": "plain \"quoted\" … …", "o": { "x": {}, "y": [] } })",
+                                       R"([ 1, 2 3 ])",
+                                       R"({ "a": "unterminated })",
+                                       R"({ "a": 1, })",
+                                       "[ 12" );
+    CAPTURE( json );
+    std::istringstream iss( json );
+    JsonIn jsin( iss );
+    const std::string_view data = json;
+    JsonIn jsin_memory( data );
+    CHECK( copy_json( jsin ) == copy_json( jsin_memory ) );
+}
+
+TEST_CASE( "jsonin_from_memory_seeks_to_members", "[json]" )
+{
+    const std::string json = R"({ "first": [ 1, 2, 3 ], "second": "text", "third": 7 })";
+    const std::string_view data = json;
+    JsonIn jsin( data );
+    JsonObject jo = jsin.get_object();
+    CHECK( jo.get_int( "third" ) == 7 );
+    CHECK( jo.get_string( "second" ) == "text" );
+    CHECK( jo.get_int_array( "first" ) == std::vector<int>( { 1, 2, 3 } ) );
+}
+
+static long long time_json_parsing( const std::vector<std::string> &documents, bool from_memory )
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+    for( const std::string &doc : documents ) {
+        if( from_memory ) {
+            JsonIn jsin( std::string_view( doc.data(), doc.size() ), std::string() );
+            jsin.skip_value();
+        } else {
+            std::istringstream iss( doc );
+            JsonIn jsin( iss );
+            jsin.skip_value();
+        }
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>( end - start ).count();
+}
+
+static void print_json_parsing_speed( const char *name, const std::vector<std::string> &documents )
+{
+    size_t bytes = 0;
+    for( const std::string &doc : documents ) {
+        bytes += doc.size();
+    }
+    cata_printf( "%s, %d files, %d kB: %lld ms from a stream, %lld ms from memory\n", name,
+                 static_cast<int>( documents.size() ), static_cast<int>( bytes / 1024 ),
+                 time_json_parsing( documents, false ), time_json_parsing( documents, true ) );
+}
+
+TEST_CASE( "json_parsing_speed", "[.]" )
+{
+    std::vector<std::string> data_files;
+    for( const std::string &path : get_files_from_path( ".json", PATH_INFO::datadir() + "json", true, true ) ) {
+        data_files.push_back( read_entire_file( path ) );
+    }
+    print_json_parsing_speed( "Game data", data_files );
+
+    // Stands in for a large save: lots of items with contents
+    std::ostringstream os;
+    JsonOut jsout( os );
+    jsout.start_array();
+    for( int i = 0; i < 20000; i++ ) {
+        item bag( itype_id( "backpack" ) );
+        bag.put_in( item( itype_id( "rock" ) ) );
+        bag.put_in( item( itype_id( "water_clean" ) ) );
+        bag.serialize( jsout );
+    }
+    jsout.end_array();
+    print_json_parsing_speed( "Serialized items", { os.str() } );
+}
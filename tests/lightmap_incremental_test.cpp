@@ -0,0 +1,173 @@
+#include "catch/catch.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "calendar.h"
+#include "game.h"
+#include "game_constants.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "point.h"
+#include "shadowcasting.h"
+#include "state_helpers.h"
+#include "string_formatter.h"
+#include "thread_pool.h"
+#include "type_id.h"
+#include "vehicle.h"
+
+// Night time floor with rows of walls, lamps between them and a car with its lights on
+static vehicle *build_lit_map()
+{
+    clear_all_state();
+    build_test_map( t_floor );
+    set_time( calendar::turn_zero );
+    map &here = get_map();
+    for( int x = 10; x < MAPSIZE_X - 10; x++ ) {
+        for( int y = 10; y < MAPSIZE_Y - 10; y++ ) {
+            const tripoint p( x, y, 0 );
+            if( x % 16 == 0 && y % 10 != 5 ) {
+                here.ter_set( p, t_wall );
+            } else if( x % 16 == 8 && y % 20 == 10 ) {
+                here.ter_set( p, t_utility_light );
+            }
+        }
+    }
+    g->place_player( tripoint( 60, 60, 0 ) );
+    vehicle *veh = here.add_vehicle( vproto_id( "car" ), tripoint( 40, 70, 0 ), 0_degrees, 0, 0 );
+    REQUIRE( veh != nullptr );
+    for( vehicle_part *pt : veh->lights() ) {
+        pt->enabled = true;
+    }
+    here.build_map_cache( 0 );
+    return veh;
+}
+
+struct lightmap_snapshot {
+    std::vector<four_quadrants> lm;
+    std::vector<float> sm;
+};
+
+static lightmap_snapshot take_snapshot()
+{
+    const level_cache &cache = get_map().access_cache( 0 );
+    return lightmap_snapshot {
+        std::vector<four_quadrants>( &cache.lm[0][0], &cache.lm[0][0] + MAPSIZE_X * MAPSIZE_Y ),
+        std::vector<float>( &cache.sm[0][0], &cache.sm[0][0] + MAPSIZE_X * MAPSIZE_Y )
+    };
+}
+
+static void check_snapshots_match( const lightmap_snapshot &expected,
+                                   const lightmap_snapshot &actual )
+{
+    int lm_mismatches = 0;
+    int sm_mismatches = 0;
+    for( size_t i = 0; i < expected.lm.size(); i++ ) {
+        if( expected.lm[i].values != actual.lm[i].values ) {
+            lm_mismatches++;
+        }
+        if( expected.sm[i] != actual.sm[i] ) {
+            sm_mismatches++;
+        }
+    }
+    CHECK( lm_mismatches == 0 );
+    CHECK( sm_mismatches == 0 );
+}
+
+static void check_matches_full_rebuild()
+{
+    map &here = get_map();
+    here.build_map_cache( 0 );
+    const lightmap_snapshot incremental = take_snapshot();
+    here.invalidate_lightmap_history();
+    here.build_map_cache( 0 );
+    check_snapshots_match( take_snapshot(), incremental );
+}
+
+TEST_CASE( "incremental_lightmap_matches_full_rebuild", "[lightmap]" )
+{
+    vehicle *veh = build_lit_map();
+    map &here = get_map();
+
+    SECTION( "nothing changed" ) {
+        check_matches_full_rebuild();
+    }
+    SECTION( "a lamp moved" ) {
+        here.ter_set( tripoint( 24, 30, 0 ), t_floor );
+        here.ter_set( tripoint( 27, 33, 0 ), t_utility_light );
+        check_matches_full_rebuild();
+    }
+    SECTION( "a wall next to a lamp went away" ) {
+        here.ter_set( tripoint( 32, 50, 0 ), t_floor );
+        here.ter_set( tripoint( 32, 55, 0 ), t_floor );
+        check_matches_full_rebuild();
+    }
+    SECTION( "the player walked" ) {
+        g->place_player( tripoint( 63, 58, 0 ) );
+        check_matches_full_rebuild();
+    }
+    SECTION( "the car drove" ) {
+        here.displace_vehicle( *veh, tripoint( 3, -1, 0 ) );
+        check_matches_full_rebuild();
+    }
+}
+
+TEST_CASE( "parallel_light_casts_match_serial", "[lightmap]" )
+{
+    build_lit_map();
+    map &here = get_map();
+    for( int x = 3; x < MAPSIZE_X; x += 6 ) {
+        for( int y = 3; y < MAPSIZE_Y; y += 5 ) {
+            here.ter_set( tripoint( x, y, 0 ), t_utility_light );
+        }
+    }
+    here.invalidate_lightmap_history();
+    here.build_map_cache( 0 );
+    const lightmap_snapshot parallel = take_snapshot();
+    {
+        cata::parallel_for_serial_scope serial;
+        here.invalidate_lightmap_history();
+        here.build_map_cache( 0 );
+    }
+    check_snapshots_match( take_snapshot(), parallel );
+}
+
+static long long time_lightmap_builds( const std::function<void( int )> &step, bool incremental )
+{
+    map &here = get_map();
+    const int iterations = 50;
+    const auto start = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < iterations; i++ ) {
+        step( i );
+        if( !incremental ) {
+            here.invalidate_lightmap_history();
+        }
+        here.build_map_cache( 0 );
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count() / iterations;
+}
+
+TEST_CASE( "incremental_lightmap_performance", "[.]" )
+{
+    vehicle *veh = build_lit_map();
+    map &here = get_map();
+
+    const auto stand = []( int ) {};
+    const auto walk = []( int i ) {
+        g->place_player( tripoint( 60 + i % 2, 60, 0 ) );
+    };
+    const auto drive = [&here, veh]( int i ) {
+        here.displace_vehicle( *veh, tripoint( i % 2 == 0 ? 1 : -1, 0, 0 ) );
+    };
+
+    cata_printf( "Standing still: full rebuild %lld us, incremental %lld us.\n",
+                 time_lightmap_builds( stand, false ), time_lightmap_builds( stand, true ) );
+    cata_printf( "Walking: full rebuild %lld us, incremental %lld us.\n",
+                 time_lightmap_builds( walk, false ), time_lightmap_builds( walk, true ) );
+    cata_printf( "Driving: full rebuild %lld us, incremental %lld us.\n",
+                 time_lightmap_builds( drive, false ), time_lightmap_builds( drive, true ) );
+}
@@ -0,0 +1,181 @@
+#include "catch/catch.hpp"
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "calendar.h"
+#include "coordinate_conversions.h"
+#include "filesystem.h"
+#include "fstream_utils.h"
+#include "game.h"
+#include "game_constants.h"
+#include "item.h"
+#include "map_segment_file.h"
+#include "mapdata.h"
+#include "point.h"
+#include "submap.h"
+#include "trap.h"
+#include "type_id.h"
+
+static std::unique_ptr<submap> make_test_submap( int seed )
+{
+    std::unique_ptr<submap> sm = std::make_unique<submap>();
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const point p( i, j );
+            sm->set_ter( p, ( i + seed ) % 5 == 0 || j == 0 ? t_wall : t_floor );
+            sm->set_radiation( p, j > 8 ? seed + i / 4 : 0 );
+        }
+    }
+    sm->set_furn( point( 3 + seed, 4 ), f_chair );
+    sm->set_furn( point( 4 + seed, 4 ), f_table );
+    sm->set_trap( point( 7, 2 + seed ), trap_str_id( "tr_beartrap" ).id() );
+    sm->get_items( point( 5, 5 ) ).insert( item( "rock" ) );
+    sm->get_items( point( 5, 5 ) ).insert( item( "stick" ) );
+    sm->get_items( point( 10, 1 + seed ) ).insert( item( "rock" ) );
+    sm->set_temperature( 40 + seed );
+    sm->last_touched = calendar::turn_zero + time_duration::from_turns( 100 * seed );
+    return sm;
+}
+
+static void check_submaps_match( const submap &expected, const submap &actual )
+{
+    int layer_mismatches = 0;
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const point p( i, j );
+            if( expected.get_ter( p ) != actual.get_ter( p ) ||
+                expected.get_furn( p ) != actual.get_furn( p ) ||
+                expected.get_trap( p ) != actual.get_trap( p ) ||
+                expected.get_radiation( p ) != actual.get_radiation( p ) ) {
+                layer_mismatches++;
+            }
+            const cata::colony<item> &expected_items = expected.get_items( p );
+            const cata::colony<item> &actual_items = actual.get_items( p );
+            REQUIRE( expected_items.size() == actual_items.size() );
+            auto actual_it = actual_items.begin();
+            for( const item &it : expected_items ) {
+                CHECK( it.typeId() == actual_it->typeId() );
+                ++actual_it;
+            }
+        }
+    }
+    CHECK( layer_mismatches == 0 );
+    CHECK( expected.get_temperature() == actual.get_temperature() );
+    CHECK( expected.last_touched == actual.last_touched );
+}
+
+static std::vector<std::pair<tripoint, const submap *>> quad_of(
+            const std::vector<std::unique_ptr<submap>> &submaps, const tripoint &origin )
+{
+    std::vector<std::pair<tripoint, const submap *>> quad;
+    const std::vector<point> offsets = { point_zero, point_south, point_east, point_south_east };
+    for( size_t i = 0; i < submaps.size(); i++ ) {
+        quad.emplace_back( origin + offsets[i], submaps[i].get() );
+    }
+    return quad;
+}
+
+TEST_CASE( "map_segment_quad_round_trip", "[mapbuffer]" )
+{
+    std::vector<std::unique_ptr<submap>> submaps;
+    for( int seed = 0; seed < 4; seed++ ) {
+        submaps.push_back( make_test_submap( seed ) );
+    }
+    const tripoint origin( -6, 14, -1 );
+    const std::string data = map_segment_file::encode_quad( quad_of( submaps, origin ) );
+    const map_quad_submaps decoded = map_segment_file::decode_quad( data );
+    REQUIRE( decoded.size() == submaps.size() );
+    const std::vector<std::pair<tripoint, const submap *>> quad = quad_of( submaps, origin );
+    for( size_t i = 0; i < submaps.size(); i++ ) {
+        CAPTURE( i );
+        CHECK( decoded[i].first == quad[i].first );
+        check_submaps_match( *submaps[i], *decoded[i].second );
+    }
+
+    SECTION( "damaged data is rejected" ) {
+        CHECK_THROWS( map_segment_file::decode_quad( data.substr( 0, data.size() / 2 ) ) );
+        CHECK_THROWS( map_segment_file::decode_quad( data + "x" ) );
+    }
+}
+
+TEST_CASE( "map_segment_file_updates", "[mapbuffer]" )
+{
+    const std::string path = g->get_world_base_save_path() + "/segment_test_" + get_pid_string() +
+                             ".seg";
+    REQUIRE( assure_dir_exist( g->get_world_base_save_path() ) );
+    REQUIRE( !file_exist( path ) );
+
+    std::vector<std::unique_ptr<submap>> first;
+    first.push_back( make_test_submap( 1 ) );
+    std::vector<std::unique_ptr<submap>> second;
+    second.push_back( make_test_submap( 2 ) );
+    second.push_back( make_test_submap( 3 ) );
+    const tripoint first_addr( 3, 4, 0 );
+    const tripoint second_addr( 5, 4, 0 );
+
+    map_segment_changes changes;
+    changes.quads[first_addr] = map_segment_file::encode_quad( quad_of( first,
+                                omt_to_sm_copy( first_addr ) ) );
+    changes.quads[second_addr] = map_segment_file::encode_quad( quad_of( second,
+                                 omt_to_sm_copy( second_addr ) ) );
+    map_segment_file( path ).update( changes );
+    REQUIRE( file_exist( path ) );
+
+    // A fresh instance only knows what is on disk
+    map_segment_file segment( path );
+    CHECK( segment.quads() == std::vector<tripoint> { first_addr, second_addr } );
+    CHECK_FALSE( segment.has_quad( tripoint( 4, 4, 0 ) ) );
+    map_quad_submaps loaded = segment.read_quad( second_addr );
+    REQUIRE( loaded.size() == 2 );
+    check_submaps_match( *second[1], *loaded[1].second );
+
+    map_segment_changes removal;
+    removal.removed.insert( second_addr );
+    segment.update( removal );
+    CHECK( map_segment_file( path ).quads() == std::vector<tripoint> { first_addr } );
+    loaded = map_segment_file( path ).read_quad( first_addr );
+    REQUIRE( loaded.size() == 1 );
+    check_submaps_match( *first[0], *loaded[0].second );
+
+    removal.removed.insert( first_addr );
+    segment.update( removal );
+    CHECK_FALSE( file_exist( path ) );
+}
+
+TEST_CASE( "map_segment_file_keeps_a_file_with_a_damaged_index", "[mapbuffer]" )
+{
+    const std::string path = g->get_world_base_save_path() + "/segment_damaged_test_" +
+                             get_pid_string() + ".seg";
+    REQUIRE( assure_dir_exist( g->get_world_base_save_path() ) );
+
+    std::vector<std::unique_ptr<submap>> quad;
+    quad.push_back( make_test_submap( 1 ) );
+    const tripoint addr( 3, 4, 0 );
+    map_segment_changes changes;
+    changes.quads[addr] = map_segment_file::encode_quad( quad_of( quad, omt_to_sm_copy( addr ) ) );
+    map_segment_file( path ).update( changes );
+    const std::string saved = read_entire_file( path );
+    REQUIRE( saved.size() > 16 );
+
+    // Header claiming more quads than the index holds
+    std::string damaged = saved.substr( 0, 16 );
+    damaged[8] = 2;
+    REQUIRE( write_to_file( path, [&damaged]( std::ostream & fout ) {
+        fout.write( damaged.data(), damaged.size() );
+    }, nullptr ) );
+
+    map_segment_file segment( path );
+    CHECK_THROWS( segment.has_quad( addr ) );
+    // The failed read must not leave an empty index behind
+    CHECK_THROWS( segment.has_quad( addr ) );
+    map_segment_changes other;
+    other.quads[tripoint( 5, 4, 0 )] = changes.quads[addr];
+    CHECK_THROWS( segment.update( other ) );
+    CHECK( read_entire_file( path ) == damaged );
+
+    remove_file( path );
+}
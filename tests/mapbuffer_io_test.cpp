@@ -0,0 +1,174 @@
+#include "catch/catch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "avatar.h"
+#include "cata_utility.h"
+#include "coordinate_conversions.h"
+#include "game.h"
+#include "game_constants.h"
+#include "map.h"
+#include "mapbuffer.h"
+#include "mapdata.h"
+#include "options_helpers.h"
+#include "point.h"
+#include "state_helpers.h"
+#include "string_formatter.h"
+#include "submap.h"
+#include "type_id.h"
+#include "units.h"
+#include "vehicle.h"
+
+// Far away from the test map, so the quad is never part of it
+static const tripoint test_om_addr( 300, 300, 0 );
+
+static void fill_test_quad( mapbuffer &buffer, const ter_id &ter )
+{
+    const tripoint origin = omt_to_sm_copy( test_om_addr );
+    for( point offset : { point_zero, point_south, point_east, point_south_east } ) {
+        std::unique_ptr<submap> sm = std::make_unique<submap>();
+        for( int j = 0; j < SEEY; j++ ) {
+            for( int i = 0; i < SEEX; i++ ) {
+                sm->set_ter( point( i, j ), ter );
+            }
+        }
+        sm->set_furn( point( 3, 3 ), f_chair );
+        REQUIRE( buffer.add_submap( origin + offset, sm ) );
+    }
+}
+
+static void check_test_quad( mapbuffer &buffer, const ter_id &ter )
+{
+    submap *sm = buffer.lookup_submap( omt_to_sm_copy( test_om_addr ) + point_south_east );
+    REQUIRE( sm != nullptr );
+    CHECK( sm->get_ter( point( 5, 5 ) ) == ter );
+    CHECK( sm->get_furn( point( 3, 3 ) ) == f_chair );
+}
+
+// Puts the test quad just past the eastern edge of a map moving east
+static void prefetch_test_quad( mapbuffer &buffer )
+{
+    const tripoint quad_sm = omt_to_sm_copy( test_om_addr );
+    buffer.prefetch_ahead( quad_sm - point( MAPSIZE, 2 ), point_east, 2, 0, 0 );
+    buffer.wait_for_io();
+}
+
+TEST_CASE( "mapbuffer_saves_and_loads_in_the_background", "[mapbuffer]" )
+{
+    const bool binary = GENERATE( false, true );
+    CAPTURE( binary );
+    override_option saves_format( "BINARY_MAP_SAVES", binary ? "true" : "false" );
+    // Maps are not saved while mapgen is disabled for tests
+    restore_on_out_of_scope<bool> restore_mapgen( disable_mapgen );
+    disable_mapgen = false;
+    mapbuffer buffer;
+    fill_test_quad( buffer, t_wall );
+    buffer.save( true );
+    REQUIRE_FALSE( buffer.is_submap_loaded( omt_to_sm_copy( test_om_addr ) ) );
+
+    SECTION( "a load waits for the queued save" ) {
+        check_test_quad( buffer, t_wall );
+    }
+    SECTION( "a quad read ahead is loaded from memory" ) {
+        prefetch_test_quad( buffer );
+        CHECK( buffer.is_prefetched( test_om_addr ) );
+        check_test_quad( buffer, t_wall );
+        CHECK_FALSE( buffer.is_prefetched( test_om_addr ) );
+    }
+    SECTION( "a newer save replaces a quad read ahead" ) {
+        prefetch_test_quad( buffer );
+        REQUIRE( buffer.is_prefetched( test_om_addr ) );
+        fill_test_quad( buffer, t_floor );
+        buffer.save( true );
+        CHECK_FALSE( buffer.is_prefetched( test_om_addr ) );
+        check_test_quad( buffer, t_floor );
+    }
+    buffer.wait_for_io();
+}
+
+namespace
+{
+
+struct latency_histogram {
+    // Upper bounds of the buckets in microseconds, the last bucket has none
+    static constexpr std::array<long long, 6> bounds = {{ 1000, 2000, 4000, 8000, 16000, 32000 }};
+    std::array<int, bounds.size() + 1> counts = {};
+    long long total = 0;
+    long long worst = 0;
+
+    void add( long long us ) {
+        size_t bucket = 0;
+        while( bucket < bounds.size() && us >= bounds[bucket] ) {
+            bucket++;
+        }
+        counts[bucket]++;
+        total += us;
+        worst = std::max( worst, us );
+    }
+
+    void print( const char *name ) const {
+        int samples = 0;
+        std::string line;
+        for( size_t i = 0; i < counts.size(); i++ ) {
+            samples += counts[i];
+            line += i < bounds.size() ? string_format( " <%lldms: %d", bounds[i] / 1000, counts[i] ) :
+                    string_format( " more: %d", counts[i] );
+        }
+        cata_printf( "%s: %d shifts, mean %lld us, worst %lld us\n %s\n", name, samples,
+                     samples ? total / samples : 0, worst, line );
+    }
+};
+
+} // namespace
+
+// Drives the car a submap at a time, timing each map shift it causes
+static latency_histogram drive_submaps( vehicle &veh, point direction, int count )
+{
+    map &here = get_map();
+    latency_histogram histogram;
+    for( int i = 0; i < count; i++ ) {
+        here.displace_vehicle( veh, tripoint( direction.x * SEEX, direction.y * SEEY, 0 ) );
+        const auto start = std::chrono::high_resolution_clock::now();
+        g->update_map( g->u );
+        const auto end = std::chrono::high_resolution_clock::now();
+        histogram.add( std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count() );
+        // Stands in for the rest of a turn at highway speed
+        std::this_thread::sleep_for( std::chrono::milliseconds( 30 ) );
+    }
+    return histogram;
+}
+
+TEST_CASE( "map_shift_latency_while_driving", "[.]" )
+{
+    clear_all_state();
+    restore_on_out_of_scope<bool> restore_mapgen( disable_mapgen );
+    disable_mapgen = false;
+    map &here = get_map();
+    const tripoint start( 60, 60, 0 );
+    g->place_player( start );
+    vehicle *veh = here.add_vehicle( vproto_id( "car" ), start, 0_degrees, 0, 0 );
+    REQUIRE( veh != nullptr );
+    here.board_vehicle( start, &g->u );
+    REQUIRE( g->u.in_vehicle );
+    veh->velocity = 7000;
+    veh->cruise_velocity = 7000;
+
+    const int distance = 40;
+    // Generate the road ahead and put it on disk
+    drive_submaps( *veh, point_west, distance );
+    MAPBUFFER.save();
+    MAPBUFFER.wait_for_io();
+
+    MAPBUFFER.prefetch_enabled = false;
+    drive_submaps( *veh, point_east, distance ).print( "Loading on demand" );
+    MAPBUFFER.save();
+    MAPBUFFER.wait_for_io();
+
+    MAPBUFFER.prefetch_enabled = true;
+    drive_submaps( *veh, point_west, distance ).print( "Reading ahead" );
+}
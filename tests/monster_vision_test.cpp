@@ -3,7 +3,9 @@
 #include <memory>
 
 #include "calendar.h"
+#include "fov_bitmap.h"
 #include "game.h"
+#include "line.h"
 #include "map.h"
 #include "map_helpers.h"
 #include "mapdata.h"
@@ -102,3 +104,107 @@ TEST_CASE( "monsters_dont_see_through_vehicle_holes", "[vision]" )
     CHECK( !outside.sees( inside ) );
 
 }
+
+TEST_CASE( "monster_vision_bitmap_agrees_with_line_of_sight", "[vision]" )
+{
+    clear_all_state();
+    calendar::turn = midday;
+    put_player_underground();
+    map &here = get_map();
+    const tripoint origin( 60, 60, 0 );
+    // Two long walls and a block
+    for( int x = 50; x <= 70; x++ ) {
+        here.ter_set( tripoint( x, 70, 0 ), t_wall );
+    }
+    for( int y = 40; y <= 55; y++ ) {
+        here.ter_set( tripoint( 45, y, 0 ), t_wall );
+    }
+    for( int x = 70; x <= 72; x++ ) {
+        for( int y = 48; y <= 50; y++ ) {
+            here.ter_set( tripoint( x, y, 0 ), t_wall );
+        }
+    }
+    here.build_map_cache( 0 );
+
+    fov_bitmap fov;
+    CHECK( here.update_fov_bitmap( fov, origin ) );
+    CHECK_FALSE( here.update_fov_bitmap( fov, origin ) );
+
+    // Shadowcasting and Bresenham lines only disagree at the edges of shadows
+    int agree = 0;
+    int total = 0;
+    for( int x = origin.x - 30; x <= origin.x + 30; x++ ) {
+        for( int y = origin.y - 30; y <= origin.y + 30; y++ ) {
+            const tripoint p( x, y, 0 );
+            total++;
+            if( fov.test( p ) == here.sees( origin, p, -1 ) ) {
+                agree++;
+            }
+        }
+    }
+    CAPTURE( agree, total );
+    CHECK( agree >= total * 0.9 );
+    // Right behind the wall, and in the open
+    const tripoint behind_wall( 62, 73, 0 );
+    CHECK_FALSE( fov.test( behind_wall ) );
+    CHECK_FALSE( here.sees( origin, behind_wall, -1 ) );
+    CHECK( fov.test( origin + tripoint_north ) );
+    CHECK( fov.test( origin ) );
+    CHECK( here.is_fov_bitmap_current( fov ) );
+
+    // Changing the map nearby makes the view stale, even before the caches are rebuilt
+    for( int x = 61; x <= 63; x++ ) {
+        here.ter_set( tripoint( x, 70, 0 ), t_floor );
+    }
+    CHECK_FALSE( here.is_fov_bitmap_current( fov ) );
+    here.build_map_cache( 0 );
+    CHECK( here.update_fov_bitmap( fov, origin ) );
+    CHECK( here.is_fov_bitmap_current( fov ) );
+    CHECK( fov.test( behind_wall ) );
+    // Moving does as well
+    CHECK( here.update_fov_bitmap( fov, origin + tripoint_east ) );
+    CHECK( fov.origin == origin + tripoint_east );
+}
+
+TEST_CASE( "monsters_with_vision_bitmaps_dont_see_through_vehicle_holes", "[vision]" )
+{
+    clear_all_state();
+    calendar::turn = midday;
+    put_player_underground();
+    tripoint origin( 60, 60, 0 );
+
+    get_map().add_vehicle( vproto_id( "apc" ), origin, -45_degrees, 0, 0 );
+    get_map().build_map_cache( 0 );
+
+    monster &inside = spawn_test_monster( "mon_zombie", origin + tripoint( -2, 1, 0 ) );
+    monster &outside = spawn_test_monster( "mon_zombie", inside.pos() + tripoint_north_west );
+    inside.update_vision_bitmap();
+    outside.update_vision_bitmap();
+
+    CHECK( !inside.sees( outside ) );
+    CHECK( !outside.sees( inside ) );
+}
+
+TEST_CASE( "monsters_with_vision_bitmaps_see_through_doors_opened_this_turn", "[vision]" )
+{
+    clear_all_state();
+    set_time( midday );
+    map &here = get_map();
+    for( int y = 53; y <= 63; y++ ) {
+        here.ter_set( tripoint( 62, y, 0 ), t_wall );
+    }
+    const tripoint door( 62, 58, 0 );
+    here.ter_set( door, t_door_c );
+    here.build_map_cache( 0 );
+
+    monster &watcher = spawn_test_monster( "mon_zombie", tripoint( 60, 58, 0 ) );
+    monster &target = spawn_test_monster( "mon_zombie", tripoint( 64, 58, 0 ) );
+    watcher.update_vision_bitmap();
+    CHECK_FALSE( watcher.sees( target ) );
+
+    // Until the caches are rebuilt the door is as opaque as it was for line of sight too
+    REQUIRE( here.open_door( door, false ) );
+    CHECK( watcher.sees( target ) == here.sees( watcher.pos(), target.pos(), -1 ) );
+    here.build_map_cache( 0 );
+    CHECK( watcher.sees( target ) );
+}
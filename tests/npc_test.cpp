@@ -1,5 +1,6 @@
 #include "catch/catch.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <set>
@@ -18,8 +19,10 @@
 #include "map.h"
 #include "map_helpers.h"
 #include "memory_fast.h"
+#include "monster.h"
 #include "npc.h"
 #include "npc_class.h"
+#include "npc_threat_field.h"
 #include "numeric_interval.h"
 #include "overmapbuffer.h"
 #include "pimpl.h"
@@ -489,3 +492,51 @@ TEST_CASE( "npc_move_through_vehicle_holes" )
     CHECK( m2 == nullptr );
 
 }
+
+TEST_CASE( "npc_threat_field_fires", "[npc]" )
+{
+    clear_all_state();
+    map &here = get_map();
+    const tripoint center( 60, 60, 0 );
+    here.add_field( center, fd_fire, 1 );
+    here.add_field( center + point( 2, -1 ), fd_fire, 1 );
+    here.add_field( center + point( -6, 6 ), fd_fire, 1 );
+    here.add_field( center + point( 7, 0 ), fd_fire, 1 );
+    here.add_field( center + point( 1, 1 ), fd_acid, 1 );
+
+    npc_threat_field field;
+    field.build( here );
+    std::vector<tripoint> fires = field.fires_near( center, 6 );
+    std::sort( fires.begin(), fires.end() );
+    std::vector<tripoint> expected = { center + point( -6, 6 ), center + point( 2, -1 ) };
+    std::sort( expected.begin(), expected.end() );
+    CHECK( fires == expected );
+    CHECK( field.fires_near( center + tripoint_above, 6 ).empty() );
+
+    field.clear();
+    CHECK( !field.is_built() );
+    CHECK( field.fires_near( center, 6 ).empty() );
+}
+
+TEST_CASE( "npc_threat_field_skips_removed_monsters", "[npc]" )
+{
+    clear_all_state();
+    set_time( calendar::turn_zero + 12_hours );
+    const tripoint center( 60, 60, 0 );
+    npc &guy = spawn_npc( center.xy(), "thug" );
+    guy.recalc_sight_limits();
+    guy.assess_danger();
+    const float alone = guy.danger_assessment();
+    monster &zombie = spawn_test_monster( "mon_zombie", center + point( 3, 0 ) );
+    guy.assess_danger();
+    // A lone zombie is low danger, which still moves the assessment off the empty one
+    CHECK( guy.danger_assessment() != alone );
+
+    // Removed without dying, like monsters shut down by an EMP
+    npc_threat_field &field = get_npc_threat_field();
+    field.build( get_map() );
+    g->remove_zombie( zombie );
+    guy.assess_danger();
+    CHECK( guy.danger_assessment() == alone );
+    field.clear();
+}
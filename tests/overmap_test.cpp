@@ -1,12 +1,16 @@
 #include "catch/catch.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "calendar.h"
+#include "coordinates.h"
 #include "enums.h"
 #include "game_constants.h"
+#include "line.h"
 #include "numeric_interval.h"
 #include "omdata.h"
 #include "overmap.h"
@@ -15,6 +19,7 @@
 #include "overmapbuffer.h"
 #include "point.h"
 #include "state_helpers.h"
+#include "string_formatter.h"
 #include "type_id.h"
 
 TEST_CASE( "set_and_get_overmap_scents" )
@@ -217,3 +222,82 @@ TEST_CASE( "is_ot_match", "[overmap][terrain]" )
         CHECK_FALSE( is_ot_match( "forestry", oter_id( "forest" ), ot_match_type::contains ) );
     }
 }
+
+// What overmapbuffer::find_all returns, found by checking every location
+static std::vector<tripoint_abs_omt> find_all_by_checking_everything(
+    const tripoint_abs_omt &origin, const std::string &type, int min_dist, int max_dist )
+{
+    std::vector<tripoint_abs_omt> result;
+    for( const tripoint_abs_omt &loc : closest_points_first( origin, min_dist, max_dist ) ) {
+        if( overmap_buffer.check_ot( type, ot_match_type::type, loc ) ) {
+            result.push_back( loc );
+        }
+    }
+    return result;
+}
+
+TEST_CASE( "terrain_searches_match_checking_every_location", "[overmap]" )
+{
+    clear_all_state();
+    const tripoint_abs_omt origin( 90, 90, 0 );
+    const std::string type = GENERATE( "road", "house", "forest_water" );
+    const int min_dist = GENERATE( 0, 7 );
+    CAPTURE( type, min_dist );
+
+    omt_find_params params;
+    params.types = {{ type, ot_match_type::type }};
+    params.min_distance = min_dist;
+    params.search_range = 60;
+    const std::vector<tripoint_abs_omt> expected = find_all_by_checking_everything( origin, type,
+            min_dist, 60 );
+    CHECK( overmap_buffer.find_all( origin, params ) == expected );
+
+    const tripoint_abs_omt closest = overmap_buffer.find_closest( origin, params );
+    if( expected.empty() ) {
+        CHECK( closest == overmap::invalid_tripoint );
+    } else {
+        REQUIRE( closest != overmap::invalid_tripoint );
+        CHECK( overmap_buffer.check_ot( type, ot_match_type::type, closest ) );
+        CHECK( square_dist( origin, closest ) == square_dist( origin, expected.front() ) );
+    }
+}
+
+TEST_CASE( "terrain_searches_see_changed_terrain", "[overmap]" )
+{
+    clear_all_state();
+    const tripoint_abs_omt origin( 90, 90, 0 );
+    omt_find_params params;
+    params.types = {{ "central_lab_finale", ot_match_type::type }};
+    params.search_range = 40;
+    params.existing_only = true;
+    overmap_buffer.get( point_abs_om() );
+    const std::vector<tripoint_abs_omt> before = overmap_buffer.find_all( origin, params );
+
+    const tripoint_abs_omt changed = origin + point( 20, -13 );
+    overmap_buffer.ter_set( changed, oter_id( "central_lab_finale" ) );
+    const std::vector<tripoint_abs_omt> after = overmap_buffer.find_all( origin, params );
+    CHECK( after.size() == before.size() + 1 );
+    CHECK( std::find( after.begin(), after.end(), changed ) != after.end() );
+    CHECK( square_dist( origin, overmap_buffer.find_closest( origin, params ) ) <=
+           square_dist( origin, changed ) );
+}
+
+TEST_CASE( "terrain_search_speed", "[.]" )
+{
+    clear_all_state();
+    const tripoint_abs_omt origin( 90, 90, 0 );
+    omt_find_params params;
+    params.types = {{ "house", ot_match_type::type }};
+    params.search_range = OMAPX;
+    // The first search also generates the overmaps
+    overmap_buffer.find_all( origin, params );
+
+    const int searches = 20;
+    const auto start = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < searches; i++ ) {
+        overmap_buffer.find_all( origin + point( i, 0 ), params );
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    const long long us = std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count();
+    cata_printf( "find_all of houses within %d: %lld us per search\n", OMAPX, us / searches );
+}
@@ -0,0 +1,306 @@
+#include "catch/catch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "game_constants.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "pathfinding.h"
+#include "point.h"
+#include "state_helpers.h"
+#include "string_formatter.h"
+
+// Rows of walls with occasional gaps and scattered tables, so that most
+// routes have to go around something instead of taking the straight line.
+static void build_cluttered_map()
+{
+    clear_map();
+    map &here = get_map();
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            const tripoint p( x, y, 0 );
+            if( x % 8 == 4 && y % 12 != 6 ) {
+                here.ter_set( p, t_wall );
+            } else if( ( x * 7 + y * 13 ) % 17 == 0 ) {
+                here.furn_set( p, f_table );
+            }
+        }
+    }
+    here.invalidate_map_cache( 0 );
+    here.build_map_cache( 0, true );
+}
+
+// Surrounds the area between the corners with a wall, sealing it off
+static void build_sealed_room( const point &min, const point &max )
+{
+    map &here = get_map();
+    for( int x = min.x; x <= max.x; x++ ) {
+        for( int y = min.y; y <= max.y; y++ ) {
+            if( x == min.x || x == max.x || y == min.y || y == max.y ) {
+                here.ter_set( tripoint( x, y, 0 ), t_wall );
+            }
+        }
+    }
+    here.invalidate_map_cache( 0 );
+    here.build_map_cache( 0, true );
+}
+
+static const std::vector<std::pair<tripoint, tripoint>> &test_routes()
+{
+    static const std::vector<std::pair<tripoint, tripoint>> routes = {
+        { tripoint( 61, 59, 0 ), tripoint( 75, 70, 0 ) },
+        { tripoint( 30, 40, 0 ), tripoint( 90, 45, 0 ) },
+        { tripoint( 50, 20, 0 ), tripoint( 53, 100, 0 ) },
+        { tripoint( 101, 90, 0 ), tripoint( 41, 70, 0 ) },
+        { tripoint( 66, 30, 0 ), tripoint( 67, 90, 0 ) },
+    };
+    return routes;
+}
+
+static pathfinding_settings test_settings()
+{
+    return pathfinding_settings( 0, 100, 1000, 0, true, true, true, false, true );
+}
+
+// Walls can't be bashed, opened or climbed, which lets the submap graph rule out routes
+static pathfinding_settings walls_block_settings()
+{
+    return pathfinding_settings( 0, 100, 1000, 0, false, false, true, false, false );
+}
+
+// Tile-level flood fill with the same notion of walkable tiles as pathfinding_graph
+static bool flood_fill_reaches( const pathfinding_cache &cache, const point &from, const point &to )
+{
+    const auto walkable = [&cache]( const point & p ) {
+        return !( cache.special[p.x][p.y] & PF_WALL ) || ( cache.special[p.x][p.y] & PF_VEHICLE );
+    };
+    std::set<point> visited = { from };
+    std::vector<point> todo = { from };
+    while( !todo.empty() ) {
+        const point cur = todo.back();
+        todo.pop_back();
+        for( const point &offset : eight_adjacent_offsets ) {
+            const point next = cur + offset;
+            if( next.x < 0 || next.x >= MAPSIZE_X || next.y < 0 || next.y >= MAPSIZE_Y ||
+                !walkable( next ) || !visited.insert( next ).second ) {
+                continue;
+            }
+            if( next == to ) {
+                return true;
+            }
+            todo.push_back( next );
+        }
+    }
+    return false;
+}
+
+static void check_route_is_walkable( const tripoint &from, const std::vector<tripoint> &route )
+{
+    const map &here = get_map();
+    tripoint prev = from;
+    for( const tripoint &p : route ) {
+        CHECK( rl_dist( prev, p ) == 1 );
+        CHECK( here.passable( p ) );
+        prev = p;
+    }
+}
+
+TEST_CASE( "route_around_obstacles", "[pathfinding]" )
+{
+    clear_all_state();
+    build_cluttered_map();
+    const map &here = get_map();
+
+    for( const std::pair<tripoint, tripoint> &r : test_routes() ) {
+        CAPTURE( r.first, r.second );
+        const std::vector<tripoint> route = here.route( r.first, r.second, test_settings() );
+        REQUIRE( !route.empty() );
+        CHECK( route.back() == r.second );
+        check_route_is_walkable( r.first, route );
+    }
+}
+
+TEST_CASE( "route_is_unaffected_by_previous_searches", "[pathfinding]" )
+{
+    clear_all_state();
+    build_cluttered_map();
+    const map &here = get_map();
+
+    std::vector<std::vector<tripoint>> first_pass;
+    for( const std::pair<tripoint, tripoint> &r : test_routes() ) {
+        first_pass.push_back( here.route( r.first, r.second, test_settings() ) );
+    }
+
+    // Searches that leave closed and expensive tiles behind in the shared search state
+    const std::set<tripoint> pre_closed = { tripoint( 62, 61, 0 ), tripoint( 63, 62, 0 ) };
+    here.route( tripoint( 61, 59, 0 ), tripoint( 120, 120, 0 ), test_settings(), pre_closed );
+    here.route( tripoint( 10, 10, 0 ), tripoint( 10, 10, 0 ), test_settings() );
+    here.route( tripoint( 21, 100, 0 ), tripoint( 110, 15, 0 ), test_settings() );
+
+    for( size_t i = 0; i < test_routes().size(); i++ ) {
+        const std::pair<tripoint, tripoint> &r = test_routes()[i];
+        CAPTURE( r.first, r.second );
+        CHECK( here.route( r.first, r.second, test_settings() ) == first_pass[i] );
+    }
+}
+
+TEST_CASE( "pathfinding_graph_matches_flood_fill", "[pathfinding]" )
+{
+    clear_all_state();
+    build_cluttered_map();
+    build_sealed_room( point( 92, 18 ), point( 100, 30 ) );
+    const map &here = get_map();
+
+    const pathfinding_cache &cache = here.get_pathfinding_cache_ref( 0 );
+    const pathfinding_graph &graph = here.get_pathfinding_graph_ref( 0 );
+    const std::vector<point> points = {
+        point( 61, 59 ), point( 75, 70 ), point( 30, 40 ), point( 95, 24 ), point( 98, 28 ),
+        point( 93, 19 ), point( 110, 15 ), point( 1, 1 ), point( 130, 130 ), point( 52, 6 )
+    };
+    for( const point &from : points ) {
+        for( const point &to : points ) {
+            if( from == to ) {
+                continue;
+            }
+            CAPTURE( from, to );
+            CHECK( graph.may_reach( from, to, false ) == flood_fill_reaches( cache, from, to ) );
+        }
+    }
+}
+
+TEST_CASE( "route_into_sealed_room", "[pathfinding]" )
+{
+    clear_all_state();
+    build_cluttered_map();
+    build_sealed_room( point( 92, 18 ), point( 100, 30 ) );
+    const map &here = get_map();
+
+    const tripoint outside( 75, 20, 0 );
+    const tripoint inside( 95, 24, 0 );
+    const tripoint inside_corner( 98, 28, 0 );
+
+    CHECK( here.route( outside, inside, walls_block_settings() ).empty() );
+    CHECK( here.route( inside, outside, walls_block_settings() ).empty() );
+    CHECK( here.route( outside, inside, test_settings() ).empty() );
+
+    const std::vector<tripoint> route = here.route( inside, inside_corner, walls_block_settings() );
+    REQUIRE( !route.empty() );
+    CHECK( route.back() == inside_corner );
+    check_route_is_walkable( inside, route );
+
+    // Routes that stay connected are unaffected by the graph
+    for( const std::pair<tripoint, tripoint> &r : test_routes() ) {
+        CAPTURE( r.first, r.second );
+        const std::vector<tripoint> route = here.route( r.first, r.second, walls_block_settings() );
+        CHECK( !route.empty() );
+        check_route_is_walkable( r.first, route );
+    }
+}
+
+TEST_CASE( "route_shared_reads_from_flow_field", "[pathfinding]" )
+{
+    clear_all_state();
+    build_cluttered_map();
+    map &here = get_map();
+    here.reset_flow_field_stats();
+
+    const tripoint target( 66, 66, 0 );
+    const std::vector<tripoint> starts = {
+        tripoint( 50, 60, 0 ), tripoint( 70, 80, 0 ), tripoint( 80, 55, 0 ), tripoint( 61, 59, 0 ),
+        tripoint( 75, 70, 0 )
+    };
+    for( const tripoint &start : starts ) {
+        CAPTURE( start );
+        const std::vector<tripoint> shared = here.route_shared( start, target, test_settings() );
+        const std::vector<tripoint> direct = here.route( start, target, test_settings() );
+        REQUIRE( shared.empty() == direct.empty() );
+        if( !shared.empty() ) {
+            CHECK( shared.back() == target );
+            check_route_is_walkable( start, shared );
+        }
+    }
+
+    // The first request searches on its own, the second one builds the field
+    CHECK( here.get_flow_field_stats().route_calls == 1 );
+    CHECK( here.get_flow_field_stats().fields_built == 1 );
+    CHECK( here.get_flow_field_stats().field_hits == static_cast<int>( starts.size() ) - 1 );
+
+    // Changing terrain makes the field stale
+    here.ter_set( tripoint( 67, 67, 0 ), t_wall );
+    const std::vector<tripoint> after_change = here.route_shared( starts[0], target, test_settings() );
+    CHECK( here.get_flow_field_stats().fields_built == 2 );
+    CHECK( std::find( after_change.begin(), after_change.end(),
+                      tripoint( 67, 67, 0 ) ) == after_change.end() );
+}
+
+TEST_CASE( "route_performance", "[.]" )
+{
+    clear_all_state();
+    build_cluttered_map();
+    const map &here = get_map();
+
+    const int iterations = 200;
+    int routes = 0;
+    const auto start = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < iterations; i++ ) {
+        for( const std::pair<tripoint, tripoint> &r : test_routes() ) {
+            here.route( r.first, r.second, test_settings() );
+            routes++;
+        }
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    const long long diff = std::chrono::duration_cast<std::chrono::microseconds>
+                           ( end - start ).count();
+    cata_printf( "map::route() executed %d times in %lld microseconds, %.1f routes/sec.\n",
+                 routes, diff, diff > 0 ? routes * 1000000.0 / diff : 0.0 );
+}
+
+TEST_CASE( "route_shared_performance", "[.]" )
+{
+    clear_all_state();
+    build_cluttered_map();
+    map &here = get_map();
+    here.reset_flow_field_stats();
+
+    // A horde spread around a single target
+    const tripoint target( 66, 66, 0 );
+    std::vector<tripoint> horde;
+    for( int x = 40; x <= 92; x += 4 ) {
+        for( int y = 40; y <= 92; y += 13 ) {
+            if( here.passable( tripoint( x, y, 0 ) ) ) {
+                horde.emplace_back( x, y, 0 );
+            }
+        }
+    }
+
+    const auto start1 = std::chrono::high_resolution_clock::now();
+    for( const tripoint &p : horde ) {
+        here.route( p, target, test_settings() );
+    }
+    const auto end1 = std::chrono::high_resolution_clock::now();
+
+    const auto start2 = std::chrono::high_resolution_clock::now();
+    for( const tripoint &p : horde ) {
+        here.route_shared( p, target, test_settings() );
+    }
+    const auto end2 = std::chrono::high_resolution_clock::now();
+
+    const long long diff1 = std::chrono::duration_cast<std::chrono::microseconds>
+                            ( end1 - start1 ).count();
+    const long long diff2 = std::chrono::duration_cast<std::chrono::microseconds>
+                            ( end2 - start2 ).count();
+    const pathfinding_flow_field_stats &stats = here.get_flow_field_stats();
+    cata_printf( "map::route() for %d monsters took %lld microseconds.\n",
+                 static_cast<int>( horde.size() ), diff1 );
+    cata_printf( "map::route_shared() for %d monsters took %lld microseconds: "
+                 "%d field hits, %d fields built, %d separate routes.\n",
+                 static_cast<int>( horde.size() ), diff2, stats.field_hits, stats.fields_built,
+                 stats.route_calls );
+}
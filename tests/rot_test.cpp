@@ -1,15 +1,20 @@
 #include "catch/catch.hpp"
 
+#include <chrono>
 #include <memory>
 
 #include "calendar.h"
+#include "coordinates.h"
 #include "enums.h"
 #include "item.h"
 #include "map.h"
 #include "map_helpers.h"
 #include "game.h" // Just for get_convection_temperature(), TODO: Remove
 #include "point.h"
+#include "string_formatter.h"
+#include "units_temperature.h"
 #include "weather.h"
+#include "weather_gen.h"
 
 static const furn_str_id f_atomic_freezer( "f_atomic_freezer" );
 
@@ -194,3 +199,47 @@ TEST_CASE( "Items don't rot away on map load if in a freezer" )
     auto normal_stack_after = m.i_at( normal_pnt );
     REQUIRE( normal_stack_after.empty() );
 }
+
+TEST_CASE( "Hourly weather temperatures follow the weather generator" )
+{
+    weather_manager weather;
+    const weather_generator &wgen = weather.get_cur_weather_gen();
+    const tripoint_abs_omt omt( 50, 70, 0 );
+    const tripoint_abs_ms middle = project_to<coords::ms>( omt ) + point( SEEX, SEEY );
+    const time_point start = calendar::turn_zero + 100_days;
+
+    for( int hour = 0; hour < 48; hour++ ) {
+        const time_point t = start + time_duration::from_hours( hour );
+        CAPTURE( hour );
+        CHECK( weather.get_hourly_weather_temperature( middle, t ) ==
+               wgen.get_weather_temperature( middle, t, calendar::config, g->get_seed() ) );
+        // Between full hours and away from the middle the weather barely changes
+        const tripoint_abs_ms corner = project_to<coords::ms>( omt );
+        const units::temperature exact = wgen.get_weather_temperature( corner, t + 30_minutes,
+                                         calendar::config, g->get_seed() );
+        CHECK( units::to_celsius<double>( weather.get_hourly_weather_temperature( corner,
+                                          t + 30_minutes ) ) == Approx( units::to_celsius<double>( exact ) ).margin( 1.0 ) );
+    }
+}
+
+TEST_CASE( "Rot of a stocked pantry catching up", "[.]" )
+{
+    tinymap m;
+    constexpr tripoint_abs_sm pantry_location = tripoint_abs_sm( 100, 100, 0 );
+    m.load( pantry_location, false );
+    const tripoint shelf( 13, 13, 0 );
+    m.furn_set( shelf, furn_str_id::NULL_ID() );
+    m.ter_set( shelf, t_floor );
+    m.i_clear( shelf );
+    for( int i = 0; i < 1000; i++ ) {
+        m.add_item( shelf, item( "meat_cooked" ) );
+    }
+
+    m.load( tripoint_abs_sm( 0, 0, 0 ), false );
+    calendar::turn += 21_days;
+    const auto start = std::chrono::high_resolution_clock::now();
+    m.load( pantry_location, false );
+    const auto end = std::chrono::high_resolution_clock::now();
+    const long long ms = std::chrono::duration_cast<std::chrono::milliseconds>( end - start ).count();
+    cata_printf( "Loading 1000 items after 21 days away: %lld ms\n", ms );
+}
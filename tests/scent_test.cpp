@@ -1,10 +1,19 @@
 
 #include "scent_map.h"
 #include "catch/catch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
 #include "map.h"
 #include "map_helpers.h"
 #include "game.h"
+#include "mapdata.h"
 #include "state_helpers.h"
+#include "string_formatter.h"
+#include "type_id.h"
+#include "units.h"
 
 void old_scent_map_update( const tripoint &center, map &m,
                            std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X> &grscent );
@@ -123,6 +132,95 @@ void old_scent_map_update( const tripoint &center, map &m,
     }
 }
 
+// scent_map::update before the diffusion was split into vectorizable passes
+static void scalar_scent_map_update( const tripoint &center, map &m,
+                                     std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X> &grscent )
+{
+    //the block and reduce scent properties are folded into a single scent_transfer value here
+    //block=0 reduce=1 normal=5
+    std::array<std::array<char, MAPSIZE_Y>, MAPSIZE_X> scent_transfer;
+
+    std::array < std::array < int, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > new_scent;
+    std::array < std::array < int, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > sum_3_scent_y;
+    std::array < std::array < char, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > squares_used_y;
+
+    diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = m.access_cache(
+                center.z ).vehicle_obstructed_cache;
+
+    // for loop constants
+    const int scentmap_minx = center.x - SCENT_RADIUS;
+    const int scentmap_maxx = center.x + SCENT_RADIUS;
+    const int scentmap_miny = center.y - SCENT_RADIUS;
+    const int scentmap_maxy = center.y + SCENT_RADIUS;
+
+    // The new scent flag searching function. Should be wayyy faster than the old one.
+    m.scent_blockers( scent_transfer, point( scentmap_minx - 1, scentmap_miny - 1 ),
+                      point( scentmap_maxx + 1, scentmap_maxy + 1 ) );
+
+    for( int x = 0; x < SCENT_RADIUS * 2 + 3; ++x ) {
+        sum_3_scent_y[0][x] = 0;
+        squares_used_y[0][x] = 0;
+        sum_3_scent_y[SCENT_RADIUS * 2][x] = 0;
+        squares_used_y[SCENT_RADIUS * 2][x] = 0;
+    }
+
+    for( int x = 0; x < SCENT_RADIUS * 2 + 3; ++x ) {
+        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
+
+            point abs( x + scentmap_minx - 1, y + scentmap_miny );
+
+            // remember the sum of the scent val for the 3 neighboring squares that can defuse into
+            sum_3_scent_y[y][x] = 0;
+            squares_used_y[y][x] = 0;
+            for( int i = abs.y - 1; i <= abs.y + 1; ++i ) {
+                sum_3_scent_y[y][x] += scent_transfer[abs.x][i] * grscent[abs.x][i];
+                squares_used_y[y][x] += scent_transfer[abs.x][i];
+            }
+        }
+    }
+
+    for( int x = 1; x < SCENT_RADIUS * 2 + 2; ++x ) {
+        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
+            const point abs( x + scentmap_minx - 1, y + scentmap_miny );
+
+            int squares_used = squares_used_y[y][x - 1] + squares_used_y[y][x] + squares_used_y[y][x + 1];
+            int total = sum_3_scent_y[y][x - 1] + sum_3_scent_y[y][x] + sum_3_scent_y[y][x + 1];
+
+            //handle vehicle holes
+            if( blocked_cache[abs.x][abs.y].nw && scent_transfer[abs.x + 1][abs.y + 1] == 5 ) {
+                squares_used -= 4;
+                total -= 4 * grscent[abs.x + 1][abs.y + 1];
+            }
+            if( blocked_cache[abs.x][abs.y].ne && scent_transfer[abs.x - 1][abs.y + 1] == 5 ) {
+                squares_used -= 4;
+                total -= 4 * grscent[abs.x - 1][abs.y + 1];
+            }
+            if( blocked_cache[abs.x - 1][abs.y - 1].nw && scent_transfer[abs.x - 1][abs.y - 1] == 5 ) {
+                squares_used -= 4;
+                total -= 4 * grscent[abs.x - 1][abs.y - 1];
+            }
+            if( blocked_cache[abs.x + 1][abs.y - 1].ne && scent_transfer[abs.x + 1][abs.y - 1] == 5 ) {
+                squares_used -= 4;
+                total -= 4 * grscent[abs.x + 1][abs.y - 1];
+            }
+
+            //Lingering scent
+            int temp_scent =  grscent[abs.x][abs.y] * ( 250 - squares_used  *
+                              scent_transfer[abs.x][abs.y] ) ;
+            temp_scent -=  grscent[abs.x][abs.y] * scent_transfer[abs.x][abs.y] *
+                           ( 45 - squares_used ) / 5;
+
+            new_scent[y][x] = ( temp_scent + total * scent_transfer[abs.x][abs.y] ) / 250;
+
+        }
+    }
+    for( int x = 1; x < SCENT_RADIUS * 2 + 2; ++x ) {
+        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
+            grscent[x + scentmap_minx - 1 ][y + scentmap_miny] = new_scent[y][x];
+        }
+    }
+}
+
 TEST_CASE( "scent_matches_old", "[.]" )
 {
     clear_all_state();
@@ -170,3 +268,83 @@ TEST_CASE( "scent_matches_old", "[.]" )
     }
 }
 
+
+static void setup_scent_diffusion_map( const tripoint &origin )
+{
+    clear_all_state();
+    g->place_player( origin );
+    map &here = get_map();
+    here.ter_set( origin + tripoint_south_west, t_brick_wall );
+    here.ter_set( origin + tripoint_west, t_brick_wall );
+    here.ter_set( origin + tripoint_north, t_rock_wall_half );
+    here.ter_set( origin + tripoint( 3, -2, 0 ), t_rock_wall_half );
+    // A diagonal vehicle, its walls block scent between diagonal neighbors
+    here.add_vehicle( vproto_id( "apc" ), origin + tripoint( 12, 4, 0 ), -45_degrees, 0, 0 );
+    here.build_map_cache( 0 );
+}
+
+static void fill_scent_diffusion_map( std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X> &expected )
+{
+    g->scent.reset();
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            expected[x][y] = ( x * 37 + y * 101 ) % 1000;
+            g->scent.set( tripoint( x, y, 0 ), expected[x][y], scenttype_id( "sc_human" ) );
+        }
+    }
+}
+
+TEST_CASE( "scent_diffusion_matches_scalar_version", "[scent]" )
+{
+    const tripoint origin( 60, 60, 0 );
+    setup_scent_diffusion_map( origin );
+    map &here = get_map();
+
+    std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X> expected;
+    fill_scent_diffusion_map( expected );
+    for( int i = 0; i < 3; i++ ) {
+        g->scent.update( origin, here );
+        scalar_scent_map_update( origin, here, expected );
+    }
+
+    int mismatches = 0;
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            if( std::max( expected[x][y], 0 ) != g->scent.get( tripoint( x, y, 0 ) ) ) {
+                INFO( x );
+                INFO( y );
+                CHECK( expected[x][y] == g->scent.get( tripoint( x, y, 0 ) ) );
+                mismatches++;
+            }
+        }
+    }
+    CHECK( mismatches == 0 );
+}
+
+TEST_CASE( "scent_diffusion_benchmark", "[.]" )
+{
+    const tripoint origin( 60, 60, 0 );
+    setup_scent_diffusion_map( origin );
+    map &here = get_map();
+    const int iterations = 2000;
+
+    std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X> scalar_scent;
+    fill_scent_diffusion_map( scalar_scent );
+    const auto scalar_start = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < iterations; i++ ) {
+        scalar_scent_map_update( origin, here, scalar_scent );
+    }
+    const auto scalar_end = std::chrono::high_resolution_clock::now();
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < iterations; i++ ) {
+        g->scent.update( origin, here );
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    const long long scalar_us = std::chrono::duration_cast<std::chrono::microseconds>
+                                ( scalar_end - scalar_start ).count();
+    const long long us = std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count();
+    cata_printf( "Scalar scent update: %lld us per call\n", scalar_us / iterations );
+    cata_printf( "Scent update: %lld us per call\n", us / iterations );
+}
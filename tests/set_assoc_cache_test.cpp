@@ -0,0 +1,107 @@
+#include "catch/catch.hpp"
+
+#include <vector>
+
+#include "lru_cache.h"
+#include "point.h"
+#include "rng.h"
+#include "set_assoc_cache.h"
+
+TEST_CASE( "set_assoc_cache_stores_and_forgets", "[set_assoc_cache]" )
+{
+    set_assoc_cache<point, char> cache( 100 );
+    CHECK( cache.capacity() >= 100 );
+    CHECK( cache.get( point( 1, 2 ), -1 ) == -1 );
+
+    cache.insert( point( 1, 2 ), 1 );
+    cache.insert( point( 3, 4 ), 0 );
+    CHECK( cache.get( point( 1, 2 ), -1 ) == 1 );
+    CHECK( cache.get( point( 3, 4 ), -1 ) == 0 );
+
+    cache.insert( point( 1, 2 ), 0 );
+    CHECK( cache.get( point( 1, 2 ), -1 ) == 0 );
+
+    cache.remove( point( 1, 2 ) );
+    CHECK( cache.get( point( 1, 2 ), -1 ) == -1 );
+    CHECK( cache.get( point( 3, 4 ), -1 ) == 0 );
+
+    cache.clear();
+    CHECK( cache.get( point( 3, 4 ), -1 ) == -1 );
+
+    const set_assoc_cache<point, char>::statistics &stats = cache.get_statistics();
+    CHECK( stats.hits == 4 );
+    CHECK( stats.misses == 3 );
+    CHECK( stats.hit_rate() == Approx( 4.0 / 7.0 ) );
+}
+
+TEST_CASE( "set_assoc_cache_evicts_least_recently_used_of_a_set", "[set_assoc_cache]" )
+{
+    // A single set of two slots, so every key competes for it
+    set_assoc_cache<int, int> cache( 1 );
+    REQUIRE( cache.capacity() == 2 );
+    cache.insert( 1, 10 );
+    cache.insert( 2, 20 );
+    CHECK( cache.get( 1, 0 ) == 10 );
+    cache.insert( 3, 30 );
+    CHECK( cache.get_statistics().evictions == 1 );
+    CHECK( cache.get( 1, 0 ) == 10 );
+    CHECK( cache.get( 2, 0 ) == 0 );
+    CHECK( cache.get( 3, 0 ) == 30 );
+}
+
+TEST_CASE( "set_assoc_cache_never_returns_wrong_values", "[set_assoc_cache]" )
+{
+    set_assoc_cache<point, int> cache( 256 );
+    for( int i = 0; i < 20000; i++ ) {
+        const point p( rng( 0, 60 ), rng( 0, 60 ) );
+        const int expected = p.x * 1000 + p.y;
+        const int cached = cache.get( p, -1 );
+        if( cached != -1 ) {
+            CHECK( cached == expected );
+        } else {
+            cache.insert( p, expected );
+        }
+        if( i % 5000 == 0 ) {
+            cache.clear();
+        }
+    }
+    CHECK( cache.get_statistics().hits > 0 );
+}
+
+// Mimics map::sees, which looks up pairs of nearby points and inserts on a miss.
+template<typename Cache, typename Insert>
+static int lookup_pairs( Cache &cache, const std::vector<point> &keys, Insert insert )
+{
+    int found = 0;
+    for( const point &key : keys ) {
+        const char cached = cache.get( key, -1 );
+        if( cached >= 0 ) {
+            found += cached;
+        } else {
+            insert( key );
+        }
+    }
+    return found;
+}
+
+TEST_CASE( "set_assoc_cache_benchmark", "[.][set_assoc_cache][benchmark]" )
+{
+    std::vector<point> keys;
+    for( int i = 0; i < 10000; i++ ) {
+        keys.emplace_back( rng( 0, 400 ), rng( 0, 400 ) );
+    }
+    lru_cache<point, char> lru;
+    set_assoc_cache<point, char> assoc( 100000 );
+
+    BENCHMARK( "lru_cache" ) {
+        return lookup_pairs( lru, keys, [&lru]( const point & key ) {
+            lru.insert( 100000, key, 1 );
+        } );
+    };
+    BENCHMARK( "set_assoc_cache" ) {
+        return lookup_pairs( assoc, keys, [&assoc]( const point & key ) {
+            assoc.insert( key, 1 );
+        } );
+    };
+    WARN( "set_assoc_cache hit rate: " << assoc.get_statistics().hit_rate() );
+}
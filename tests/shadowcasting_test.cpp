@@ -6,8 +6,10 @@
 #include <functional>
 #include <memory>
 #include <random>
+#include <utility>
 #include <vector>
 
+#include "cached_options.h"
 #include "game_constants.h"
 #include "lightmap.h"
 #include "line.h" // For rl_dist.
@@ -417,6 +419,81 @@ static void shadowcasting_3d_2d( const int iterations )
     REQUIRE( passed );
 }
 
+// Outputs of one shadowcasting kernel, see shadowcasting_kernel
+struct kernel_outputs {
+    float seen[MAPSIZE_X][MAPSIZE_Y];
+    four_quadrants lit[MAPSIZE_X][MAPSIZE_Y];
+    float seen_3d[MAPSIZE_X][MAPSIZE_Y];
+};
+
+// Runs every kernel on the same cluttered map and returns the time taken by each
+static std::pair<long long, long long> shadowcasting_kernels( const int iterations,
+        const point &offset, const unsigned int denominator = DENOMINATOR )
+{
+    float transparency_cache[MAPSIZE_X][MAPSIZE_Y] = {{0}};
+    bool floor_cache[MAPSIZE_X][MAPSIZE_Y] = {{false}};
+    diagonal_blocks blocked_cache[MAPSIZE_X][MAPSIZE_Y] = {{{false, false}}};
+    randomly_fill_transparency( transparency_cache, NUMERATOR, denominator );
+    // Some smoke and a few vehicle corners, to take the slow paths as well
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            if( ( x * 7 + y * 3 ) % 23 == 0 && transparency_cache[x][y] != LIGHT_TRANSPARENCY_SOLID ) {
+                transparency_cache[x][y] = LIGHT_TRANSPARENCY_OPEN_AIR * 3;
+            }
+            blocked_cache[x][y] = { ( x * 5 + y ) % 97 == 0, ( x + y * 11 ) % 89 == 0 };
+        }
+    }
+
+    std::array<const float ( * )[MAPSIZE_X][MAPSIZE_Y], OVERMAP_LAYERS> transparency_caches;
+    std::array<const bool ( * )[MAPSIZE_X][MAPSIZE_Y], OVERMAP_LAYERS> floor_caches;
+    std::array<const diagonal_blocks( * )[MAPSIZE_X][MAPSIZE_Y], OVERMAP_LAYERS> blocked_caches;
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z++ ) {
+        transparency_caches[z + OVERMAP_DEPTH] = &transparency_cache;
+        floor_caches[z + OVERMAP_DEPTH] = &floor_cache;
+        blocked_caches[z + OVERMAP_DEPTH] = &blocked_cache;
+    }
+
+    const auto run = [&]( kernel_outputs & out ) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        std::array<float ( * )[MAPSIZE_X][MAPSIZE_Y], OVERMAP_LAYERS> seen_caches;
+        seen_caches.fill( &out.seen_3d );
+        for( int i = 0; i < iterations; i++ ) {
+            castLightAllWithLookup<float, float, sight_calc, sight_check, update_light,
+                                   accumulate_transparency, sight_from_lookup>(
+                                       out.seen, transparency_cache, blocked_cache, offset );
+            castLightAll<float, four_quadrants, sight_calc, sight_check, update_light_quadrants,
+                         accumulate_transparency>( out.lit, transparency_cache, blocked_cache, offset, 3, 20.0f );
+            cast_zlight<float, sight_calc, sight_check, accumulate_transparency>(
+                seen_caches, transparency_caches, floor_caches, blocked_caches, tripoint( offset, 0 ), 0,
+                1.0f );
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count();
+    };
+
+    std::unique_ptr<kernel_outputs> per_tile = std::make_unique<kernel_outputs>();
+    std::unique_ptr<kernel_outputs> row_span = std::make_unique<kernel_outputs>();
+    *per_tile = {};
+    *row_span = {};
+    shadowcasting_kernel_in_use = shadowcasting_kernel::per_tile;
+    const long long per_tile_time = run( *per_tile );
+    shadowcasting_kernel_in_use = shadowcasting_kernel::row_span;
+    const long long row_span_time = run( *row_span );
+
+    int mismatches = 0;
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            if( per_tile->seen[x][y] != row_span->seen[x][y] ||
+                per_tile->lit[x][y].values != row_span->lit[x][y].values ||
+                per_tile->seen_3d[x][y] != row_span->seen_3d[x][y] ) {
+                mismatches++;
+            }
+        }
+    }
+    CHECK( mismatches == 0 );
+    return { per_tile_time, row_span_time };
+}
+
 // T, O and V are 'T'ransparent, 'O'paque and 'V'isible.
 // X marks the player location, which is not set to visible by this algorithm.
 static constexpr float T = LIGHT_TRANSPARENCY_OPEN_AIR;
@@ -664,6 +741,39 @@ TEST_CASE( "shadowcasting_float_quad_performance", "[.]" )
     shadowcasting_float_quad( 1000000, 100 );
 }
 
+TEST_CASE( "shadowcasting_kernels_match", "[shadowcasting]" )
+{
+    clear_all_state();
+    const bool old_trigdist = trigdist;
+    const bool use_trigdist = GENERATE( false, true );
+    const point offset = GENERATE( point( 65, 65 ), point( 3, 120 ), point( 131, 0 ) );
+    CAPTURE( use_trigdist, offset );
+    trigdist = use_trigdist;
+    shadowcasting_kernels( 1, offset );
+    trigdist = old_trigdist;
+}
+
+TEST_CASE( "shadowcasting_kernels_performance", "[.]" )
+{
+    clear_all_state();
+    const bool old_trigdist = trigdist;
+    for( const bool use_trigdist : {
+             false, true
+         } ) {
+        trigdist = use_trigdist;
+        for( const unsigned int denominator : {
+                 DENOMINATOR, 100U
+             } ) {
+            const std::pair<long long, long long> times = shadowcasting_kernels( 2000,
+                    point( 65, 65 ), denominator );
+            cata_printf( "trigdist %d, denominator %u: per_tile kernel took %lld microseconds, "
+                         "row_span kernel took %lld microseconds.\n", use_trigdist ? 1 : 0, denominator,
+                         times.first, times.second );
+        }
+    }
+    trigdist = old_trigdist;
+}
+
 // I'm not sure this will ever work.
 TEST_CASE( "bresenham_vs_shadowcasting", "[.]" )
 {
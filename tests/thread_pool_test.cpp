@@ -0,0 +1,34 @@
+#include "catch/catch.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "thread_pool.h"
+
+TEST_CASE( "parallel_for_visits_every_index_once", "[thread_pool]" )
+{
+    const int count = GENERATE( 0, 1, 7, 1000 );
+    CAPTURE( count );
+    std::vector<int> visits( count, 0 );
+    cata::parallel_for( count, [&visits]( int i ) {
+        visits[i]++;
+    } );
+    CHECK( std::count( visits.begin(), visits.end(), 1 ) == count );
+}
+
+TEST_CASE( "nested_parallel_for_runs_serially", "[thread_pool]" )
+{
+    const int outer = 16;
+    const int inner = 50;
+    std::vector<int> sums( outer, 0 );
+    cata::parallel_for( outer, [&sums]( int i ) {
+        int &sum = sums[i];
+        cata::parallel_for( inner, [&sum]( int j ) {
+            sum += j;
+        } );
+    } );
+    for( int sum : sums ) {
+        CHECK( sum == inner * ( inner - 1 ) / 2 );
+    }
+    CHECK( cata::parallel_for_threads() >= 1 );
+}